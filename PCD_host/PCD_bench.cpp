@@ -0,0 +1,136 @@
+/*
+ * PCD_bench.cpp
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Drives loop() and Human_Machine_Interface::UIupdate() of the host build
+ *	millions of times and reports the cost of one iteration: host time,
+ *	and the hardware activity the mock counted (ISRs, ADC conversions, LCD,
+ *	I2C, serial and EEPROM traffic).
+ *
+ *	loop() is measured twice: attended, where a key press every pass keeps
+ *	the MCU awake, and unattended, where it powers down between the door
+ *	alarms, with the lift stopping at its end switches. The unattended run
+ *	also reports where the simulated time went.
+ *
+ *	The two sunrise and sunset backends of Solar_Schedule are timed over
+ *	every day of the year, with the flash they take and how far apart their
+ *	times are.
+ *
+ *	Usage: pcd_bench [loop iterations] [UIupdate iterations per state]
+ */
+
+#include <Arduino.h>
+#include <TimeLib.h>
+#include <LiquidCrystal.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+
+#include "Mock_HW.h"
+#include "PCD_firmware.h"
+
+static void header(void)
+{
+	printf("%-22s %10s %8s %8s %8s %9s %8s %8s %8s %8s\n", "benchmark", "ns/iter", "isr", "adc",
+		"lcd B", "lcd us", "i2c tx", "i2c B", "ser B", "eep W");
+}
+
+template <typename F>
+static void run(const char *name, unsigned long n, F body)
+{
+	mock_reset_counters();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long i = 0; i < n; i++)
+	{
+		body();
+	}
+	double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+	double d = (double)n;
+	printf("%-22s %10.1f %8.2f %8.2f %8.2f %9.1f %8.3f %8.3f %8.3f %8.4f\n", name, ns / d,
+		(mock_count.isr_timer1 + mock_count.isr_int0 + mock_count.isr_adc + mock_count.isr_twi) / d, mock_count.adc_conversions / d,
+		(mock_count.lcd_commands + mock_count.lcd_data) / d, mock_count.lcd_busy_us / d,
+		mock_count.i2c_transactions / d, mock_count.i2c_bytes / d, mock_count.serial_tx / d,
+		mock_count.eeprom_writes / d);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long loops = (argc > 1) ? strtoul(argv[1], 0, 0) : 1000000UL;
+	unsigned long updates = (argc > 2) ? strtoul(argv[2], 0, 0) : 1000000UL;
+
+	tmElements_t tm = { 0, 55, 5, 0, 5, 7, CalendarYrToTm(2019) };
+	mock_rtc_set(makeTime(tm));
+	mock_lift(3000, 0);		// Closed, 3 s from end to end.
+	setup();
+	pcd_set_alarms(6, 0, 21, 30);
+
+	header();
+	run("loop() attended", loops, []() { pcd_ui_touch(); loop(); });
+
+	// Mostly power-down from one alarm to the next, so fewer passes cover many days.
+	unsigned long unattended = (loops / 100) ? loops / 100 : 1;
+	uint64_t start = mock_cycles();
+	run("loop() unattended", unattended, loop);
+	double us = (mock_cycles() - start) / (MOCK_F_CPU / 1000000.0);
+	printf("  %.1f simulated days, %.2f%% power-down, %.3f%% idle, %.3f%% running, %llu INT0, %llu PCINT\n",
+		us / 86400e6, 100.0 * mock_count.sleep_deep_us / us, 100.0 * mock_count.sleep_idle_us / us,
+		100.0 * (us - mock_count.sleep_deep_us - mock_count.sleep_idle_us) / us,
+		(unsigned long long)mock_count.isr_int0, (unsigned long long)mock_count.isr_pcint);
+	pcd_ui_touch();
+
+	// Walk the UI through all states and time UIupdate() in each one.
+	static const struct { uint8_t btn; uint8_t state; } path[] = {
+		{ 0, 0 }, { PCD_btnSELECT, 1 }, { PCD_btnRIGHT, 2 }, { PCD_btnRIGHT, 3 }, { PCD_btnRIGHT, 4 },
+		{ PCD_btnLEFT, 3 }, { PCD_btnLEFT, 2 }, { PCD_btnLEFT, 1 }, { PCD_btnLEFT, 0 },
+		{ PCD_btnRIGHT, 10 }, { PCD_btnSELECT, 11 }, { PCD_btnRIGHT, 12 }, { PCD_btnRIGHT, 13 }, { PCD_btnRIGHT, 14 },
+		{ PCD_btnLEFT, 13 }, { PCD_btnLEFT, 12 }, { PCD_btnLEFT, 11 }, { PCD_btnLEFT, 10 },
+		{ PCD_btnRIGHT, 20 }, { PCD_btnSELECT, 21 }, { PCD_btnRIGHT, 22 }, { PCD_btnRIGHT, 23 }, { PCD_btnRIGHT, 24 },
+	};
+	bool seen[32] = { false };
+
+	for (unsigned i = 0; i < sizeof(path) / sizeof(path[0]); i++)
+	{
+		if (path[i].btn)
+		{
+			pcd_ui_press(path[i].btn);
+		}
+		if (pcd_ui_state() != path[i].state)
+		{
+			fprintf(stderr, "UI is in state %u, expected %u\n", pcd_ui_state(), path[i].state);
+			return 1;
+		}
+		if (seen[path[i].state])
+		{
+			continue;
+		}
+		seen[path[i].state] = true;
+
+		char name[32];
+		snprintf(name, sizeof(name), "UIupdate() state %u", path[i].state);
+		run(name, updates, pcd_ui_update);
+	}
+
+	// Sunrise and sunset: fixed point calculation against the generated table.
+	volatile uint16_t sink = 0;
+	uint16_t rise, set, tableRise, tableSet;
+	int deviation = 0;
+
+	for (uint16_t day = 1; day <= 366; day++)
+	{
+		pcd_sun_compute(day, &rise, &set);
+		pcd_sun_lookup(day, &tableRise, &tableSet);
+		int d1 = abs((int)rise - (int)tableRise), d2 = abs((int)set - (int)tableSet);
+		deviation = std::max(deviation, std::max(std::min(d1, 1440 - d1), std::min(d2, 1440 - d2)));
+	}
+	unsigned long days = (updates / 10) ? updates / 10 : 1;
+	uint16_t day = 0;
+	run("sunCompute()", days, [&]() { pcd_sun_compute(day++ % 366 + 1, &rise, &set); sink += rise; });
+	run("sunLookup()", days, [&]() { pcd_sun_lookup(day++ % 366 + 1, &rise, &set); sink += rise; });
+	printf("  flash: sunCompute %u B of tables, sunLookup %u B of tables; at most %d min apart over the year\n",
+		pcd_sun_sin_bytes(), pcd_sun_table_bytes(), deviation);
+
+	return 0;
+}
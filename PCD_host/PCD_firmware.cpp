@@ -0,0 +1,71 @@
+/*
+ * PCD_firmware.cpp
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Builds the unmodified PCD_main sketch for the host. Does what the
+ *	Arduino builder does to an .ino: include the core, declare the
+ *	prototypes of the sketch functions, and compile the sketch as C++.
+ */
+
+#include <Arduino.h>
+#include <TimeLib.h>
+
+void printDateTime(time_t t);
+void printTime(time_t t);
+void printDate(time_t t);
+void printI00(int val, char delim);
+
+#include "../PCD_main/PCD_main.ino"
+
+#include "PCD_firmware.h"
+
+void pcd_ui_update(void)
+{
+	HMI.UIupdate();
+}
+
+void pcd_ui_press(uint8_t btn)
+{
+	HMI.UIupdate(BTNpress | btn);
+}
+
+uint8_t pcd_ui_state(void)
+{
+	return HMI.UIgetState();
+}
+
+void pcd_ui_touch(void)
+{
+	Power.powerActivity();
+}
+
+void pcd_set_alarms(uint8_t openHour, uint8_t openMinute, uint8_t closeHour, uint8_t closeMinute)
+{
+	tmElements_t tm = { 0, openMinute, openHour, 0, 1, 1, 0 };
+	RTC_alarm.alarm1_set(tm);
+	tm.Minute = closeMinute;
+	tm.Hour = closeHour;
+	RTC_alarm.alarm2_set(tm);
+}
+
+void pcd_sun_compute(uint16_t day, uint16_t *rise, uint16_t *set)
+{
+	Sun.sunCompute(day, rise, set);
+}
+
+void pcd_sun_lookup(uint16_t day, uint16_t *rise, uint16_t *set)
+{
+	Sun.sunLookup(day, rise, set);
+}
+
+unsigned pcd_sun_table_bytes(void)
+{
+	return sizeof(SUNdays);
+}
+
+unsigned pcd_sun_sin_bytes(void)
+{
+	return sizeof(SUNsin);
+}
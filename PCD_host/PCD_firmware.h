@@ -0,0 +1,48 @@
+#ifndef PCD_firmware
+#define PCD_firmware
+/*
+ * PCD_firmware.h
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	What the host tools may call in the firmware library. Supp_Func.h
+ *	defines its globals, so it can only be included by PCD_firmware.cpp.
+ */
+
+#include <stdint.h>
+
+// Button codes of Keypad_ADC and Human_Machine_Interface::read_LCD_buttons()
+#define PCD_btnSELECT	1
+#define PCD_btnRIGHT	2
+#define PCD_btnUP		3
+#define PCD_btnDOWN		4
+#define PCD_btnLEFT		5
+
+void setup(void);
+void loop(void);
+
+// Runs one UIupdate() with no key event queued.
+void pcd_ui_update(void);
+
+// Runs one UIupdate() with a press of the given key queued.
+void pcd_ui_press(uint8_t btn);
+
+uint8_t pcd_ui_state(void);
+
+// Counts as a key press for the power manager, keeps the MCU out of power-down.
+void pcd_ui_touch(void);
+
+// Sets alarm 1 (open) and alarm 2 (close) like the UI does.
+void pcd_set_alarms(uint8_t openHour, uint8_t openMinute, uint8_t closeHour, uint8_t closeMinute);
+
+// Sunrise and sunset of a day of the year in minutes UTC, from Solar_Schedule::sunCompute
+// at the place in the configuration, or from the generated table.
+void pcd_sun_compute(uint16_t day, uint16_t *rise, uint16_t *set);
+void pcd_sun_lookup(uint16_t day, uint16_t *rise, uint16_t *set);
+
+// Flash taken by the generated table and by the sine table of the fixed point backend.
+unsigned pcd_sun_table_bytes(void);
+unsigned pcd_sun_sin_bytes(void);
+
+#endif
@@ -0,0 +1,715 @@
+/*
+ * PCD_yearsim.cpp
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Runs the firmware through whole years of door schedules in accelerated
+ *	virtual time, and checks that every scheduled open and close happened
+ *	exactly once. setup(), loop() and the ISRs run unmodified on the mocked
+ *	hardware, which skips from one alarm to the next while the MCU sleeps.
+ *
+ *	Each scenario is drawn from its seed: daily alarms set by hand, the sun
+ *	at a random place, or a weekly schedule, all set over the serial
+ *	console. Into it are injected spurious INT0 edges, RIGHT key presses
+ *	(half of them just before an event, which keep the MCU awake through
+ *	its alarm), small clock adjustments with the time command, an I2C
+ *	slave holding SDA low until the bus is clocked free, and power
+ *	losses. Power
+ *	can be lost at any instruction. The scenario then goes on in a fresh
+ *	process with only what survives that: the EEPROM, the AT24C32, the
+ *	DS3231, which keeps time and its alarm flags on its battery, and the
+ *	door where it stopped.
+ *
+ *	An event is done when the door reaches its end within a minute of its
+ *	time (five around the sun, which the firmware computes in fixed point),
+ *	and a no-op when the door already was there. Events that fell while the
+ *	power was off are lost, the firmware does not catch up on them. All
+ *	other events are missed, and an arrival no event explains is extra.
+ *	Missed and extra runs are printed with their seed and fail the run.
+ *
+ *	The scenarios run in parallel, one process each, on all cores.
+ *
+ *	Usage: pcd_yearsim [scenarios] [days] [first seed]
+ */
+
+#include <Arduino.h>
+#include <TimeLib.h>
+#include <avr/eeprom.h>
+#include <math.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+
+#include "Mock_HW.h"
+#include "PCD_firmware.h"
+
+#define SIMmanual		0		// Kinds of schedule
+#define SIMsun			1
+#define SIMweek			2
+#define SIMkinds		3
+
+#define SIMtravel		3000	// Lift travel from end to end (ms)
+#define SIMwindow		60		// Seconds after its time an event may take
+#define SIMsunWindow	300		// Seconds either side of a sun event
+#define SIMmargin		900		// Seconds a clock adjustment keeps away from events
+#define SIMpending		32		// Events checked at once, two days ahead
+#define SIMoutages		4		// Outages remembered for the lost events
+#define SIMweekMax		24		// Entries of a weekly schedule
+
+#define DOORunknown		0
+#define DOORopen		1
+#define DOORclosed		2
+
+struct Sim_Event
+{
+	time_t t;
+	uint8_t door;			// DOORopen or DOORclosed
+	bool done;
+};
+
+struct Sim_Result
+{
+	uint32_t seed;
+	uint8_t kind;
+	bool crashed;			// A life ended without reporting back.
+	uint32_t days;
+	uint32_t events, done, noop, lost, missed, extra;
+	uint32_t outages, glitches, keys, adjusts, stucks;
+};
+
+// All a scenario carries from one life to the next.
+struct Sim_State
+{
+	Sim_Result res;
+	uint32_t rng;
+	time_t start, end, now;				// now: when the last life ended
+	bool configured;
+
+	// Schedule
+	uint16_t openMinute, closeMinute;		// SIMmanual
+	int16_t latitude, longitude;			// SIMsun, hundredths of a degree
+	int16_t openOffset, closeOffset, utcOffset;
+	uint8_t weekCount;						// SIMweek, minutes from Sunday 00:00
+	uint16_t weekMinute[SIMweekMax];
+	uint8_t weekDoor[SIMweekMax];
+
+	// Checker
+	Sim_Event pending[SIMpending];
+	uint8_t pendingCount;
+	time_t generated;						// Midnight of the first day not yet in pending
+	uint8_t door;
+	time_t off[SIMoutages], on[SIMoutages];
+
+	// Faults, as DS3231 times
+	time_t nextOff, offLength, nextGlitch, nextKey, nextAdjust, nextStuck;
+
+	// What survives a power loss
+	uint8_t rtc[0x13];
+	uint8_t eeprom[E2END + 1];
+	uint8_t at24[4096];
+	uint8_t lift;
+};
+
+static Sim_State sim;
+static jmp_buf lifeEnd;
+
+
+/*** Scenario ***/
+
+static uint32_t rnd(void)
+{
+	// xorshift32
+	sim.rng ^= sim.rng << 13;
+	sim.rng ^= sim.rng >> 17;
+	sim.rng ^= sim.rng << 5;
+	return sim.rng;
+}
+
+static uint32_t rnd(uint32_t n)
+{
+	return rnd() % n;
+}
+
+// Exponentially distributed, for faults that come at a mean rate.
+static time_t rnd_after(time_t mean)
+{
+	return (time_t)(-log((rnd() + 1.0) / 4294967297.0) * mean) + 1;
+}
+
+// Double precision NOAA sunrise and sunset, as in pcd_suntable.c, minutes after midnight UTC.
+static void sun(int day, double latitude, double longitude, int *rise, int *set)
+{
+	double g = 2 * M_PI / 365 * (day - 1);
+	double eqtime = 229.18 * (0.000075 + 0.001868 * cos(g) - 0.032077 * sin(g)
+		- 0.014615 * cos(2 * g) - 0.040849 * sin(2 * g));
+	double decl = 0.006918 - 0.399912 * cos(g) + 0.070257 * sin(g) - 0.006758 * cos(2 * g)
+		+ 0.000907 * sin(2 * g) - 0.002697 * cos(3 * g) + 0.00148 * sin(3 * g);
+	double lat = latitude * M_PI / 180;
+	double c = (cos(90.833 * M_PI / 180) - sin(lat) * sin(decl)) / (cos(lat) * cos(decl));
+	double ha = acos(c < -1 ? -1 : (c > 1 ? 1 : c)) * 180 / M_PI;
+
+	*rise = (int)lround(720 - 4 * (longitude + ha) - eqtime);
+	*set = (int)lround(720 - 4 * (longitude - ha) - eqtime);
+}
+
+static void scenario_init(uint32_t seed, uint32_t days)
+{
+	tmElements_t tm = { 0, 0, 12, 0, 1, 1, CalendarYrToTm(2021) };
+
+	memset(&sim, 0, sizeof(sim));
+	sim.res.seed = seed;
+	sim.res.kind = seed % SIMkinds;
+	sim.res.days = days;
+	sim.rng = seed * 2654435761UL + 1;
+	sim.start = makeTime(tm) + rnd(365) * SECS_PER_DAY;
+	sim.end = sim.start + days * SECS_PER_DAY;
+	sim.generated = previousMidnight(sim.start) + SECS_PER_DAY;
+
+	switch (sim.res.kind)
+	{
+		case SIMmanual:
+			sim.openMinute = 300 + rnd(240);		// 05:00 to 09:00
+			sim.closeMinute = 1020 + rnd(300);		// 17:00 to 22:00
+		break;
+
+		case SIMsun:
+			// Away from the polar days, the clock on the zone time of the place.
+			sim.latitude = (int16_t)rnd(11001) - 5500;
+			sim.longitude = (int16_t)rnd(36001) - 18000;
+			sim.utcOffset = (int16_t)(lround(sim.longitude / 1500.0) * 60);
+			sim.openOffset = (int16_t)rnd(61) - 30;
+			sim.closeOffset = (int16_t)rnd(61) - 30;
+		break;
+
+		default:
+		{
+			// Pairs of an open and a later close, on a few sets of weekdays.
+			uint8_t sets = 1 + rnd(3);
+			for (uint8_t i = 0; i < sets; i++)
+			{
+				uint8_t days = 1 + rnd(127);
+				uint16_t open = 300 + rnd(300), close = 960 + rnd(360);
+				for (uint8_t d = 0; d < 7 && sim.weekCount + 2 <= SIMweekMax; d++)
+				{
+					if (days & (1 << d))
+					{
+						sim.weekMinute[sim.weekCount] = d * 1440 + open;
+						sim.weekDoor[sim.weekCount++] = DOORopen;
+						sim.weekMinute[sim.weekCount] = d * 1440 + close;
+						sim.weekDoor[sim.weekCount++] = DOORclosed;
+					}
+				}
+			}
+		}
+		break;
+	}
+
+	sim.door = DOORclosed;
+	sim.lift = 0;
+	sim.nextOff = sim.start + rnd_after(20 * SECS_PER_DAY);
+	sim.offLength = 60 + rnd(8 * SECS_PER_HOUR);
+	sim.nextGlitch = sim.start + rnd_after(2 * SECS_PER_DAY);
+	sim.nextKey = sim.start + rnd_after(7 * SECS_PER_DAY);
+	sim.nextAdjust = sim.start + rnd_after(10 * SECS_PER_DAY);
+	sim.nextStuck = sim.start + rnd_after(3 * SECS_PER_DAY);
+}
+
+// The console commands a user would type for the schedule.
+static void scenario_configure(void)
+{
+	char line[64];
+
+	switch (sim.res.kind)
+	{
+		case SIMmanual:
+			snprintf(line, sizeof(line), "alarm1 %02u:%02u\n", sim.openMinute / 60, sim.openMinute % 60);
+			mock_serial_input(line);
+			snprintf(line, sizeof(line), "alarm2 %02u:%02u\n", sim.closeMinute / 60, sim.closeMinute % 60);
+			mock_serial_input(line);
+		break;
+
+		case SIMsun:
+			snprintf(line, sizeof(line), "place %.2f %.2f\n", sim.latitude / 100.0, sim.longitude / 100.0);
+			mock_serial_input(line);
+			snprintf(line, sizeof(line), "offsets %d %d %d\n", sim.openOffset, sim.closeOffset, sim.utcOffset);
+			mock_serial_input(line);
+			mock_serial_input("sun 1\n");
+		break;
+
+		default:
+			for (uint8_t i = 0; i < sim.weekCount; i++)
+			{
+				// The console counts the days from Monday as 1, the schedule from Sunday as 0.
+				uint16_t m = sim.weekMinute[i];
+				snprintf(line, sizeof(line), "weekadd %u %02u:%02u %u\n", (m / 1440 + 6) % 7 + 1,
+					(m / 60) % 24, m % 60, (sim.weekDoor[i] == DOORopen) ? 1 : 2);
+				mock_serial_input(line);
+			}
+			mock_serial_input("week 1\n");
+		break;
+	}
+	for (uint8_t i = 0; i < 30; i++)
+	{
+		pcd_ui_touch();
+		loop();
+	}
+	sim.configured = true;
+}
+
+
+/*** Checker ***/
+
+static const char *door_name(uint8_t door)
+{
+	return (door == DOORopen) ? "open" : "close";
+}
+
+static void report(const char *what, uint8_t door, time_t t)
+{
+	fprintf(stderr, "seed %u: %s %s at %04d-%02d-%02d %02d:%02d:%02d\n", sim.res.seed, what, door_name(door),
+		year(t), month(t), day(t), hour(t), minute(t), second(t));
+}
+
+static void expect(time_t t, uint8_t door)
+{
+	if (t <= sim.start || t >= sim.end || sim.pendingCount == SIMpending)
+	{
+		return;
+	}
+	uint8_t i = sim.pendingCount++;
+	while (i && sim.pending[i - 1].t > t)
+	{
+		sim.pending[i] = sim.pending[i - 1];
+		i--;
+	}
+	sim.pending[i].t = t;
+	sim.pending[i].door = door;
+	sim.pending[i].done = false;
+	sim.res.events++;
+}
+
+// Adds the events of the day starting at midnight.
+static void generate(time_t midnight)
+{
+	switch (sim.res.kind)
+	{
+		case SIMmanual:
+			expect(midnight + sim.openMinute * 60L, DOORopen);
+			expect(midnight + sim.closeMinute * 60L, DOORclosed);
+		break;
+
+		case SIMsun:
+		{
+			tmElements_t tm;
+			int rise, set;
+
+			breakTime(midnight, tm);
+			tm.Month = 1;
+			tm.Day = 1;
+			sun(elapsedDays(midnight) - elapsedDays(makeTime(tm)) + 1, sim.latitude / 100.0, sim.longitude / 100.0,
+				&rise, &set);
+			expect(midnight + ((rise + sim.openOffset + sim.utcOffset + 2 * 1440) % 1440) * 60L, DOORopen);
+			expect(midnight + ((set + sim.closeOffset + sim.utcOffset + 2 * 1440) % 1440) * 60L, DOORclosed);
+		}
+		break;
+
+		default:
+		{
+			uint16_t first = (weekday(midnight) - 1) * 1440;
+			for (uint8_t i = 0; i < sim.weekCount; i++)
+			{
+				if (sim.weekMinute[i] >= first && sim.weekMinute[i] < first + 1440)
+				{
+					expect(midnight + (sim.weekMinute[i] - first) * 60L, sim.weekDoor[i]);
+				}
+			}
+		}
+		break;
+	}
+}
+
+static time_t window_before(void)
+{
+	return (sim.res.kind == SIMsun) ? SIMsunWindow : 0;
+}
+
+static time_t window_after(void)
+{
+	return (sim.res.kind == SIMsun) ? SIMsunWindow : SIMwindow;
+}
+
+static bool in_outage(time_t t)
+{
+	for (uint8_t i = 0; i < SIMoutages; i++)
+	{
+		if (sim.on[i] && t + window_after() >= sim.off[i] && t <= sim.on[i] + window_after())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Settles the events whose window has passed, and looks two days ahead.
+static void check(time_t now)
+{
+	while (sim.pendingCount && sim.pending[0].t + window_after() < now)
+	{
+		Sim_Event &e = sim.pending[0];
+		if (e.done)
+		{
+			sim.res.done++;
+		}
+		else if (in_outage(e.t))
+		{
+			sim.res.lost++;
+		}
+		else if (sim.door == e.door)
+		{
+			sim.res.noop++;
+		}
+		else
+		{
+			sim.res.missed++;
+			report("missed", e.door, e.t);
+		}
+		memmove(&sim.pending[0], &sim.pending[1], --sim.pendingCount * sizeof(Sim_Event));
+	}
+	while (sim.generated < now + 2 * SECS_PER_DAY)
+	{
+		generate(sim.generated);
+		sim.generated += SECS_PER_DAY;
+	}
+}
+
+static void arrived(bool open)
+{
+	time_t t = mock_rtc_time();
+	uint8_t door = open ? DOORopen : DOORclosed;
+
+	sim.door = door;
+	for (uint8_t i = 0; i < sim.pendingCount; i++)
+	{
+		Sim_Event &e = sim.pending[i];
+		if (!e.done && e.door == door && t + window_before() >= e.t && t <= e.t + window_after())
+		{
+			e.done = true;
+			return;
+		}
+	}
+	sim.res.extra++;
+	report("extra", door, t);
+}
+
+
+/*** Faults ***/
+
+// mock_cycles() at which the DS3231 shows t, as far as no one sets the clock before.
+static uint64_t cycles_at(time_t t)
+{
+	time_t now = mock_rtc_time();
+
+	return mock_cycles() + ((t > now) ? (uint64_t)(t - now) * MOCK_F_CPU : 0);
+}
+
+static void power_off(void *)
+{
+	longjmp(lifeEnd, 1);
+}
+
+static void glitch(void *)
+{
+	mock_int0_glitch();
+	sim.res.glitches++;
+	// Half of them right after an alarm, while the MCU is awake to see the edge.
+	if (rnd(2) && sim.pendingCount)
+	{
+		sim.nextGlitch = sim.pending[rnd(sim.pendingCount)].t + 1 + rnd(5);
+	}
+	else
+	{
+		sim.nextGlitch = mock_rtc_time() + rnd_after(2 * SECS_PER_DAY);
+	}
+	mock_at(cycles_at(sim.nextGlitch), glitch, 0);
+}
+
+static void stuck(void *)
+{
+	mock_i2c_stuck(1 + rnd(9));
+	sim.res.stucks++;
+	// Half of them at an alarm, the read of its flags finds the bus stuck.
+	if (rnd(2) && sim.pendingCount)
+	{
+		sim.nextStuck = sim.pending[rnd(sim.pendingCount)].t;
+	}
+	else
+	{
+		sim.nextStuck = mock_rtc_time() + rnd_after(3 * SECS_PER_DAY);
+	}
+	mock_at(cycles_at(sim.nextStuck), stuck, 0);
+}
+
+static void key_up(void *)
+{
+	mock_set_adc(A0, MOCK_ADC_NONE);
+}
+
+static void key_down(void *)
+{
+	mock_set_adc(A0, MOCK_ADC_RIGHT);
+	mock_at(mock_cycles() + MOCK_F_CPU / 5, key_up, 0);
+	sim.res.keys++;
+	// Half of them shortly before an event. The MCU is then awake when the alarm fires, with the
+	// software clock synced at the key press, at any phase of the DS3231 second.
+	if (rnd(2) && sim.pendingCount)
+	{
+		sim.nextKey = sim.pending[rnd(sim.pendingCount)].t - 2 - rnd(20);
+	}
+	else
+	{
+		sim.nextKey = mock_rtc_time() + rnd_after(7 * SECS_PER_DAY);
+	}
+	mock_at(cycles_at(sim.nextKey) + rnd(MOCK_F_CPU), key_down, 0);
+}
+
+static void adjust(void *)
+{
+	time_t now = mock_rtc_time();
+	char line[48];
+
+	// Only far from the events, which would otherwise be skipped or repeated by design.
+	for (uint8_t i = 0; i < sim.pendingCount; i++)
+	{
+		if (sim.pending[i].t + SIMmargin > now && sim.pending[i].t < now + SIMmargin)
+		{
+			sim.nextAdjust = now + 2 * SIMmargin;
+			mock_at(cycles_at(sim.nextAdjust), adjust, 0);
+			return;
+		}
+	}
+	now += (time_t)rnd(241) - 120;
+	// The first character wakes the UART from power-down and is lost.
+	snprintf(line, sizeof(line), "\ntime %04d-%02d-%02d %02d:%02d:%02d\n", year(now), month(now), day(now),
+		hour(now), minute(now), second(now));
+	mock_serial_input(line);
+	sim.res.adjusts++;
+	sim.nextAdjust = now + rnd_after(10 * SECS_PER_DAY);
+	mock_at(cycles_at(sim.nextAdjust), adjust, 0);
+}
+
+
+/*** Processes ***/
+
+static bool write_all(int fd, const void *data, size_t n)
+{
+	const char *p = (const char *)data;
+
+	while (n)
+	{
+		ssize_t w = write(fd, p, n);
+		if (w <= 0)
+		{
+			return false;
+		}
+		p += w;
+		n -= w;
+	}
+	return true;
+}
+
+static bool read_all(int fd, void *data, size_t n)
+{
+	char *p = (char *)data;
+
+	while (n)
+	{
+		ssize_t r = read(fd, p, n);
+		if (r <= 0)
+		{
+			return false;
+		}
+		p += r;
+		n -= r;
+	}
+	return true;
+}
+
+// One power-on of the controller, in its own process. Ends with the scenario or a power loss.
+static void life(void)
+{
+	if (!sim.configured)
+	{
+		mock_rtc_set(sim.start);
+	}
+	else
+	{
+		// Off for a while: only the DS3231 keeps running, on its battery.
+		mock_rtc_load(sim.rtc);
+		eeprom_update_block(sim.eeprom, 0, sizeof(sim.eeprom));
+		mock_at24_write(0, sim.at24, sizeof(sim.at24));
+		mock_advance_cycles((uint64_t)sim.offLength * MOCK_F_CPU);
+		memmove(&sim.off[1], &sim.off[0], (SIMoutages - 1) * sizeof(time_t));
+		memmove(&sim.on[1], &sim.on[0], (SIMoutages - 1) * sizeof(time_t));
+		sim.off[0] = sim.now;
+		sim.on[0] = mock_rtc_time();
+		sim.nextOff = sim.on[0] + rnd_after(20 * SECS_PER_DAY);
+		sim.offLength = 60 + rnd(8 * SECS_PER_HOUR);
+		sim.res.outages++;
+	}
+	mock_lift(SIMtravel, sim.lift);
+	mock_lift_on_end(arrived);
+
+	if (!setjmp(lifeEnd))
+	{
+		setup();
+		if (!sim.configured)
+		{
+			scenario_configure();
+		}
+		mock_at(cycles_at(sim.nextOff < sim.end ? sim.nextOff : sim.end), power_off, 0);
+		mock_at(cycles_at(sim.nextGlitch), glitch, 0);
+		mock_at(cycles_at(sim.nextKey), key_down, 0);
+		mock_at(cycles_at(sim.nextAdjust), adjust, 0);
+		mock_at(cycles_at(sim.nextStuck), stuck, 0);
+		for (;;)
+		{
+			loop();
+			check(mock_rtc_time());
+		}
+	}
+
+	sim.now = mock_rtc_time();
+	check(sim.now);
+	mock_rtc_save(sim.rtc);
+	eeprom_read_block(sim.eeprom, 0, sizeof(sim.eeprom));
+	mock_at24_read(0, sim.at24, sizeof(sim.at24));
+	sim.lift = mock_lift_position();
+	if (sim.lift && sim.lift != 100)
+	{
+		sim.door = DOORunknown;
+	}
+}
+
+// Runs the lives of one scenario, each from a fork of this process, which never runs the firmware.
+static Sim_Result scenario(uint32_t seed, uint32_t days)
+{
+	scenario_init(seed, days);
+	while (!sim.configured || sim.now < sim.end)
+	{
+		int fd[2];
+		pid_t pid;
+
+		if (pipe(fd))
+		{
+			break;
+		}
+		pid = fork();
+		if (!pid)
+		{
+			close(fd[0]);
+			life();
+			_exit(write_all(fd[1], &sim, sizeof(sim)) ? 0 : 1);
+		}
+		close(fd[1]);
+		bool ok = (pid > 0) && read_all(fd[0], &sim, sizeof(sim));
+		close(fd[0]);
+		if (pid > 0)
+		{
+			waitpid(pid, 0, 0);
+		}
+		if (!ok)
+		{
+			sim.res.crashed = true;
+			break;
+		}
+	}
+	return sim.res;
+}
+
+int main(int argc, char **argv)
+{
+	static const char *kinds[SIMkinds] = { "manual", "sun", "week" };
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	uint32_t count = (argc > 1) ? strtoul(argv[1], 0, 0) : (uint32_t)(cores > 0 ? cores : 1) * SIMkinds;
+	uint32_t days = (argc > 2) ? strtoul(argv[2], 0, 0) : 365;
+	uint32_t seed = (argc > 3) ? strtoul(argv[3], 0, 0) : 1;
+	uint32_t running = 0, next = 0, failed = 0;
+	Sim_Result *res = new Sim_Result[count];
+	pid_t *pids = new pid_t[count];
+	int *fds = new int[count];
+	Sim_Result total;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	fflush(stdout);
+	while (next < count || running)
+	{
+		if (next < count && running < (uint32_t)(cores > 0 ? cores : 1))
+		{
+			int fd[2];
+			if (pipe(fd))
+			{
+				perror("pcd_yearsim: pipe");
+				return 2;
+			}
+			pids[next] = fork();
+			if (!pids[next])
+			{
+				close(fd[0]);
+				Sim_Result r = scenario(seed + next, days);
+				_exit(write_all(fd[1], &r, sizeof(r)) ? 0 : 1);
+			}
+			close(fd[1]);
+			fds[next++] = fd[0];
+			running++;
+			continue;
+		}
+		pid_t pid = wait(0);
+		for (uint32_t i = 0; i < next; i++)
+		{
+			if (pids[i] == pid)
+			{
+				memset(&res[i], 0, sizeof(res[i]));
+				if (!read_all(fds[i], &res[i], sizeof(res[i])))
+				{
+					res[i].seed = seed + i;
+					res[i].kind = (seed + i) % SIMkinds;
+					res[i].crashed = true;
+				}
+				close(fds[i]);
+				running--;
+			}
+		}
+	}
+	double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("%-6s %-7s %6s %7s %7s %6s %6s %6s %6s %7s %7s %6s %7s %6s\n", "seed", "kind", "days", "events", "done",
+		"no-op", "lost", "missed", "extra", "outages", "glitch", "keys", "adjust", "stuck");
+	memset(&total, 0, sizeof(total));
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Sim_Result &r = res[i];
+		printf("%-6u %-7s %6u %7u %7u %6u %6u %6u %6u %7u %7u %6u %7u %6u%s\n", r.seed, kinds[r.kind], r.days, r.events,
+			r.done, r.noop, r.lost, r.missed, r.extra, r.outages, r.glitches, r.keys, r.adjusts, r.stucks,
+			r.crashed ? "  crashed" : "");
+		total.days += r.days;
+		total.events += r.events;
+		total.done += r.done;
+		total.noop += r.noop;
+		total.lost += r.lost;
+		total.missed += r.missed;
+		total.extra += r.extra;
+		if (r.crashed || r.missed || r.extra)
+		{
+			failed++;
+		}
+	}
+	printf("%u scenarios, %u simulated days in %.2f s on %ld cores: %.0f simulated days/s\n", count, total.days, s,
+		cores, total.days / s);
+	printf("%u events: %u done, %u no-op, %u lost to outages, %u missed, %u extra; %u scenarios failed\n",
+		total.events, total.done, total.noop, total.lost, total.missed, total.extra, failed);
+	return failed ? 1 : 0;
+}
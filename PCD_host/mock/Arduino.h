@@ -0,0 +1,145 @@
+#ifndef Mock_Arduino
+#define Mock_Arduino
+/*
+ * Arduino.h (host mock)
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Minimal stand-in for the Arduino core so that PCD_main can be compiled
+ *	as a plain Linux library. Only the parts of the core the firmware uses
+ *	are provided. Time is virtual and advanced by delay() and the functions
+ *	in Mock_HW.h, which also run the mocked interrupt sources.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <util/delay.h>
+
+typedef bool		boolean;
+typedef uint8_t		byte;
+typedef uint16_t	word;
+
+#define HIGH		0x1
+#define LOW			0x0
+
+#define INPUT			0x0
+#define OUTPUT			0x1
+#define INPUT_PULLUP	0x2
+
+#define CHANGE		1
+#define FALLING		2
+#define RISING		3
+
+#define DEC			10
+#define HEX			16
+#define OCT			8
+#define BIN			2
+
+#define A0			14
+#define A1			15
+#define A2			16
+#define A3			17
+#define A4			18
+#define A5			19
+
+#define bit(b)				(1UL << (b))
+#define bitRead(v, b)		(((v) >> (b)) & 0x01)
+#define lowByte(w)			((uint8_t) ((w) & 0xff))
+#define highByte(w)			((uint8_t) ((w) >> 8))
+
+#define digitalPinToInterrupt(p)	((p) == 2 ? 0 : ((p) == 3 ? 1 : -1))
+
+#define noInterrupts()	cli()
+#define interrupts()	sei()
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+
+// Flash strings are ordinary strings on the host.
+class __FlashStringHelper;
+#define F(string_literal)	(reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t *buffer, size_t size);
+	size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+
+	size_t print(const __FlashStringHelper *s);
+	size_t print(const char s[]);
+	size_t print(char c);
+	size_t print(unsigned char n, int base = DEC);
+	size_t print(int n, int base = DEC);
+	size_t print(unsigned int n, int base = DEC);
+	size_t print(long n, int base = DEC);
+	size_t print(unsigned long n, int base = DEC);
+	size_t print(long long n, int base = DEC);
+	size_t print(unsigned long long n, int base = DEC);
+	size_t print(double n, int digits = 2);
+
+	size_t println(void);
+	template <typename T> size_t println(T arg) { size_t n = print(arg); return n + println(); }
+	template <typename T> size_t println(T arg, int base) { size_t n = print(arg, base); return n + println(); }
+
+private:
+	size_t printNumber(unsigned long long n, uint8_t base);
+};
+
+
+class Stream : public Print
+{
+public:
+	Stream() : _timeout(1000) {}
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+
+	void setTimeout(unsigned long timeout) { _timeout = timeout; }
+	long parseInt(void);
+
+protected:
+	unsigned long _timeout;
+	int timedPeek(void);
+};
+
+
+class HardwareSerial : public Stream
+{
+public:
+	void begin(unsigned long baud);
+	void end(void) {}
+	int available(void);
+	int availableForWrite(void);
+	int read(void);
+	int peek(void);
+	void flush(void);
+	size_t write(uint8_t c);
+	using Print::write;
+	operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
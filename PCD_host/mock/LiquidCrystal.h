@@ -0,0 +1,48 @@
+#ifndef Mock_LiquidCrystal
+#define Mock_LiquidCrystal
+/*
+ * LiquidCrystal.h (host mock)
+ *
+ * Description:
+ *	HD44780 model with the Arduino LiquidCrystal interface. Keeps the
+ *	display RAM, cursor and blink state, and counts every command and
+ *	data byte sent to the controller together with its execution time.
+ */
+
+#include <Arduino.h>
+
+class LiquidCrystal : public Print
+{
+public:
+	LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3);
+
+	void begin(uint8_t cols, uint8_t rows);
+	void clear(void);
+	void home(void);
+	void noDisplay(void);
+	void display(void);
+	void noBlink(void);
+	void blink(void);
+	void noCursor(void);
+	void cursor(void);
+	void setCursor(uint8_t col, uint8_t row);
+	void command(uint8_t value);
+	size_t write(uint8_t value);
+	using Print::write;
+
+	// Host side inspection.
+	char charAt(uint8_t col, uint8_t row) const;
+	uint8_t cursorCol(void) const { return addr % 0x40; }
+	uint8_t cursorRow(void) const { return addr / 0x40; }
+	bool blinking(void) const { return displayControl & 0x01; }
+
+private:
+	void send(uint8_t value, bool data);
+
+	uint8_t ddram[0x80];
+	uint8_t addr;
+	uint8_t displayControl;
+	uint8_t cols, rows;
+};
+
+#endif
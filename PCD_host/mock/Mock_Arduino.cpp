@@ -0,0 +1,324 @@
+/*
+ * Mock_Arduino.cpp
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Print/Stream, Serial and EEPROM of the host mock.
+ */
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include <stdio.h>
+#include <string>
+
+#include "Mock_HW.h"
+
+static uint8_t eeprom[E2END + 1];
+static bool eeprom_erased;
+
+static std::string serial_rx;
+static bool serial_echo;
+static uint32_t serial_cycles_per_byte = MOCK_F_CPU / 960;	// 9600 baud, 10 bits per byte
+static uint64_t serial_tx_done;
+
+
+/*** EEPROM ***/
+
+static void eeprom_init(void)
+{
+	if (!eeprom_erased)
+	{
+		memset(eeprom, 0xFF, sizeof(eeprom));
+		eeprom_erased = true;
+	}
+}
+
+uint8_t eeprom_read_byte(const uint8_t *addr)
+{
+	eeprom_init();
+	return eeprom[(uintptr_t)addr & E2END];
+}
+
+uint16_t eeprom_read_word(const uint16_t *addr)
+{
+	return eeprom_read_byte((const uint8_t *)addr) | (eeprom_read_byte((const uint8_t *)addr + 1) << 8);
+}
+
+void eeprom_write_byte(uint8_t *addr, uint8_t value)
+{
+	eeprom_init();
+	eeprom[(uintptr_t)addr & E2END] = value;
+	mock_count.eeprom_writes++;
+}
+
+void eeprom_update_byte(uint8_t *addr, uint8_t value)
+{
+	if (eeprom_read_byte(addr) != value)
+	{
+		eeprom_write_byte(addr, value);
+	}
+}
+
+void eeprom_read_block(void *dst, const void *src, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		((uint8_t *)dst)[i] = eeprom_read_byte((const uint8_t *)src + i);
+	}
+}
+
+void eeprom_update_block(const void *src, void *dst, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+	{
+		eeprom_update_byte((uint8_t *)dst + i, ((const uint8_t *)src)[i]);
+	}
+}
+
+
+/*** Print ***/
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+	size_t n = 0;
+	while (size--)
+	{
+		n += write(*buffer++);
+	}
+	return n;
+}
+
+size_t Print::print(const __FlashStringHelper *s)
+{
+	return write((const char *)s);
+}
+
+size_t Print::print(const char s[])
+{
+	return write(s);
+}
+
+size_t Print::print(char c)
+{
+	return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char n, int base)
+{
+	return print((unsigned long)n, base);
+}
+
+size_t Print::print(int n, int base)
+{
+	return print((long)n, base);
+}
+
+size_t Print::print(unsigned int n, int base)
+{
+	return print((unsigned long)n, base);
+}
+
+size_t Print::print(long n, int base)
+{
+	return print((long long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+	return print((unsigned long long)n, base);
+}
+
+size_t Print::print(long long n, int base)
+{
+	if (base == 0)
+	{
+		return write((uint8_t)n);
+	}
+	if (base == DEC && n < 0)
+	{
+		return print('-') + printNumber((unsigned long long)-n, DEC);
+	}
+	return printNumber((unsigned long long)n, base);
+}
+
+size_t Print::print(unsigned long long n, int base)
+{
+	if (base == 0)
+	{
+		return write((uint8_t)n);
+	}
+	return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits)
+{
+	char buf[48];
+	snprintf(buf, sizeof(buf), "%.*f", digits, n);
+	return write(buf);
+}
+
+size_t Print::println(void)
+{
+	return write("\r\n");
+}
+
+size_t Print::printNumber(unsigned long long n, uint8_t base)
+{
+	char buf[8 * sizeof(n) + 1];
+	char *str = &buf[sizeof(buf) - 1];
+
+	if (base < 2)
+	{
+		base = 10;
+	}
+	*str = '\0';
+	do
+	{
+		char c = n % base;
+		n /= base;
+		*--str = c < 10 ? c + '0' : c + 'A' - 10;
+	} while (n);
+
+	return write(str);
+}
+
+
+/*** Stream ***/
+
+int Stream::timedPeek(void)
+{
+	unsigned long start = millis();
+	do
+	{
+		int c = peek();
+		if (c >= 0)
+		{
+			return c;
+		}
+		delay(1);
+	} while (millis() - start < _timeout);
+	return -1;
+}
+
+long Stream::parseInt(void)
+{
+	bool isNegative = false;
+	long value = 0;
+	int c;
+
+	// Skip everything that cannot start a number.
+	while (true)
+	{
+		c = timedPeek();
+		if (c < 0 || c == '-' || (c >= '0' && c <= '9'))
+		{
+			break;
+		}
+		read();
+	}
+	if (c < 0)
+	{
+		return 0;
+	}
+
+	do
+	{
+		if (c == '-')
+		{
+			isNegative = true;
+		}
+		else
+		{
+			value = value * 10 + c - '0';
+		}
+		read();
+		c = timedPeek();
+	} while (c == '-' || (c >= '0' && c <= '9'));
+
+	return isNegative ? -value : value;
+}
+
+
+/*** Serial ***/
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long baud)
+{
+	serial_cycles_per_byte = MOCK_F_CPU * 10UL / baud;
+}
+
+int HardwareSerial::available(void)
+{
+	return (int)serial_rx.size();
+}
+
+int HardwareSerial::availableForWrite(void)
+{
+	uint64_t queued = 0;
+	if (serial_tx_done > mock_cycles())
+	{
+		queued = (serial_tx_done - mock_cycles() + serial_cycles_per_byte - 1) / serial_cycles_per_byte;
+	}
+	return queued >= 64 ? 0 : (int)(64 - queued);
+}
+
+int HardwareSerial::read(void)
+{
+	if (serial_rx.empty())
+	{
+		return -1;
+	}
+	int c = (uint8_t)serial_rx[0];
+	serial_rx.erase(0, 1);
+	return c;
+}
+
+int HardwareSerial::peek(void)
+{
+	return serial_rx.empty() ? -1 : (uint8_t)serial_rx[0];
+}
+
+void HardwareSerial::flush(void)
+{
+	if (serial_tx_done > mock_cycles())
+	{
+		mock_advance_cycles(serial_tx_done - mock_cycles());
+	}
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	// The core blocks while its 64 byte transmit buffer is full.
+	if (!availableForWrite())
+	{
+		uint64_t wait = serial_tx_done - 63 * (uint64_t)serial_cycles_per_byte - mock_cycles();
+		mock_count.serial_stall_us += wait / (MOCK_F_CPU / 1000000UL);
+		mock_advance_cycles(wait);
+	}
+	serial_tx_done = ((serial_tx_done > mock_cycles()) ? serial_tx_done : mock_cycles()) + serial_cycles_per_byte;
+	mock_count.serial_tx++;
+
+	if (serial_echo)
+	{
+		putchar(c);
+	}
+	return 1;
+}
+
+void mock_serial_input(const char *s)
+{
+	// The start bit is a falling edge on RXD (PD0), which the UART misses in power-down.
+	mock_pin_change_rx();
+	if (mock_sleeping_deep() && *s)
+	{
+		s++;
+	}
+	serial_rx += s;
+}
+
+void mock_serial_echo(bool on)
+{
+	serial_echo = on;
+}
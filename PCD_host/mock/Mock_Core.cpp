@@ -0,0 +1,738 @@
+/*
+ * Mock_Core.cpp
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Virtual time, registers, interrupt dispatch, Timer1, sleep modes,
+ *	pins and ADC of the host mock.
+ *
+ *	The TWI is in Mock_TWI.cpp, it advances with the I/O clock like Timer1.
+ *
+ *	Timer0 is only modelled as far as its overflow goes, which the Arduino
+ *	core uses for millis(): it wakes the CPU from idle and can trigger the
+ *	ADC. The ADC converts in 13 ADC clocks (25 after enabling), single shot
+ *	on ADSC, free running or auto triggered by Timer0 overflow.
+ *
+ *	Idle sleep with the keypad settled at no key jumps up to
+ *	IDLE_SKIP_PERIODS overflows at once, stopping before the next event,
+ *	the way power-down jumps to the next alarm. The conversions it passes
+ *	would have repeated the last result, they are counted but not run.
+ *
+ *	Two clocks are kept: wall time, which the DS3231 and scheduled stimuli
+ *	follow, and the I/O clock, which drives millis() and Timer1 and stops
+ *	in power-down like on the ATmega328P.
+ *
+ *	Interrupt flag registers (EIFR, PCIFR, TIFR1) are write-one-to-clear on
+ *	the target. The mock keeps the flags internally and applies what the
+ *	firmware wrote to the registers the next time virtual time moves.
+ */
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <stdio.h>
+#include <vector>
+
+#include "Mock_HW.h"
+
+// Firmware interrupt vectors, resolved at link time if the firmware has them.
+extern "C" void PCINT1_vect(void) __attribute__((weak));
+extern "C" void PCINT2_vect(void) __attribute__((weak));
+extern "C" void TIMER1_COMPA_vect(void) __attribute__((weak));
+extern "C" void TIMER1_OVF_vect(void) __attribute__((weak));
+extern "C" void ADC_vect(void) __attribute__((weak));
+extern "C" void TWI_vect(void) __attribute__((weak));
+
+Mock_Counters mock_count;
+
+// Registers
+volatile uint8_t SREG = (1 << SREG_I);	// the Arduino core enables interrupts before setup()
+volatile uint8_t MCUCR, SMCR;
+volatile uint8_t PINB = 0xFF, DDRB, PORTB;
+volatile uint8_t PINC = 0xFF, DDRC, PORTC;
+volatile uint8_t PIND = 0xFF, DDRD, PORTD;
+volatile uint8_t EICRA, EIMSK, EIFR;
+volatile uint8_t PCICR, PCIFR, PCMSK0, PCMSK1, PCMSK2;
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+volatile uint16_t TCNT1, OCR1A, OCR1B;
+volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2;
+volatile uint8_t ADMUX, ADCSRA = (1 << ADEN), ADCSRB, DIDR0;
+volatile uint16_t ADC;
+
+#define TIMER0_OVF_CYCLES	16384UL		// Timer0 runs at F_CPU/64 for millis()
+#define IDLE_SKIP_PERIODS	16			// Timer0 periods idle sleep jumps at most, a loop() pass timed by millis() starts that late at worst
+#define ADC_SETTLED			32			// Equal conversions after which the keypad has settled, more than 2 x BTNdebounce
+#define MAX_SLEEP_CYCLES	(MOCK_F_CPU * 86400ULL * 800)
+
+struct Stimulus
+{
+	uint64_t at;
+	void (*fn)(void *);
+	void *arg;
+};
+
+static uint64_t now_cycles;
+static uint64_t io_cycles;
+static uint32_t t1_residual;
+static uint64_t isr_serviced;
+static bool deep_sleep;
+static std::vector<Stimulus> stimuli;
+
+static uint16_t adc_value[8] = { MOCK_ADC_NONE, MOCK_ADC_NONE, MOCK_ADC_NONE, MOCK_ADC_NONE,
+	MOCK_ADC_NONE, MOCK_ADC_NONE, MOCK_ADC_NONE, MOCK_ADC_NONE };
+
+static void (*int0_func)(void);
+static bool int0_line = true;
+static uint8_t int_flags;		// EIFR
+static uint8_t pcint_flags;		// PCIFR
+static uint8_t t1_flags;		// TIFR1
+static bool adc_flag;			// ADIF
+
+static bool adc_enabled;		// ADEN as the ADC last saw it, the first conversion after enabling is longer
+static uint64_t adc_done;		// io_cycles when the running conversion ends, 0 if none
+static uint16_t adc_same;		// Conversions in a row with the result of the one before
+
+
+void mock_reset_counters(void)
+{
+	memset(&mock_count, 0, sizeof(mock_count));
+}
+
+
+/*** Interrupts ***/
+
+static void adc_control(void);
+
+static void apply_flag_writes(void)
+{
+	int_flags &= ~EIFR;
+	pcint_flags &= ~PCIFR;
+	t1_flags &= ~TIFR1;
+	EIFR = 0;
+	PCIFR = 0;
+	TIFR1 = 0;
+	if (ADCSRA & (1 << ADIF))
+	{
+		adc_flag = false;
+		ADCSRA &= ~(1 << ADIF);
+	}
+	adc_control();
+	mock_twi_control();
+}
+
+static void run_isr(void (*isr)(void))
+{
+	// The AVR clears the I flag on entry and sets it again with RETI.
+	isr_serviced++;
+	SREG &= ~(1 << SREG_I);
+	if (isr)
+	{
+		isr();
+	}
+	SREG |= (1 << SREG_I);
+	mock_twi_control();		// The ISR may have written TWINT, which clears the flag at once.
+}
+
+static bool int0_level_mode(void)
+{
+	return !(EICRA & ((1 << ISC01) | (1 << ISC00)));
+}
+
+// Whether an enabled interrupt is waiting, in vector order. Returns 0 if none.
+static int pending_vector(void)
+{
+	if ((EIMSK & (1 << INT0)) && ((int_flags & (1 << INTF0)) || (int0_level_mode() && !int0_line)))
+	{
+		return 1;
+	}
+	if ((PCICR & (1 << PCIE1)) && (pcint_flags & (1 << PCIF1)))
+	{
+		return 4;
+	}
+	if ((PCICR & (1 << PCIE2)) && (pcint_flags & (1 << PCIF2)))
+	{
+		return 5;
+	}
+	if ((TIMSK1 & (1 << OCIE1A)) && (t1_flags & (1 << OCF1A)))
+	{
+		return 11;
+	}
+	if ((TIMSK1 & (1 << TOIE1)) && (t1_flags & (1 << TOV1)))
+	{
+		return 13;
+	}
+	if ((ADCSRA & (1 << ADIE)) && adc_flag)
+	{
+		return 21;
+	}
+	if (mock_twi_interrupt())
+	{
+		return 24;
+	}
+	return 0;
+}
+
+static void dispatch_interrupts(void)
+{
+	while (SREG & (1 << SREG_I))
+	{
+		switch (pending_vector())
+		{
+			case 1:
+				int_flags &= ~(1 << INTF0);
+				mock_count.isr_int0++;
+				run_isr(int0_func);
+				break;
+			case 4:
+				pcint_flags &= ~(1 << PCIF1);
+				mock_count.isr_pcint++;
+				run_isr(PCINT1_vect);
+				break;
+			case 5:
+				pcint_flags &= ~(1 << PCIF2);
+				mock_count.isr_pcint++;
+				run_isr(PCINT2_vect);
+				break;
+			case 11:
+				t1_flags &= ~(1 << OCF1A);
+				mock_count.isr_timer1++;
+				run_isr(TIMER1_COMPA_vect);
+				break;
+			case 13:
+				t1_flags &= ~(1 << TOV1);
+				mock_count.isr_timer1++;
+				run_isr(TIMER1_OVF_vect);
+				break;
+			case 21:
+				adc_flag = false;
+				mock_count.isr_adc++;
+				run_isr(ADC_vect);
+				break;
+			case 24:
+				mock_count.isr_twi++;		// TWINT stays set until the ISR writes it.
+				run_isr(TWI_vect);
+				break;
+			default:
+				return;
+		}
+	}
+}
+
+void mock_int0_update(void)
+{
+	bool line = !mock_rtc_int_asserted();
+	uint8_t isc = EICRA & ((1 << ISC01) | (1 << ISC00));
+
+	// Edges are detected with the I/O clock, which is stopped in power-down.
+	if (!deep_sleep && line != int0_line)
+	{
+		if (isc == (1 << ISC00) || (isc == (1 << ISC01) && !line) || (isc == ((1 << ISC01) | (1 << ISC00)) && line))
+		{
+			int_flags |= (1 << INTF0);
+		}
+	}
+	int0_line = line;
+	PIND = line ? (PIND | (1 << PIND2)) : (PIND & ~(1 << PIND2));
+}
+
+void mock_int0_glitch(void)
+{
+	// A short low pulse: an edge for the I/O clock, too short to hold the level a wake-up from power-down needs.
+	uint8_t isc = EICRA & ((1 << ISC01) | (1 << ISC00));
+
+	if (!deep_sleep && int0_line && isc)
+	{
+		int_flags |= (1 << INTF0);
+	}
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode)
+{
+	if (interruptNum == 0)
+	{
+		int0_func = userFunc;
+		EICRA = (EICRA & ~((1 << ISC01) | (1 << ISC00))) | (mode << ISC00);
+		EIMSK |= (1 << INT0);
+	}
+}
+
+void detachInterrupt(uint8_t interruptNum)
+{
+	if (interruptNum == 0)
+	{
+		EIMSK &= ~(1 << INT0);
+		int0_func = 0;
+	}
+}
+
+
+/*** Timer1 ***/
+
+#define T1_STOPPED	0xFF
+
+// Prescaler of Timer1 as a power of 2, the timer steps on every step of the I/O clock.
+static uint8_t t1_prescaler(void)
+{
+	switch (TCCR1B & ((1 << CS12) | (1 << CS11) | (1 << CS10)))
+	{
+		case 1:		return 0;
+		case 2:		return 3;
+		case 3:		return 6;
+		case 4:		return 8;
+		case 5:		return 10;
+		default:	return T1_STOPPED;	// stopped or external clock
+	}
+}
+
+static bool t1_ctc(void)
+{
+	return (TCCR1B & (1 << WGM12)) && !(TCCR1B & (1 << WGM13));
+}
+
+// Timer ticks until TCNT1 next matches OCR1A or overflows.
+static uint32_t t1_ticks_to_event(void)
+{
+	uint16_t cnt = TCNT1;
+
+	if (t1_ctc() && cnt <= OCR1A)
+	{
+		return (cnt == OCR1A) ? (uint32_t)OCR1A + 1 : (uint32_t)(OCR1A - cnt);
+	}
+
+	uint32_t toMatch = (uint16_t)(OCR1A - cnt);
+	uint32_t toOverflow = 0x10000UL - cnt;
+	if (toMatch == 0)
+	{
+		toMatch = 0x10000UL;
+	}
+	return (toMatch < toOverflow) ? toMatch : toOverflow;
+}
+
+static uint64_t t1_cycles_to_event(void)
+{
+	uint8_t ps = t1_prescaler();
+	if (ps == T1_STOPPED)
+	{
+		return UINT64_MAX;
+	}
+	return ((uint64_t)t1_ticks_to_event() << ps) - t1_residual;
+}
+
+// Never called with more cycles than t1_cycles_to_event() returned.
+static void t1_advance(uint64_t cycles)
+{
+	uint8_t ps = t1_prescaler();
+	if (ps == T1_STOPPED)
+	{
+		return;
+	}
+
+	uint64_t total = t1_residual + cycles;
+	uint32_t ticks = total >> ps;
+	t1_residual = total & ((1UL << ps) - 1);
+	if (!ticks)
+	{
+		return;
+	}
+
+	uint16_t cnt = TCNT1;
+	if (t1_ctc() && cnt <= OCR1A)
+	{
+		cnt = (cnt + ticks) % ((uint32_t)OCR1A + 1);
+	}
+	else
+	{
+		uint32_t next = (uint32_t)cnt + ticks;
+		if (next > 0xFFFF)
+		{
+			t1_flags |= (1 << TOV1);
+		}
+		cnt = (uint16_t)next;
+	}
+	TCNT1 = cnt;
+	if (cnt == OCR1A)
+	{
+		t1_flags |= (1 << OCF1A);
+	}
+}
+
+
+/*** ADC ***/
+
+#define ADTS_FREE_RUNNING	0
+#define ADTS_TIMER0_OVF		(1 << ADTS2)
+
+static uint32_t adc_prescaler(void)
+{
+	uint8_t ps = ADCSRA & ((1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0));
+	return ps ? (1UL << ps) : 2;
+}
+
+static bool adc_triggered_by(uint8_t source)
+{
+	return (ADCSRA & (1 << ADEN)) && (ADCSRA & (1 << ADATE)) &&
+		(ADCSRB & ((1 << ADTS2) | (1 << ADTS1) | (1 << ADTS0))) == source;
+}
+
+static void adc_start(void)
+{
+	adc_done = io_cycles + (adc_enabled ? 13 : 25) * adc_prescaler();
+	adc_enabled = true;
+	ADCSRA |= (1 << ADSC);
+}
+
+// Follows what the firmware wrote to ADCSRA: enable, disable and single conversions.
+static void adc_control(void)
+{
+	if (!(ADCSRA & (1 << ADEN)))
+	{
+		adc_enabled = false;
+		adc_done = 0;
+		ADCSRA &= ~(1 << ADSC);
+		return;
+	}
+	if ((ADCSRA & (1 << ADSC)) && !adc_done)
+	{
+		adc_start();
+	}
+}
+
+static void adc_complete(void)
+{
+	uint16_t value = adc_value[ADMUX & 7];
+
+	adc_same = ((value == ADC) && (adc_same < 0xFFFF)) ? adc_same + 1 : 0;
+	ADC = value;
+	adc_done = 0;
+	adc_flag = true;
+	ADCSRA &= ~(1 << ADSC);
+	mock_count.adc_conversions++;
+
+	if (adc_triggered_by(ADTS_FREE_RUNNING))
+	{
+		adc_start();
+	}
+}
+
+static void timer0_overflow(void)
+{
+	if (adc_triggered_by(ADTS_TIMER0_OVF) && !adc_done)
+	{
+		adc_start();
+	}
+}
+
+
+/*** Virtual time ***/
+
+uint64_t mock_cycles(void)
+{
+	return now_cycles;
+}
+
+void mock_at(uint64_t cycles, void (*fn)(void *), void *arg)
+{
+	Stimulus st = { cycles, fn, arg };
+	std::vector<Stimulus>::iterator it = stimuli.begin();
+	while (it != stimuli.end() && it->at <= cycles)
+	{
+		++it;
+	}
+	stimuli.insert(it, st);
+}
+
+// Largest step that does not skip an event. ioClock selects whether Timer1 counts,
+// timer0 whether the Timer0 overflows that start a keypad conversion count as events.
+static uint64_t step_limit(uint64_t limit, bool ioClock, bool timer0 = true)
+{
+	if (ioClock)
+	{
+		uint64_t t1 = t1_cycles_to_event();
+		if (t1 < limit)
+		{
+			limit = t1;
+		}
+		if (adc_done && adc_done - io_cycles < limit)
+		{
+			limit = adc_done - io_cycles;
+		}
+		if (timer0 && adc_triggered_by(ADTS_TIMER0_OVF))
+		{
+			uint64_t t0 = TIMER0_OVF_CYCLES - io_cycles % TIMER0_OVF_CYCLES;
+			if (t0 < limit)
+			{
+				limit = t0;
+			}
+		}
+		uint64_t twi = mock_twi_cycles_to_event();
+		if (twi < limit)
+		{
+			limit = twi;
+		}
+	}
+	uint64_t rtc = mock_rtc_cycles_to_event();
+	if (rtc < limit)
+	{
+		limit = rtc;
+	}
+	if (!stimuli.empty() && stimuli.front().at - now_cycles < limit)
+	{
+		limit = stimuli.front().at - now_cycles;
+	}
+	uint64_t lift = mock_lift_cycles_to_event();
+	if (lift < limit)
+	{
+		limit = lift;
+	}
+	return limit;
+}
+
+static void step(uint64_t cycles, bool ioClock)
+{
+	if (ioClock)
+	{
+		t1_advance(cycles);
+		mock_twi_step(cycles);
+		io_cycles += cycles;
+		if (adc_done && io_cycles >= adc_done)
+		{
+			adc_complete();
+		}
+		if (!(io_cycles % TIMER0_OVF_CYCLES))
+		{
+			timer0_overflow();
+		}
+	}
+	now_cycles += cycles;
+	mock_lift_step();
+
+	if (!mock_rtc_cycles_to_event())
+	{
+		mock_rtc_tick();
+	}
+	while (!stimuli.empty() && stimuli.front().at <= now_cycles)
+	{
+		Stimulus st = stimuli.front();
+		stimuli.erase(stimuli.begin());
+		st.fn(st.arg);
+	}
+}
+
+void mock_advance_cycles(uint64_t cycles)
+{
+	uint64_t end = now_cycles + cycles;
+
+	apply_flag_writes();
+	dispatch_interrupts();
+	while (now_cycles < end)
+	{
+		step(step_limit(end - now_cycles, true), true);
+		dispatch_interrupts();
+	}
+}
+
+void mock_advance_us(uint64_t us)
+{
+	mock_advance_cycles(us * (MOCK_F_CPU / 1000000UL));
+}
+
+unsigned long millis(void)
+{
+	return (unsigned long)(io_cycles / (MOCK_F_CPU / 1000UL));
+}
+
+unsigned long micros(void)
+{
+	return (unsigned long)(io_cycles / (MOCK_F_CPU / 1000000UL));
+}
+
+void delay(unsigned long ms)
+{
+	mock_advance_us((uint64_t)ms * 1000UL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	mock_advance_us(us);
+}
+
+
+/*** Sleep ***/
+
+bool mock_sleeping_deep(void)
+{
+	return deep_sleep;
+}
+
+// Cycles idle sleep can jump to a later Timer0 overflow, or 0. While the keypad reads no key and
+// has settled, each overflow only converts the same value again, which ISR(ADC_vect) ignores.
+// Those conversions are counted as if they had run. The jump ends on an overflow before the next
+// event, whose conversion runs, and the CPU wakes as it would have there.
+static uint64_t idle_skip(void)
+{
+	if (!adc_triggered_by(ADTS_TIMER0_OVF) || adc_done || adc_flag || (adc_same < ADC_SETTLED) ||
+		(adc_value[ADMUX & 7] != MOCK_ADC_NONE))
+	{
+		return 0;
+	}
+	uint64_t toTimer0 = TIMER0_OVF_CYCLES - io_cycles % TIMER0_OVF_CYCLES;
+	uint64_t limit = step_limit(toTimer0 + (IDLE_SKIP_PERIODS - 1) * TIMER0_OVF_CYCLES, true, false);
+	if (limit < toTimer0 + TIMER0_OVF_CYCLES)
+	{
+		return 0;
+	}
+	uint64_t skipped = (limit - toTimer0) / TIMER0_OVF_CYCLES;
+	mock_count.adc_conversions += skipped;
+	mock_count.isr_adc += skipped;
+	return toTimer0 + skipped * TIMER0_OVF_CYCLES;
+}
+
+void sleep_cpu(void)
+{
+	uint8_t mode = SMCR & ((1 << SM2) | (1 << SM1) | (1 << SM0));
+	uint64_t start = now_cycles;
+
+	apply_flag_writes();
+	if (!(SMCR & (1 << SE)) || !(SREG & (1 << SREG_I)) || pending_vector())
+	{
+		dispatch_interrupts();
+		return;
+	}
+
+	if (mode == SLEEP_MODE_IDLE)
+	{
+		// Any interrupt wakes the CPU, at the latest the next Timer0 overflow of millis().
+		uint64_t serviced = isr_serviced;
+		uint64_t skip = idle_skip();
+		if (skip)
+		{
+			step(skip, true);
+			dispatch_interrupts();
+		}
+		while (isr_serviced == serviced && (!skip || io_cycles % TIMER0_OVF_CYCLES))
+		{
+			uint64_t toTimer0 = TIMER0_OVF_CYCLES - io_cycles % TIMER0_OVF_CYCLES;
+			step(step_limit(toTimer0, true), true);
+			dispatch_interrupts();
+			skip = 1;
+		}
+		mock_count.sleep_idle_us += (now_cycles - start) / (MOCK_F_CPU / 1000000UL);
+		return;
+	}
+
+	// Power-down and the other deep modes: only level INT0, pin changes and reset wake the CPU.
+	deep_sleep = true;
+	while (!pending_vector())
+	{
+		if (now_cycles - start > MAX_SLEEP_CYCLES)
+		{
+			fprintf(stderr, "mock: nothing woke the MCU from power-down for 800 days\n");
+			break;
+		}
+		step(step_limit(start + MAX_SLEEP_CYCLES + 1 - now_cycles, false), false);
+	}
+	deep_sleep = false;
+	mock_count.sleep_deep_us += (now_cycles - start) / (MOCK_F_CPU / 1000000UL);
+	dispatch_interrupts();
+}
+
+
+/*** Pins and ADC ***/
+
+static volatile uint8_t *pin_port(uint8_t pin, uint8_t *bitno)
+{
+	if (pin < 8)
+	{
+		*bitno = pin;
+		return &PORTD;
+	}
+	if (pin < 14)
+	{
+		*bitno = pin - 8;
+		return &PORTB;
+	}
+	*bitno = pin - 14;
+	return &PORTC;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	uint8_t b;
+	volatile uint8_t *port = pin_port(pin, &b);
+	volatile uint8_t *ddr = (port == &PORTD) ? &DDRD : ((port == &PORTB) ? &DDRB : &DDRC);
+
+	if (mode == OUTPUT)
+	{
+		*ddr |= (1 << b);
+	}
+	else
+	{
+		*ddr &= ~(1 << b);
+		*port = (mode == INPUT_PULLUP) ? (*port | (1 << b)) : (*port & ~(1 << b));
+	}
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+	uint8_t b;
+	volatile uint8_t *port = pin_port(pin, &b);
+	*port = val ? (*port | (1 << b)) : (*port & ~(1 << b));
+}
+
+int digitalRead(uint8_t pin)
+{
+	uint8_t b;
+	volatile uint8_t *port = pin_port(pin, &b);
+	volatile uint8_t *in = (port == &PORTD) ? &PIND : ((port == &PORTB) ? &PINB : &PINC);
+	return (*in >> b) & 1;
+}
+
+void mock_set_adc(uint8_t pin, uint16_t value)
+{
+	uint8_t ch = (pin >= A0 ? pin - A0 : pin) & 7;
+	adc_value[ch] = value;
+
+	// The digital input buffer reads the same pin; below VIL (0.3 Vcc) it is a guaranteed low.
+	uint8_t level = (value >= 307) ? (1 << ch) : 0;
+	if (ch < 6 && (PINC & (1 << ch)) != level)
+	{
+		PINC ^= (1 << ch);
+		if (PCMSK1 & (1 << ch))
+		{
+			pcint_flags |= (1 << PCIF1);
+		}
+	}
+}
+
+void mock_set_pin(uint8_t pin, bool high)
+{
+	uint8_t b;
+	volatile uint8_t *port = pin_port(pin, &b);
+	volatile uint8_t *in = (port == &PORTD) ? &PIND : ((port == &PORTB) ? &PINB : &PINC);
+	volatile uint8_t *mask = (port == &PORTD) ? &PCMSK2 : ((port == &PORTB) ? &PCMSK0 : &PCMSK1);
+	uint8_t flag = (port == &PORTD) ? PCIF2 : ((port == &PORTB) ? PCIF0 : PCIF1);
+
+	if (((*in >> b) & 1) == high)
+	{
+		return;
+	}
+	*in ^= (1 << b);
+	if (*mask & (1 << b))
+	{
+		pcint_flags |= (1 << flag);
+	}
+}
+
+void mock_pin_change_rx(void)
+{
+	if (PCMSK2 & (1 << PCINT16))
+	{
+		pcint_flags |= (1 << PCIF2);
+	}
+}
+
+int analogRead(uint8_t pin)
+{
+	mock_count.adc_conversions++;
+	return adc_value[(pin >= A0 ? pin - A0 : pin) & 7];
+}
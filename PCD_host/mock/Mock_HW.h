@@ -0,0 +1,107 @@
+#ifndef Mock_HW
+#define Mock_HW
+/*
+ * Mock_HW.h
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Host side control of the mocked hardware: virtual time, keypad, serial
+ *	input, the TWI with the DS3231 and AT24C32 models, the lift with its end switches and
+ *	the activity counters used by the benchmarks.
+ *	Time is counted in CPU cycles of a 16 MHz ATmega328P. Advancing it runs
+ *	Timer1, the ADC, the TWI, the DS3231 oscillator, INT0 and the pin change interrupts
+ *	exactly as often as the real hardware would, and calls the firmware
+ *	ISRs from the same places. sleep_cpu() skips ahead to the next wake-up.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#define MOCK_F_CPU		16000000UL
+
+// Ladder voltages of the LCD keypad shield as read by the 10 bit ADC.
+#define MOCK_ADC_NONE	1023
+#define MOCK_ADC_RIGHT	0
+#define MOCK_ADC_UP		144
+#define MOCK_ADC_DOWN	329
+#define MOCK_ADC_LEFT	504
+#define MOCK_ADC_SELECT	741
+
+struct Mock_Counters
+{
+	uint64_t isr_timer1;		// TIMER1_COMPA_vect calls
+	uint64_t isr_int0;			// INT0 handler calls
+	uint64_t isr_pcint;			// PCINT1_vect and PCINT2_vect calls
+	uint64_t isr_adc;			// ADC_vect calls
+	uint64_t isr_twi;			// TWI_vect calls
+	uint64_t adc_conversions;	// analogRead() calls and completed ADC conversions
+	uint64_t lcd_commands;		// HD44780 instruction writes
+	uint64_t lcd_data;			// HD44780 data writes
+	uint64_t lcd_busy_us;		// HD44780 execution time of the above
+	uint64_t i2c_transactions;	// START ... STOP sequences
+	uint64_t i2c_bytes;			// address and data bytes on the bus
+	uint64_t i2c_busy_us;		// bus time of the above
+	uint64_t i2c_eeprom_pages;	// AT24C32 page write cycles
+	uint64_t serial_tx;			// bytes written to Serial
+	uint64_t serial_stall_us;	// time Serial.write() blocked on a full buffer
+	uint64_t eeprom_writes;		// EEPROM cells programmed
+	uint64_t sleep_idle_us;		// time spent in SLEEP_MODE_IDLE
+	uint64_t sleep_deep_us;		// time spent in SLEEP_MODE_PWR_DOWN
+};
+
+extern Mock_Counters mock_count;
+void mock_reset_counters(void);
+
+// Virtual time.
+uint64_t mock_cycles(void);
+void mock_advance_cycles(uint64_t cycles);
+void mock_advance_us(uint64_t us);
+// Calls fn(arg) once wall time reaches the given cycle, also during sleep.
+void mock_at(uint64_t cycles, void (*fn)(void *), void *arg);
+
+// Inputs.
+void mock_set_adc(uint8_t pin, uint16_t value);
+void mock_serial_input(const char *s);
+void mock_serial_echo(bool on);
+// A spurious low pulse on INT0, as noise on the INT/SQW line of the DS3231 would make.
+void mock_int0_glitch(void);
+// Drives a digital input (Arduino pin number) from outside, flags its pin change interrupt.
+void mock_set_pin(uint8_t pin, bool high);
+
+// A slave holds SDA low, until SCL has been pulsed clocks times with the TWI off.
+void mock_i2c_stuck(uint8_t clocks);
+
+// DS3231 model.
+void mock_rtc_set(time_t t);
+time_t mock_rtc_time(void);
+// All 19 registers with the time brought up to date, and back: the battery backed state.
+void mock_rtc_save(uint8_t *regs);
+void mock_rtc_load(const uint8_t *regs);
+
+// AT24C32 model, direct access to its memory.
+void mock_at24_read(uint16_t addr, uint8_t *data, uint16_t n);
+void mock_at24_write(uint16_t addr, const uint8_t *data, uint16_t n);
+
+// Lift model, end switches on A1 (open) and A2 (closed). A travel time of 0 removes
+// the lift, the switches then stay open.
+void mock_lift(uint32_t travel_ms, uint8_t open_percent);
+uint8_t mock_lift_position(void);	// 0 closed to 100 open
+// Calls fn each time the moving door reaches an end, 0 removes it.
+void mock_lift_on_end(void (*fn)(bool open));
+
+// Used by the mock itself.
+void mock_rtc_tick(void);
+uint64_t mock_rtc_cycles_to_event(void);
+bool mock_rtc_int_asserted(void);
+void mock_int0_update(void);
+void mock_pin_change_rx(void);
+bool mock_sleeping_deep(void);
+void mock_lift_step(void);
+uint64_t mock_lift_cycles_to_event(void);
+void mock_twi_control(void);
+bool mock_twi_interrupt(void);
+uint64_t mock_twi_cycles_to_event(void);
+void mock_twi_step(uint64_t cycles);
+
+#endif
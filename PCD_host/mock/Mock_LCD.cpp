@@ -0,0 +1,146 @@
+/*
+ * Mock_LCD.cpp
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	HD44780 in 4 bit mode as driven by the Arduino LiquidCrystal library.
+ *	Every instruction and data byte is counted together with the time the
+ *	library spends on it: two nibbles with a 100 us settle delay each, and
+ *	another 2 ms after clear and home.
+ */
+
+#include <LiquidCrystal.h>
+
+#include "Mock_HW.h"
+
+#define LCD_CLEARDISPLAY	0x01
+#define LCD_RETURNHOME		0x02
+#define LCD_DISPLAYCONTROL	0x08
+#define LCD_SETDDRAMADDR	0x80
+
+#define LCD_DISPLAYON		0x04
+#define LCD_CURSORON		0x02
+#define LCD_BLINKON			0x01
+
+#define LCD_BYTE_US			204
+
+LiquidCrystal::LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3)
+	: addr(0), displayControl(LCD_DISPLAYON), cols(16), rows(2)
+{
+	(void)rs; (void)enable; (void)d0; (void)d1; (void)d2; (void)d3;
+	memset(ddram, ' ', sizeof(ddram));
+}
+
+void LiquidCrystal::begin(uint8_t cols, uint8_t rows)
+{
+	this->cols = cols;
+	this->rows = rows;
+	displayControl = LCD_DISPLAYON;
+	clear();
+}
+
+void LiquidCrystal::send(uint8_t value, bool data)
+{
+	if (data)
+	{
+		mock_count.lcd_data++;
+		mock_count.lcd_busy_us += LCD_BYTE_US;
+		ddram[addr & 0x7F] = value;
+		addr = (addr & 0x40) | ((addr + 1) & 0x3F);
+		return;
+	}
+
+	mock_count.lcd_commands++;
+	if (value == LCD_CLEARDISPLAY)
+	{
+		mock_count.lcd_busy_us += LCD_BYTE_US + 2000;
+		memset(ddram, ' ', sizeof(ddram));
+		addr = 0;
+	}
+	else if (value == LCD_RETURNHOME)
+	{
+		mock_count.lcd_busy_us += LCD_BYTE_US + 2000;
+		addr = 0;
+	}
+	else if (value & LCD_SETDDRAMADDR)
+	{
+		mock_count.lcd_busy_us += LCD_BYTE_US;
+		addr = value & 0x7F;
+	}
+	else if ((value & 0xF8) == LCD_DISPLAYCONTROL)
+	{
+		mock_count.lcd_busy_us += LCD_BYTE_US;
+		displayControl = value & 0x07;
+	}
+	else
+	{
+		mock_count.lcd_busy_us += LCD_BYTE_US;
+	}
+}
+
+void LiquidCrystal::command(uint8_t value)
+{
+	send(value, false);
+}
+
+size_t LiquidCrystal::write(uint8_t value)
+{
+	send(value, true);
+	return 1;
+}
+
+void LiquidCrystal::clear(void)
+{
+	command(LCD_CLEARDISPLAY);
+}
+
+void LiquidCrystal::home(void)
+{
+	command(LCD_RETURNHOME);
+}
+
+void LiquidCrystal::noDisplay(void)
+{
+	command(LCD_DISPLAYCONTROL | (displayControl & ~LCD_DISPLAYON));
+}
+
+void LiquidCrystal::display(void)
+{
+	command(LCD_DISPLAYCONTROL | displayControl | LCD_DISPLAYON);
+}
+
+void LiquidCrystal::noBlink(void)
+{
+	command(LCD_DISPLAYCONTROL | (displayControl & ~LCD_BLINKON));
+}
+
+void LiquidCrystal::blink(void)
+{
+	command(LCD_DISPLAYCONTROL | displayControl | LCD_BLINKON);
+}
+
+void LiquidCrystal::noCursor(void)
+{
+	command(LCD_DISPLAYCONTROL | (displayControl & ~LCD_CURSORON));
+}
+
+void LiquidCrystal::cursor(void)
+{
+	command(LCD_DISPLAYCONTROL | displayControl | LCD_CURSORON);
+}
+
+void LiquidCrystal::setCursor(uint8_t col, uint8_t row)
+{
+	static const uint8_t row_offsets[] = { 0x00, 0x40, 0x14, 0x54 };
+	if (row >= rows)
+	{
+		row = rows - 1;
+	}
+	command(LCD_SETDDRAMADDR | (col + row_offsets[row]));
+}
+
+char LiquidCrystal::charAt(uint8_t col, uint8_t row) const
+{
+	return ddram[((row ? 0x40 : 0x00) + col) & 0x7F];
+}
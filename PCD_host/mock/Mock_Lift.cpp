@@ -0,0 +1,109 @@
+/*
+ * Mock_Lift.cpp
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	The AC lift behind the relay board, with its two end switches. The
+ *	relays are active low on PD4-PD7: PD4 and PD7 pull the cable in (open),
+ *	PD5 and PD6 let it out (close). The door moves at a constant speed
+ *	while one pair is on and stops at either end, where its switch closes
+ *	to ground: A1 (PC1) when fully open, A2 (PC2) when fully closed.
+ *
+ *	Virtual time never steps past the moment the door reaches an end, so
+ *	the pin change is seen exactly when it happens.
+ */
+
+#include <Arduino.h>
+
+#include "Mock_HW.h"
+
+#define LIFT_OPEN_PIN	(A0 + 1)
+#define LIFT_CLOSED_PIN	(A0 + 2)
+#define LIFT_UP			((1 << 4) | (1 << 7))
+#define LIFT_DOWN		((1 << 5) | (1 << 6))
+
+static uint64_t lift_travel;	// cycles from closed to open, 0 if there is no lift
+static uint64_t lift_pos;		// cycles from closed
+static uint64_t lift_last;		// mock_cycles() of the last update
+static void (*lift_end)(bool open);
+
+// +1 opening, -1 closing, 0 standing. Both pairs on would short the motor, the lift does not move.
+static int lift_motion(void)
+{
+	uint8_t on = DDRD & ~PORTD;
+	bool up = (on & LIFT_UP) == LIFT_UP;
+	bool down = (on & LIFT_DOWN) == LIFT_DOWN;
+
+	if (!lift_travel || up == down)
+	{
+		return 0;
+	}
+	if (up)
+	{
+		return (lift_pos < lift_travel) ? 1 : 0;
+	}
+	return lift_pos ? -1 : 0;
+}
+
+static void lift_switches(void)
+{
+	mock_set_pin(LIFT_OPEN_PIN, !(lift_travel && lift_pos == lift_travel));
+	mock_set_pin(LIFT_CLOSED_PIN, !(lift_travel && lift_pos == 0));
+}
+
+void mock_lift(uint32_t travel_ms, uint8_t open_percent)
+{
+	lift_travel = (uint64_t)travel_ms * (MOCK_F_CPU / 1000UL);
+	lift_pos = lift_travel * (open_percent > 100 ? 100 : open_percent) / 100;
+	lift_last = mock_cycles();
+	lift_switches();
+}
+
+uint8_t mock_lift_position(void)
+{
+	mock_lift_step();
+	return lift_travel ? (uint8_t)(lift_pos * 100 / lift_travel) : 0;
+}
+
+void mock_lift_step(void)
+{
+	uint64_t now = mock_cycles();
+	uint64_t elapsed = now - lift_last;
+	int motion = lift_motion();
+
+	lift_last = now;
+	if (!motion)
+	{
+		return;
+	}
+	if (motion > 0)
+	{
+		lift_pos = (lift_travel - lift_pos > elapsed) ? lift_pos + elapsed : lift_travel;
+	}
+	else
+	{
+		lift_pos = (lift_pos > elapsed) ? lift_pos - elapsed : 0;
+	}
+	lift_switches();
+	if (lift_end && (lift_pos == 0 || lift_pos == lift_travel))
+	{
+		lift_end(lift_pos != 0);
+	}
+}
+
+void mock_lift_on_end(void (*fn)(bool open))
+{
+	lift_end = fn;
+}
+
+uint64_t mock_lift_cycles_to_event(void)
+{
+	int motion = lift_motion();
+
+	if (!motion)
+	{
+		return UINT64_MAX;
+	}
+	return (motion > 0) ? lift_travel - lift_pos : lift_pos;
+}
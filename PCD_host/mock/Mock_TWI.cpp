@@ -0,0 +1,610 @@
+/*
+ * Mock_TWI.cpp
+ * Created:		17/10-2026
+ * Version:		1.1
+ *
+ * Description:
+ *	TWI of the ATmega328P and the I2C devices on the bus of the PCD controller.
+ *	The TWI is modelled at register level: START, STOP, address and data
+ *	bytes each take their SCL periods of I/O clock (16 + 2 TWBR 4^TWPS
+ *	cycles) and then set TWINT with the status code in TWSR, which raises
+ *	TWI_vect when TWIE is set. Writing one to TWINT starts the next
+ *	operation from TWSTA, TWSTO, TWEA and TWDR.
+ *
+ *	The DS3231 is modelled at register level: BCD time keeping, both
+ *	alarms with all mask modes, the A1F/A2F flags and the INT/SQW output
+ *	that drives INT0. The square wave output itself is not modelled,
+ *	INT/SQW is simply high while INTCN is cleared. The time registers are
+ *	computed when they are read, and virtual time only stops in the seconds
+ *	an alarm matches in, so a day of power-down costs a few steps.
+ *
+ *	The AT24C32 of the same module is modelled with its 32 byte pages:
+ *	a write wraps within its page, and the chip does not acknowledge its
+ *	address during the 5 ms write cycle that follows the STOP.
+ *
+ *	mock_i2c_stuck() makes a slave hold SDA low, as one that lost a clock
+ *	in the middle of a byte does: no operation of the TWI ends until SCL
+ *	has been pulsed often enough on the port pin with the TWI disabled.
+ */
+
+#include <Arduino.h>
+#include <TimeLib.h>
+#include <util/twi.h>
+
+#include "Mock_HW.h"
+
+#define DS3231_ADDR		0x68
+#define AT24C32_ADDR	0x57	// A0-A2 pulled up on the ZS-042 module
+
+#define AT_SIZE			4096
+#define AT_PAGE			32
+#define AT_WRITE_CYCLES	(MOCK_F_CPU / 200)	// 5 ms
+
+// DS3231 register map
+#define DS_SECONDS		0x00
+#define DS_ALM1_SECONDS	0x07
+#define DS_ALM2_MINUTES	0x0B
+#define DS_CONTROL		0x0E
+#define DS_STATUS		0x0F
+#define DS_NREGS		0x13
+
+#define DS_A1IE			0
+#define DS_A2IE			1
+#define DS_INTCN		2
+#define DS_A1F			0
+#define DS_A2F			1
+#define DS_OSF			7
+
+
+/*** DS3231 model ***/
+
+static uint8_t ds_reg[DS_NREGS] = {
+	0x00, 0x00, 0x00, 0x05, 0x01, 0x01, 0x00,	// 00:00:00 Saturday 1 January 2000
+	0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00,
+	0x1C, 0x88, 0x00, 0x19, 0x00
+};
+static uint8_t ds_pointer;
+
+// The time registers are only brought up to date when they are read: the oscillator
+// counts from ds_base, set at ds_base_cycles, and only the seconds an alarm matches
+// in are visited.
+static time_t ds_base = 946684800UL;		// 00:00:00 1 January 2000
+static uint64_t ds_base_cycles;
+static uint64_t ds_next = MOCK_F_CPU;		// mock_cycles() of the next alarm match or recheck
+
+static uint8_t bcd2dec(uint8_t n)
+{
+	return n - 6 * (n >> 4);
+}
+
+static uint8_t dec2bcd(uint8_t n)
+{
+	return n + 6 * (n / 10);
+}
+
+static time_t ds_now(void)
+{
+	return ds_base + (time_t)((mock_cycles() - ds_base_cycles) / MOCK_F_CPU);
+}
+
+static time_t ds_time(void)
+{
+	tmElements_t tm;
+	tm.Second = bcd2dec(ds_reg[0] & 0x7F);
+	tm.Minute = bcd2dec(ds_reg[1]);
+	tm.Hour = bcd2dec(ds_reg[2] & 0x3F);
+	tm.Wday = ds_reg[3];
+	tm.Day = bcd2dec(ds_reg[4]);
+	tm.Month = bcd2dec(ds_reg[5] & 0x1F);
+	tm.Year = y2kYearToTm(bcd2dec(ds_reg[6]));
+	return makeTime(tm);
+}
+
+static void ds_regs(time_t t)
+{
+	tmElements_t tm;
+	breakTime(t, tm);
+	ds_reg[0] = dec2bcd(tm.Second);
+	ds_reg[1] = dec2bcd(tm.Minute);
+	ds_reg[2] = dec2bcd(tm.Hour);
+	ds_reg[3] = tm.Wday;
+	ds_reg[4] = dec2bcd(tm.Day);
+	ds_reg[5] = dec2bcd(tm.Month);
+	ds_reg[6] = dec2bcd(tmYearToY2k(tm.Year));
+}
+
+// Compares one alarm register with the current time, honouring its mask bit.
+static bool ds_match(uint8_t alarm, uint8_t now)
+{
+	return (alarm & 0x80) || ((alarm & 0x7F) == now);
+}
+
+static bool ds_match_day(uint8_t alarm, const tmElements_t &tm)
+{
+	if (alarm & 0x80)
+	{
+		return true;
+	}
+	if (alarm & 0x40)
+	{
+		return (alarm & 0x0F) == tm.Wday;				// day of week
+	}
+	return (alarm & 0x3F) == dec2bcd(tm.Day);			// date
+}
+
+// First second from t on in which the alarm at reg matches, or end if there is none
+// before it. ALARM_2 has no seconds register and matches at second 0.
+static time_t ds_alarm_next(uint8_t reg, time_t t, time_t end)
+{
+	bool seconds = (reg == DS_ALM1_SECONDS);
+	const uint8_t *a = &ds_reg[seconds ? reg + 1 : reg];	// minutes, hours, day/date
+
+	while (t < end)
+	{
+		tmElements_t tm;
+		breakTime(t, tm);
+		if (!ds_match(a[1], dec2bcd(tm.Hour)) || !ds_match_day(a[2], tm))
+		{
+			t += 3600 - 60 * tm.Minute - tm.Second;
+		}
+		else if (!ds_match(a[0], dec2bcd(tm.Minute)))
+		{
+			t += 60 - tm.Second;
+		}
+		else if (seconds ? ds_match(ds_reg[reg], dec2bcd(tm.Second)) : !tm.Second)
+		{
+			return t;
+		}
+		else
+		{
+			t += seconds ? 1 : 60 - tm.Second;
+		}
+	}
+	return end;
+}
+
+// Looks up to a year ahead. A date that never comes (31 February) is rechecked then.
+static void ds_schedule(void)
+{
+	time_t from = ds_now() + 1;
+	time_t end = from + 366 * SECS_PER_DAY;
+	time_t a1 = ds_alarm_next(DS_ALM1_SECONDS, from, end);
+	time_t next = ds_alarm_next(DS_ALM2_MINUTES, from, a1);
+
+	ds_next = ds_base_cycles + (uint64_t)(next - ds_base) * MOCK_F_CPU;
+}
+
+static void ds_set_time(time_t t)
+{
+	// Writing the time restarts the countdown chain, the next second is a full second away.
+	ds_base = t;
+	ds_base_cycles = mock_cycles();
+	ds_regs(t);
+	ds_schedule();
+}
+
+bool mock_rtc_int_asserted(void)
+{
+	uint8_t ctrl = ds_reg[DS_CONTROL];
+	uint8_t stat = ds_reg[DS_STATUS];
+
+	if (!(ctrl & (1 << DS_INTCN)))
+	{
+		return false;
+	}
+	return ((stat & (1 << DS_A1F)) && (ctrl & (1 << DS_A1IE))) ||
+		((stat & (1 << DS_A2F)) && (ctrl & (1 << DS_A2IE)));
+}
+
+uint64_t mock_rtc_cycles_to_event(void)
+{
+	return ds_next - mock_cycles();
+}
+
+void mock_rtc_tick(void)
+{
+	time_t t = ds_now();
+
+	if (ds_alarm_next(DS_ALM1_SECONDS, t, t + 1) == t)
+	{
+		ds_reg[DS_STATUS] |= (1 << DS_A1F);
+	}
+	if (ds_alarm_next(DS_ALM2_MINUTES, t, t + 1) == t)
+	{
+		ds_reg[DS_STATUS] |= (1 << DS_A2F);
+	}
+	ds_schedule();
+	mock_int0_update();
+}
+
+void mock_rtc_set(time_t t)
+{
+	ds_set_time(t);
+	mock_int0_update();
+}
+
+time_t mock_rtc_time(void)
+{
+	return ds_now();
+}
+
+void mock_rtc_save(uint8_t *regs)
+{
+	ds_regs(ds_now());
+	memcpy(regs, ds_reg, DS_NREGS);
+}
+
+void mock_rtc_load(const uint8_t *regs)
+{
+	memcpy(ds_reg, regs, DS_NREGS);
+	ds_set_time(ds_time());
+	mock_int0_update();
+}
+
+static void ds_write(const uint8_t *data, uint8_t n)
+{
+	if (!n)
+	{
+		return;
+	}
+	ds_pointer = data[0];
+	ds_regs(ds_now());
+	bool timeWritten = false;
+	for (uint8_t i = 1; i < n; i++)
+	{
+		if (ds_pointer <= 0x06)
+		{
+			timeWritten = true;
+		}
+		if (ds_pointer == DS_STATUS)
+		{
+			// Alarm flags can only be cleared, OSF likewise.
+			uint8_t keep = ds_reg[DS_STATUS] & data[i];
+			ds_reg[DS_STATUS] = (data[i] & 0x08) | (keep & 0x83);
+		}
+		else if (ds_pointer < DS_NREGS)
+		{
+			ds_reg[ds_pointer] = data[i];
+		}
+		ds_pointer = (ds_pointer + 1) % DS_NREGS;
+	}
+	if (timeWritten)
+	{
+		ds_set_time(ds_time());
+	}
+	else
+	{
+		ds_schedule();
+	}
+	mock_int0_update();
+}
+
+// The DS3231 copies the time into its read buffer at the START of a read.
+static void ds_latch(void)
+{
+	ds_regs(ds_now());
+}
+
+static uint8_t ds_read(void)
+{
+	uint8_t data = ds_reg[ds_pointer];
+	ds_pointer = (ds_pointer + 1) % DS_NREGS;
+	return data;
+}
+
+
+/*** AT24C32 model ***/
+
+static uint8_t at_mem[AT_SIZE];
+static bool at_erased;
+static uint16_t at_pointer;
+static uint64_t at_busy_until;
+
+static void at_init(void)
+{
+	if (!at_erased)
+	{
+		memset(at_mem, 0xFF, sizeof(at_mem));
+		at_erased = true;
+	}
+}
+
+static bool at_ready(void)
+{
+	return mock_cycles() >= at_busy_until;
+}
+
+// A write of the address alone only sets the pointer, data starts the write cycle at STOP.
+static void at_write(const uint8_t *data, uint8_t n)
+{
+	at_init();
+	if (n >= 2)
+	{
+		at_pointer = ((data[0] << 8) | data[1]) & (AT_SIZE - 1);
+	}
+	if (n > 2)
+	{
+		for (uint8_t i = 2; i < n; i++)
+		{
+			at_mem[at_pointer] = data[i];
+			at_pointer = (at_pointer & ~(AT_PAGE - 1)) | ((at_pointer + 1) & (AT_PAGE - 1));
+		}
+		at_busy_until = mock_cycles() + AT_WRITE_CYCLES;
+		mock_count.i2c_eeprom_pages++;
+	}
+}
+
+static uint8_t at_read(void)
+{
+	at_init();
+	uint8_t data = at_mem[at_pointer];
+	at_pointer = (at_pointer + 1) & (AT_SIZE - 1);
+	return data;
+}
+
+void mock_at24_read(uint16_t addr, uint8_t *data, uint16_t n)
+{
+	at_init();
+	for (uint16_t i = 0; i < n; i++)
+	{
+		data[i] = at_mem[(addr + i) & (AT_SIZE - 1)];
+	}
+}
+
+void mock_at24_write(uint16_t addr, const uint8_t *data, uint16_t n)
+{
+	at_init();
+	for (uint16_t i = 0; i < n; i++)
+	{
+		at_mem[(addr + i) & (AT_SIZE - 1)] = data[i];
+	}
+}
+
+
+
+
+/*** TWI ***/
+
+// Bus operations of the TWI.
+#define OP_NONE			0
+#define OP_START		1
+#define OP_WRITE		2
+#define OP_READ			3
+#define OP_STOP			4
+
+#define TWI_SDA			PINC4
+#define TWI_SCL			PC5
+
+volatile uint8_t TWBR, TWSR = TW_NO_INFO, TWAR = 0xFE, TWDR = 0xFF, TWCR, TWAMR;
+
+static bool twi_flag;			// TWINT
+static uint8_t twi_op;			// Operation on the bus, OP_NONE if idle
+static uint8_t twi_then;		// OP_START when a START waits for the STOP before it
+static uint64_t twi_left;		// I/O cycles until twi_op ends, UINT64_MAX while SDA is held low
+static uint8_t twi_data;		// Byte being sent
+static bool twi_ack;			// TWEA of the byte being received
+static bool twi_owner;			// Between our START and STOP
+static bool twi_address;		// The next byte sent is the address
+static uint8_t twi_slave;		// Slave that acknowledged its address, 0 if none
+static bool twi_receiver;		// SLA+R was sent
+static uint8_t twi_buf[64];		// Written to the slave since its address, taken at STOP or repeated START
+static uint8_t twi_length;
+static uint8_t twi_stuck;		// SCL pulses until the slave releases SDA, 0 if it does not hold it
+static bool twi_scl_low;		// SCL driven low by the port, when last seen
+static uint64_t twi_cycles;		// Bus time not yet counted in i2c_busy_us
+
+static uint64_t twi_period(void)
+{
+	return 16 + 2 * (uint64_t)TWBR * (1 << (2 * (TWSR & ((1 << TWPS1) | (1 << TWPS0)))));
+}
+
+// The slave takes what was written to it. The AT24C32 only starts its write cycle on a STOP.
+static void twi_deliver(bool stop)
+{
+	if (twi_slave == DS3231_ADDR && !twi_receiver)
+	{
+		ds_write(twi_buf, twi_length);
+	}
+	else if (twi_slave == AT24C32_ADDR && !twi_receiver && (stop || twi_length <= 2))
+	{
+		at_write(twi_buf, twi_length);
+	}
+	twi_length = 0;
+	twi_slave = 0;
+}
+
+static void twi_begin(uint8_t op)
+{
+	twi_op = op;
+	twi_data = TWDR;
+	twi_ack = TWCR & (1 << TWEA);
+	twi_left = ((op == OP_WRITE) || (op == OP_READ)) ? 9 * twi_period() : twi_period();
+	if (twi_stuck)
+	{
+		twi_left = UINT64_MAX;
+	}
+}
+
+static void twi_complete(void)
+{
+	uint8_t op = twi_op;
+	uint8_t status = TW_NO_INFO;
+	bool ack;
+
+	twi_op = OP_NONE;
+	switch (op)
+	{
+		case OP_START:
+			if (!twi_owner)
+			{
+				mock_count.i2c_transactions++;
+			}
+			status = twi_owner ? TW_REP_START : TW_START;
+			twi_deliver(false);
+			twi_owner = true;
+			twi_address = true;
+			break;
+
+		case OP_WRITE:
+			mock_count.i2c_bytes++;
+			if (twi_address)
+			{
+				uint8_t addr = twi_data >> 1;
+
+				twi_address = false;
+				twi_receiver = twi_data & TW_READ;
+				ack = (addr == DS3231_ADDR) || ((addr == AT24C32_ADDR) && at_ready());
+				twi_slave = ack ? addr : 0;
+				if (ack && twi_receiver && (addr == DS3231_ADDR))
+				{
+					ds_latch();
+				}
+				status = twi_receiver ? (ack ? TW_MR_SLA_ACK : TW_MR_SLA_NACK) : (ack ? TW_MT_SLA_ACK : TW_MT_SLA_NACK);
+				break;
+			}
+			ack = twi_slave && !twi_receiver;
+			if (ack && twi_length < sizeof(twi_buf))
+			{
+				twi_buf[twi_length++] = twi_data;
+			}
+			status = ack ? TW_MT_DATA_ACK : TW_MT_DATA_NACK;
+			break;
+
+		case OP_READ:
+			mock_count.i2c_bytes++;
+			TWDR = (twi_slave == DS3231_ADDR) ? ds_read() : ((twi_slave == AT24C32_ADDR) ? at_read() : 0xFF);
+			status = twi_ack ? TW_MR_DATA_ACK : TW_MR_DATA_NACK;
+			break;
+
+		case OP_STOP:
+			// No TWINT after a STOP, TWSTO clears itself.
+			twi_deliver(true);
+			twi_owner = false;
+			TWCR &= ~(1 << TWSTO);
+			if (twi_then == OP_START)
+			{
+				twi_then = OP_NONE;
+				twi_begin(OP_START);
+			}
+			return;
+	}
+	TWSR = (TWSR & ((1 << TWPS1) | (1 << TWPS0))) | status;
+	twi_flag = true;
+}
+
+// Bus released without a STOP when the TWI is disabled. The DS3231 has taken the bytes
+// it acknowledged, the AT24C32 drops the page.
+static void twi_release(void)
+{
+	if (twi_slave == AT24C32_ADDR)
+	{
+		twi_length = 0;
+	}
+	twi_deliver(false);
+	twi_op = OP_NONE;
+	twi_then = OP_NONE;
+	twi_owner = false;
+	twi_flag = false;
+}
+
+void mock_twi_control(void)
+{
+	bool scl_low = DDRC & (1 << TWI_SCL);
+
+	if (!(TWCR & (1 << TWEN)))
+	{
+		if (twi_owner || twi_op)
+		{
+			twi_release();
+		}
+		twi_flag = false;
+		// SCL clocked by hand, each rising edge shifts out one bit the slave holds.
+		if (twi_scl_low && !scl_low && twi_stuck && !--twi_stuck)
+		{
+			PINC |= (1 << TWI_SDA);
+		}
+		twi_scl_low = scl_low;
+		TWCR &= ~(1 << TWINT);
+		return;
+	}
+	twi_scl_low = scl_low;
+
+	if (!(TWCR & (1 << TWINT)))
+	{
+		return;
+	}
+	TWCR &= ~(1 << TWINT);
+	twi_flag = false;
+	if (twi_op)
+	{
+		// Only a START may wait, for the STOP being sent.
+		if ((twi_op == OP_STOP) && (TWCR & (1 << TWSTA)))
+		{
+			twi_then = OP_START;
+		}
+		return;
+	}
+	if (TWCR & (1 << TWSTO))
+	{
+		if (twi_owner)
+		{
+			twi_then = (TWCR & (1 << TWSTA)) ? OP_START : OP_NONE;
+			twi_begin(OP_STOP);
+			return;
+		}
+		TWCR &= ~(1 << TWSTO);
+	}
+	if (TWCR & (1 << TWSTA))
+	{
+		twi_begin(OP_START);
+	}
+	else if (twi_owner)
+	{
+		twi_begin((twi_receiver && !twi_address) ? OP_READ : OP_WRITE);
+	}
+}
+
+bool mock_twi_interrupt(void)
+{
+	return twi_flag && (TWCR & (1 << TWEN)) && (TWCR & (1 << TWIE));
+}
+
+uint64_t mock_twi_cycles_to_event(void)
+{
+	return twi_op ? twi_left : UINT64_MAX;
+}
+
+void mock_twi_step(uint64_t cycles)
+{
+	if (!twi_op)
+	{
+		return;
+	}
+	twi_cycles += cycles;
+	mock_count.i2c_busy_us += twi_cycles / (MOCK_F_CPU / 1000000UL);
+	twi_cycles %= MOCK_F_CPU / 1000000UL;
+	if (twi_left == UINT64_MAX)
+	{
+		return;
+	}
+	twi_left -= cycles;
+	if (!twi_left)
+	{
+		twi_complete();
+	}
+}
+
+void mock_i2c_stuck(uint8_t clocks)
+{
+	if (!clocks)
+	{
+		return;
+	}
+	twi_stuck = clocks;
+	PINC &= ~(1 << TWI_SDA);
+	if (twi_op)
+	{
+		twi_left = UINT64_MAX;
+	}
+}
@@ -0,0 +1,175 @@
+/*
+ * Mock_Time.cpp
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Calendar functions of the Arduino Time library. The system clock is
+ *	driven by millis() like on the target.
+ */
+
+#include <TimeLib.h>
+
+static const uint8_t monthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+static const char *const monthNames[] = { "", "January", "February", "March", "April", "May", "June",
+	"July", "August", "September", "October", "November", "December" };
+static const char *const dayNames[] = { "", "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday",
+	"Friday", "Saturday" };
+
+static time_t sysTime;
+static unsigned long prevMillis;
+static uint32_t lastDay = 0xFFFFFFFFUL;	// Day since 1970 of lastDate
+static tmElements_t lastDate;
+
+#define LEAP_YEAR(Y)	(((1970 + (Y)) > 0) && !((1970 + (Y)) % 4) && (((1970 + (Y)) % 100) || !((1970 + (Y)) % 400)))
+
+void breakTime(time_t timeInput, tmElements_t &tm)
+{
+	uint8_t year;
+	uint8_t month, monthLength;
+	uint32_t time = (uint32_t)timeInput;
+	unsigned long days;
+
+	tm.Second = time % 60;
+	time /= 60;
+	tm.Minute = time % 60;
+	time /= 60;
+	tm.Hour = time % 24;
+	time /= 24;
+	tm.Wday = ((time + 4) % 7) + 1;
+
+	// The simulations break times of the same day over and over, the date is only counted out for a new one.
+	if (time == lastDay)
+	{
+		tm.Year = lastDate.Year;
+		tm.Month = lastDate.Month;
+		tm.Day = lastDate.Day;
+		return;
+	}
+	lastDay = time;
+
+	year = 0;
+	days = 0;
+	while ((unsigned)(days += (LEAP_YEAR(year) ? 366 : 365)) <= time)
+	{
+		year++;
+	}
+	tm.Year = year;
+
+	days -= LEAP_YEAR(year) ? 366 : 365;
+	time -= days;
+
+	for (month = 0; month < 12; month++)
+	{
+		monthLength = (month == 1 && LEAP_YEAR(year)) ? 29 : monthDays[month];
+		if (time >= monthLength)
+		{
+			time -= monthLength;
+		}
+		else
+		{
+			break;
+		}
+	}
+	tm.Month = month + 1;
+	tm.Day = time + 1;
+	lastDate = tm;
+}
+
+time_t makeTime(const tmElements_t &tm)
+{
+	uint32_t seconds;
+
+	seconds = tm.Year * (SECS_PER_DAY * 365);
+	for (int i = 0; i < tm.Year; i++)
+	{
+		if (LEAP_YEAR(i))
+		{
+			seconds += SECS_PER_DAY;
+		}
+	}
+	for (int i = 1; i < tm.Month; i++)
+	{
+		if ((i == 2) && LEAP_YEAR(tm.Year))
+		{
+			seconds += SECS_PER_DAY * 29;
+		}
+		else
+		{
+			seconds += SECS_PER_DAY * monthDays[i - 1];
+		}
+	}
+	seconds += (tm.Day - 1) * SECS_PER_DAY;
+	seconds += tm.Hour * SECS_PER_HOUR;
+	seconds += tm.Minute * SECS_PER_MIN;
+	seconds += tm.Second;
+	return (time_t)seconds;
+}
+
+static int field(time_t t, int which)
+{
+	tmElements_t tm;
+	breakTime(t, tm);
+	switch (which)
+	{
+		case 0:		return tm.Hour;
+		case 1:		return tm.Minute;
+		case 2:		return tm.Second;
+		case 3:		return tm.Day;
+		case 4:		return tm.Wday;
+		case 5:		return tm.Month;
+		default:	return tmYearToCalendar(tm.Year);
+	}
+}
+
+int hour(time_t t)		{ return field(t, 0); }
+int minute(time_t t)	{ return field(t, 1); }
+int second(time_t t)	{ return field(t, 2); }
+int day(time_t t)		{ return field(t, 3); }
+int weekday(time_t t)	{ return field(t, 4); }
+int month(time_t t)		{ return field(t, 5); }
+int year(time_t t)		{ return field(t, 6); }
+
+time_t now(void)
+{
+	while (millis() - prevMillis >= 1000)
+	{
+		sysTime++;
+		prevMillis += 1000;
+	}
+	return sysTime;
+}
+
+void setTime(time_t t)
+{
+	sysTime = (uint32_t)t;
+	prevMillis = millis();
+}
+
+static char buffer[12];
+
+char *monthStr(uint8_t month)
+{
+	strncpy(buffer, monthNames[month % 13], sizeof(buffer) - 1);
+	return buffer;
+}
+
+char *monthShortStr(uint8_t month)
+{
+	strncpy(buffer, monthNames[month % 13], 3);
+	buffer[3] = '\0';
+	return buffer;
+}
+
+char *dayStr(uint8_t day)
+{
+	strncpy(buffer, dayNames[day % 8], sizeof(buffer) - 1);
+	return buffer;
+}
+
+char *dayShortStr(uint8_t day)
+{
+	strncpy(buffer, dayNames[day % 8], 3);
+	buffer[3] = '\0';
+	return buffer;
+}
@@ -0,0 +1,36 @@
+#ifndef Mock_Streaming
+#define Mock_Streaming
+/*
+ * Streaming.h (host mock)
+ *
+ * Description:
+ *	Same operators as Mikal Hart's Streaming library.
+ */
+
+#include <Arduino.h>
+
+template <class T>
+inline Print &operator <<(Print &obj, T arg)
+{ obj.print(arg); return obj; }
+
+struct _BASED
+{
+	long val;
+	int base;
+	_BASED(long v, int b): val(v), base(b) {}
+};
+
+#define _HEX(a)		_BASED(a, HEX)
+#define _DEC(a)		_BASED(a, DEC)
+#define _OCT(a)		_BASED(a, OCT)
+#define _BIN(a)		_BASED(a, BIN)
+
+inline Print &operator <<(Print &obj, const _BASED &arg)
+{ obj.print(arg.val, arg.base); return obj; }
+
+enum _EndLineCode { endl };
+
+inline Print &operator <<(Print &obj, _EndLineCode arg)
+{ (void)arg; obj.println(); return obj; }
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef Mock_TimeLib
+#define Mock_TimeLib
+/*
+ * TimeLib.h (host mock)
+ *
+ * Description:
+ *	The subset of the Arduino Time library used by PCD_main, with the same
+ *	names and semantics (years in tmElements_t are offsets from 1970).
+ */
+
+#include <Arduino.h>
+#include <time.h>
+
+typedef struct {
+	uint8_t Second;
+	uint8_t Minute;
+	uint8_t Hour;
+	uint8_t Wday;	// day of week, sunday is day 1
+	uint8_t Day;
+	uint8_t Month;
+	uint8_t Year;	// offset from 1970;
+} tmElements_t, TimeElements, *tmElementsPtr_t;
+
+#define tmYearToCalendar(Y)	((Y) + 1970)
+#define CalendarYrToTm(Y)	((Y) - 1970)
+#define tmYearToY2k(Y)		((Y) - 30)
+#define y2kYearToTm(Y)		((Y) + 30)
+
+#define SECS_PER_MIN	((time_t)(60UL))
+#define SECS_PER_HOUR	((time_t)(3600UL))
+#define SECS_PER_DAY	((time_t)(SECS_PER_HOUR * 24UL))
+#define SECS_PER_WEEK	((time_t)(SECS_PER_DAY * 7UL))
+#define DAYS_PER_WEEK	((time_t)(7UL))
+
+#define numberOfSeconds(_time_)		((_time_) % SECS_PER_MIN)
+#define numberOfMinutes(_time_)		(((_time_) / SECS_PER_MIN) % SECS_PER_MIN)
+#define numberOfHours(_time_)		(((_time_) % SECS_PER_DAY) / SECS_PER_HOUR)
+#define dayOfWeek(_time_)			((((_time_) / SECS_PER_DAY + 4) % DAYS_PER_WEEK) + 1)
+#define elapsedDays(_time_)			((_time_) / SECS_PER_DAY)
+#define elapsedSecsToday(_time_)	((_time_) % SECS_PER_DAY)
+#define previousMidnight(_time_)	(((_time_) / SECS_PER_DAY) * SECS_PER_DAY)
+
+int hour(time_t t);
+int minute(time_t t);
+int second(time_t t);
+int day(time_t t);
+int weekday(time_t t);
+int month(time_t t);
+int year(time_t t);
+
+time_t now(void);
+void setTime(time_t t);
+
+char *monthStr(uint8_t month);
+char *monthShortStr(uint8_t month);
+char *dayStr(uint8_t day);
+char *dayShortStr(uint8_t day);
+
+void breakTime(time_t time, tmElements_t &tm);
+time_t makeTime(const tmElements_t &tm);
+
+#endif
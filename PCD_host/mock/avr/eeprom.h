@@ -0,0 +1,22 @@
+#ifndef Mock_avr_eeprom
+#define Mock_avr_eeprom
+/*
+ * avr/eeprom.h (host mock)
+ *
+ * Description:
+ *	1 KB EEPROM of the ATmega328P kept in host memory. Erased cells read 0xFF.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define E2END	0x3FF
+
+uint8_t eeprom_read_byte(const uint8_t *addr);
+uint16_t eeprom_read_word(const uint16_t *addr);
+void eeprom_write_byte(uint8_t *addr, uint8_t value);
+void eeprom_update_byte(uint8_t *addr, uint8_t value);
+void eeprom_read_block(void *dst, const void *src, size_t n);
+void eeprom_update_block(const void *src, void *dst, size_t n);
+
+#endif
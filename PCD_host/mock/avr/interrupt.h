@@ -0,0 +1,20 @@
+#ifndef Mock_avr_interrupt
+#define Mock_avr_interrupt
+/*
+ * avr/interrupt.h (host mock)
+ *
+ * Description:
+ *	ISR() declares an ordinary C function named after the vector, which
+ *	the mocked interrupt sources in Mock_Core.cpp call directly.
+ */
+
+#include <avr/io.h>
+
+#define ISR(vector, ...)	extern "C" void vector(void); extern "C" void vector(void)
+
+#define EMPTY_INTERRUPT(vector)	extern "C" void vector(void); extern "C" void vector(void) {}
+
+#define sei()	(SREG |= (1 << SREG_I))
+#define cli()	(SREG &= ~(1 << SREG_I))
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef Mock_avr_io
+#define Mock_avr_io
+/*
+ * avr/io.h (host mock)
+ *
+ * Description:
+ *	The ATmega328P registers used by PCD_main, as plain variables.
+ *	Register and bit names follow the datasheet so the firmware compiles
+ *	unchanged. Mock_HW.h reads these to decide which interrupts to raise.
+ */
+
+#include <stdint.h>
+
+// Status register
+extern volatile uint8_t SREG;
+#define SREG_I		7
+
+// MCU control and sleep mode
+extern volatile uint8_t MCUCR, SMCR;
+
+#define SE		0
+#define SM0		1
+#define SM1		2
+#define SM2		3
+#define BODSE	5
+#define BODS	6
+
+// Port B, C and D
+extern volatile uint8_t PINB, DDRB, PORTB;
+extern volatile uint8_t PINC, DDRC, PORTC;
+extern volatile uint8_t PIND, DDRD, PORTD;
+
+#define DDD0	0
+#define DDD1	1
+#define DDD2	2
+#define DDD3	3
+#define DDD4	4
+#define DDD5	5
+#define DDD6	6
+#define DDD7	7
+
+#define PORTD0	0
+#define PORTD1	1
+#define PORTD2	2
+#define PORTD3	3
+#define PORTD4	4
+#define PORTD5	5
+#define PORTD6	6
+#define PORTD7	7
+
+#define PD0		0
+#define PD1		1
+#define PD2		2
+#define PD3		3
+#define PD4		4
+#define PD5		5
+#define PD6		6
+#define PD7		7
+
+#define PC0		0
+#define PC1		1
+#define PC2		2
+#define PC3		3
+#define PC4		4
+#define PC5		5
+
+#define PINC0	0
+#define PINC1	1
+#define PINC2	2
+#define PINC3	3
+#define PINC4	4
+#define PINC5	5
+
+#define PIND0	0
+#define PIND1	1
+#define PIND2	2
+#define PIND3	3
+
+// External interrupts
+extern volatile uint8_t EICRA, EIMSK, EIFR;
+
+#define ISC00	0
+#define ISC01	1
+#define ISC10	2
+#define ISC11	3
+#define INT0	0
+#define INT1	1
+#define INTF0	0
+#define INTF1	1
+
+// Pin change interrupts
+extern volatile uint8_t PCICR, PCIFR, PCMSK0, PCMSK1, PCMSK2;
+
+#define PCIE0	0
+#define PCIE1	1
+#define PCIE2	2
+#define PCIF0	0
+#define PCIF1	1
+#define PCIF2	2
+#define PCINT8	0
+#define PCINT9	1
+#define PCINT10	2
+#define PCINT11	3
+#define PCINT16	0
+
+// Timer2, only registers: the PWM output is not modelled
+extern volatile uint8_t TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2;
+
+#define WGM20	0
+#define WGM21	1
+#define COM2B0	4
+#define COM2B1	5
+#define COM2A0	6
+#define COM2A1	7
+#define CS20	0
+#define CS21	1
+#define CS22	2
+
+// ADC
+extern volatile uint8_t ADMUX, ADCSRA, ADCSRB, DIDR0;
+extern volatile uint16_t ADC;
+#define ADCW	ADC
+
+#define MUX0	0
+#define MUX1	1
+#define MUX2	2
+#define MUX3	3
+#define ADLAR	5
+#define REFS0	6
+#define REFS1	7
+#define ADTS0	0
+#define ADTS1	1
+#define ADTS2	2
+#define ADC0D	0
+
+#define ADPS0	0
+#define ADPS1	1
+#define ADPS2	2
+#define ADIE	3
+#define ADIF	4
+#define ADATE	5
+#define ADSC	6
+#define ADEN	7
+
+// Timer/Counter1
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+extern volatile uint16_t TCNT1, OCR1A, OCR1B;
+
+#define WGM10	0
+#define WGM11	1
+#define WGM12	3
+#define WGM13	4
+#define CS10	0
+#define CS11	1
+#define CS12	2
+#define TOIE1	0
+#define OCIE1A	1
+#define OCIE1B	2
+#define TOV1	0
+#define OCF1A	1
+#define OCF1B	2
+
+// TWI. TWINT is kept by the mock: it reads as 0, writing one clears the flag and starts
+// the next bus operation, like on the target.
+extern volatile uint8_t TWBR, TWSR, TWAR, TWDR, TWCR, TWAMR;
+
+#define TWIE	0
+#define TWEN	2
+#define TWWC	3
+#define TWSTO	4
+#define TWSTA	5
+#define TWEA	6
+#define TWINT	7
+#define TWPS0	0
+#define TWPS1	1
+
+#endif
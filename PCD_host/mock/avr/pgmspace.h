@@ -0,0 +1,24 @@
+#ifndef Mock_avr_pgmspace
+#define Mock_avr_pgmspace
+/*
+ * avr/pgmspace.h (host mock)
+ *
+ * Description:
+ *	The host has a single address space, so flash data is ordinary const data.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s)						(s)
+#define pgm_read_byte(addr)			(*(const uint8_t *)(addr))
+#define pgm_read_word(addr)			(*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)		(*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr)			(*(void * const *)(addr))
+#define memcpy_P					memcpy
+#define strcmp_P					strcmp
+#define strncmp_P					strncmp
+#define strlen_P					strlen
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef Mock_avr_sleep
+#define Mock_avr_sleep
+/*
+ * avr/sleep.h (host mock)
+ *
+ * Description:
+ *	Sleep modes of avr-libc. sleep_cpu() is implemented in Mock_Core.cpp
+ *	and advances virtual time until an enabled interrupt would wake the MCU.
+ */
+
+#include <avr/io.h>
+
+#define SLEEP_MODE_IDLE			(0)
+#define SLEEP_MODE_ADC			(1 << SM0)
+#define SLEEP_MODE_PWR_DOWN		(1 << SM1)
+#define SLEEP_MODE_PWR_SAVE		((1 << SM0) | (1 << SM1))
+#define SLEEP_MODE_STANDBY		((1 << SM1) | (1 << SM2))
+
+#define set_sleep_mode(mode)	(SMCR = (SMCR & ~((1 << SM0) | (1 << SM1) | (1 << SM2))) | (mode))
+#define sleep_enable()			(SMCR |= (1 << SE))
+#define sleep_disable()			(SMCR &= ~(1 << SE))
+#define sleep_bod_disable()		(MCUCR |= (1 << BODS))
+
+void sleep_cpu(void);
+
+#define sleep_mode()	do { sleep_enable(); sleep_cpu(); sleep_disable(); } while (0)
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef Mock_util_crc16
+#define Mock_util_crc16
+/*
+ * util/crc16.h (host mock)
+ *
+ * Description:
+ *	The CRC helpers of avr-libc used by PCD_main, with the same results.
+ */
+
+#include <stdint.h>
+
+// CRC-16 with polynomial x^16 + x^15 + x^2 + 1 (0xA001 reflected), initial value 0xFFFF for Modbus.
+static inline uint16_t _crc16_update(uint16_t crc, uint8_t a)
+{
+	crc ^= a;
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+	}
+	return crc;
+}
+
+// CRC-8 with polynomial x^8 + x^2 + x + 1 (0x07), as used by ATM HEC and SMBus.
+static inline uint8_t _crc8_ccitt_update(uint8_t crc, uint8_t data)
+{
+	crc ^= data;
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+	}
+	return crc;
+}
+
+#endif
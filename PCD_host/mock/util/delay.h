@@ -0,0 +1,16 @@
+#ifndef Mock_util_delay
+#define Mock_util_delay
+/*
+ * util/delay.h (host mock)
+ *
+ * Description:
+ *	Busy waits advance virtual time like delay() does.
+ */
+
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#define _delay_ms(ms)	delay(ms)
+#define _delay_us(us)	delayMicroseconds(us)
+
+#endif
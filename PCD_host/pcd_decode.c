@@ -0,0 +1,260 @@
+/*
+ * pcd_decode.c
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Decodes the binary telemetry of PCD_main (console command "binary 1")
+ *	from a serial port, a capture file or stdin. Frames are
+ *	0xA5, type, length, payload, CRC8 (poly 0x07) over type, length and
+ *	payload; everything else is console text and passed through in log
+ *	mode. A frame with a bad length or CRC is dropped and the decoder
+ *	resyncs on the next 0xA5.
+ *
+ *	Usage: pcd_decode [-c] [-b baud] [file|tty]
+ *		-c	CSV output (time,record,value1..value4), text is left out
+ *		-b	baud rate when reading a tty, default 9600
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TELsync			0xA5
+#define TELmaxPayload	16
+#define TELtime			0x01
+#define TELalarm		0x02
+#define TELrelay		0x03
+#define TELcounters		0x04
+
+enum { WAIT_SYNC, WAIT_TYPE, WAIT_LENGTH, WAIT_PAYLOAD, WAIT_CRC };
+
+static int csv;
+static unsigned long frames, errors;
+
+static uint8_t crc8_update(uint8_t crc, uint8_t data)
+{
+	int i;
+
+	crc ^= data;
+	for (i = 0; i < 8; i++)
+	{
+		crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+	}
+	return crc;
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static int speed(long baud, speed_t *s)
+{
+	static const struct { long baud; speed_t s; } table[] = {
+		{ 1200, B1200 }, { 2400, B2400 }, { 4800, B4800 }, { 9600, B9600 },
+		{ 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 }, { 115200, B115200 }
+	};
+	size_t i;
+
+	for (i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+	{
+		if (table[i].baud == baud)
+		{
+			*s = table[i].s;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+static int open_input(const char *path, long baud)
+{
+	struct termios tio;
+	speed_t s;
+	int fd;
+
+	if (!path || !strcmp(path, "-"))
+	{
+		return STDIN_FILENO;
+	}
+	fd = open(path, O_RDONLY | O_NOCTTY);
+	if (fd < 0)
+	{
+		fprintf(stderr, "pcd_decode: %s: %s\n", path, strerror(errno));
+		exit(1);
+	}
+	if (isatty(fd))
+	{
+		if (speed(baud, &s) || tcgetattr(fd, &tio))
+		{
+			fprintf(stderr, "pcd_decode: %s: cannot set %ld baud\n", path, baud);
+			exit(1);
+		}
+		cfmakeraw(&tio);
+		cfsetispeed(&tio, s);
+		cfsetospeed(&tio, s);
+		tio.c_cc[VMIN] = 1;
+		tio.c_cc[VTIME] = 0;
+		tcsetattr(fd, TCSANOW, &tio);
+	}
+	return fd;
+}
+
+static void record(uint8_t type, const uint8_t *p, uint8_t length)
+{
+	static const char *lift[] = { "stop", "cw", "ccw" };
+	time_t t = get32(p);
+	char when[24];
+
+	strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", gmtime(&t));
+	frames++;
+
+	switch (type)
+	{
+		case TELtime:
+			printf(csv ? "%s,time\n" : "%s  time set\n", when);
+		break;
+
+		case TELalarm:
+			if (length < 5) goto bad;
+			printf(csv ? "%s,alarm,%u\n" : "%s  alarm %u\n", when, p[4]);
+		break;
+
+		case TELrelay:
+			if (length < 5) goto bad;
+			if (csv)
+			{
+				printf("%s,relay,%u\n", when, p[4]);
+			}
+			else
+			{
+				printf("%s  lift %s\n", when, p[4] < 3 ? lift[p[4]] : "?");
+			}
+		break;
+
+		case TELcounters:
+			if (length < 12) goto bad;
+			printf(csv ? "%s,counters,%u,%u,%u,%u\n"
+				: "%s  wake-ups %u, lift runs %u, alarms %u, clock syncs %u\n",
+				when, get16(p + 4), get16(p + 6), get16(p + 8), get16(p + 10));
+		break;
+
+		default:
+		bad:
+			printf(csv ? "%s,unknown%u\n" : "%s  unknown record 0x%02X\n", when, type);
+		break;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t buf[256], payload[TELmaxPayload];
+	uint8_t type = 0, length = 0, got = 0, crc = 0;
+	long baud = 9600;
+	int state = WAIT_SYNC;
+	int opt, fd;
+	ssize_t n, i;
+
+	while ((opt = getopt(argc, argv, "cb:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'c':
+				csv = 1;
+			break;
+
+			case 'b':
+				baud = strtol(optarg, NULL, 10);
+			break;
+
+			default:
+				fprintf(stderr, "usage: pcd_decode [-c] [-b baud] [file|tty]\n");
+				return 2;
+		}
+	}
+	fd = open_input(optind < argc ? argv[optind] : NULL, baud);
+	if (csv)
+	{
+		printf("time,record,value1,value2,value3,value4\n");
+	}
+
+	while ((n = read(fd, buf, sizeof(buf))) > 0)
+	{
+		for (i = 0; i < n; i++)
+		{
+			uint8_t c = buf[i];
+
+			switch (state)
+			{
+				case WAIT_SYNC:
+					if (c == TELsync)
+					{
+						state = WAIT_TYPE;
+					}
+					else if (!csv)
+					{
+						putchar(c);
+					}
+				break;
+
+				case WAIT_TYPE:
+					type = c;
+					crc = crc8_update(0, c);
+					state = WAIT_LENGTH;
+				break;
+
+				case WAIT_LENGTH:
+					length = c;
+					crc = crc8_update(crc, c);
+					got = 0;
+					if (length < 4 || length > TELmaxPayload)
+					{
+						errors++;
+						state = (c == TELsync) ? WAIT_TYPE : WAIT_SYNC;
+					}
+					else
+					{
+						state = WAIT_PAYLOAD;
+					}
+				break;
+
+				case WAIT_PAYLOAD:
+					payload[got++] = c;
+					crc = crc8_update(crc, c);
+					if (got == length)
+					{
+						state = WAIT_CRC;
+					}
+				break;
+
+				case WAIT_CRC:
+					if (c == crc)
+					{
+						record(type, payload, length);
+					}
+					else
+					{
+						errors++;
+					}
+					state = WAIT_SYNC;
+				break;
+			}
+		}
+		fflush(stdout);
+	}
+
+	fprintf(stderr, "pcd_decode: %lu frames, %lu dropped\n", frames, errors);
+	return 0;
+}
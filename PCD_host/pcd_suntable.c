@@ -0,0 +1,100 @@
+/*
+ * pcd_suntable.c
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Generates PCD_main/Sun_Table.h, the sunrise and sunset table that
+ *	Solar_Schedule::sunLookup reads in the table mode. The times are
+ *	computed in double precision with the NOAA approximation that
+ *	Solar_Schedule::sunCompute implements in fixed point, for day 1 to 366
+ *	of the year, as minutes after midnight UTC. Each day takes 3 bytes,
+ *	two 12 bit values: sunrise in the low 12 bits, sunset in the high 12.
+ *
+ *	Usage: pcd_suntable latitude longitude > Sun_Table.h
+ *		Degrees, north and east positive, e.g. pcd_suntable 55.68 12.57
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#define M_PI	3.14159265358979323846
+#endif
+
+// Minutes after midnight UTC, wrapped to 0-1439.
+static int minutes(double m)
+{
+	long r = lround(m) % 1440;
+
+	return (r < 0) ? (int)(r + 1440) : (int)r;
+}
+
+static void sun(int day, double latitude, double longitude, int *rise, int *set)
+{
+	double g = 2 * M_PI / 365 * (day - 1);
+	double eqtime = 229.18 * (0.000075 + 0.001868 * cos(g) - 0.032077 * sin(g)
+		- 0.014615 * cos(2 * g) - 0.040849 * sin(2 * g));
+	double decl = 0.006918 - 0.399912 * cos(g) + 0.070257 * sin(g) - 0.006758 * cos(2 * g)
+		+ 0.000907 * sin(2 * g) - 0.002697 * cos(3 * g) + 0.00148 * sin(3 * g);
+	double lat = latitude * M_PI / 180;
+	double c = (cos(90.833 * M_PI / 180) - sin(lat) * sin(decl)) / (cos(lat) * cos(decl));
+	double ha;
+
+	// Midnight sun or polar night, the sun stays up or down all day.
+	if (c > 1)
+	{
+		c = 1;
+	}
+	if (c < -1)
+	{
+		c = -1;
+	}
+	ha = acos(c) * 180 / M_PI;
+
+	*rise = minutes(720 - 4 * (longitude + ha) - eqtime);
+	*set = minutes(720 - 4 * (longitude - ha) - eqtime);
+}
+
+int main(int argc, char *argv[])
+{
+	double latitude, longitude;
+	int day, rise, set;
+
+	if (argc != 3)
+	{
+		fprintf(stderr, "usage: pcd_suntable latitude longitude > Sun_Table.h\n");
+		return 2;
+	}
+	latitude = atof(argv[1]);
+	longitude = atof(argv[2]);
+	if ((fabs(latitude) > 89) || (fabs(longitude) > 180))
+	{
+		fprintf(stderr, "pcd_suntable: latitude or longitude out of range\n");
+		return 2;
+	}
+
+	printf("#ifndef Sun_Table\n");
+	printf("#define Sun_Table\n");
+	printf("/*\n");
+	printf(" * Sun_Table.h\n");
+	printf(" *\n");
+	printf(" * Description:\n");
+	printf(" *\tGenerated by PCD_host/pcd_suntable %.2f %.2f, do not edit.\n", latitude, longitude);
+	printf(" *\tSunrise and sunset of day 1 to 366 in minutes after midnight UTC, 12 bits each.\n");
+	printf(" */\n\n");
+	printf("#define SUNtableLatitude\t%ld\t\t// Hundredths of a degree, north positive\n", lround(latitude * 100));
+	printf("#define SUNtableLongitude\t%ld\t\t// Hundredths of a degree, east positive\n\n", lround(longitude * 100));
+	printf("const uint8_t SUNdays[366][3] PROGMEM = {\n");
+	for (day = 1; day <= 366; day++)
+	{
+		sun(day, latitude, longitude, &rise, &set);
+		printf("%s0x%02X, 0x%02X, 0x%02X }%s", ((day - 1) % 4) ? " { " : "\t{ ",
+			rise & 0xFF, (rise >> 8) | ((set & 0x0F) << 4), set >> 4,
+			(day == 366) ? "\n" : ((day % 4) ? "," : ",\n"));
+	}
+	printf("};\n\n");
+	printf("#endif\n");
+	return 0;
+}
@@ -0,0 +1,667 @@
+/*
+ * PCD_simbench.c
+ * Created:		17/10-2026
+ * Version:		1.0
+ *
+ * Description:
+ *	Runs the compiled firmware (the .elf the Arduino builder produces)
+ *	under simavr and measures the cycle cost of the interrupt handlers and
+ *	of every loop() pass, split by the UI state the pass started in.
+ *
+ *	A scripted session drives the keypad through every UI state via the
+ *	ADC input, types the console command sun (both sunrise backends),
+ *	fires both DS3231 alarms on INT0, and closes the end switch of the lift
+ *	3 s after each run starts. Small models of the DS3231 and of the AT24C32
+ *	on its module answer on the TWI bus, the latter with the write cycle
+ *	during which it does not acknowledge, so the journal runs as on the board.
+ *
+ *	A probe starts when the PC reaches the first instruction of its
+ *	function and stops when the stack pointer rises above the value it had
+ *	there, i.e. after the matching ret/reti. Interrupts that land inside a
+ *	probed function are counted as part of it, which is the latency the
+ *	rest of the firmware actually sees. Probes name their function as it
+ *	reads demangled, without the parameters, so a changed signature or a
+ *	clone the compiler made (e.g. .constprop) is still found. Functions the
+ *	compiler inlined have no symbol and are reported as such. The flash
+ *	column is the size of the function, plus the tables named in its probe.
+ *
+ *	The simulation is deterministic, so two runs of the same .elf print the
+ *	same report and two builds can be compared with diff.
+ *
+ *	Usage: pcd_simbench PCD_main.ino.elf
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <libelf.h>
+#include <gelf.h>
+
+// From the C++ runtime, linked with -lstdc++.
+extern char *__cxa_demangle(const char *mangled, char *buffer, size_t *length, int *status);
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_irq.h"
+#include "avr_ioport.h"
+#include "avr_adc.h"
+#include "avr_twi.h"
+#include "avr_uart.h"
+
+#define F_CPU			16000000UL
+#define MS(x)			((avr_cycle_count_t)(x) * (F_CPU / 1000UL))
+#define SRAM_OFFSET		0x800000UL
+
+#define DS3231_ADDR		(0x68 << 1)
+#define AT24C32_ADDR	(0x57 << 1)
+#define AT24C32_SIZE	4096
+#define AT24C32_PAGE	32
+#define AT24C32_TWR		MS(5)	// Write cycle, the address is not acknowledged meanwhile
+
+// Keypad ladder in mV (10 bit ADC value * 5000 / 1023)
+#define KEY_NONE		5000
+#define KEY_RIGHT		0
+#define KEY_UP			704
+#define KEY_DOWN		1608
+#define KEY_LEFT		2463
+#define KEY_SELECT		3622
+
+#define MAX_UISTATE		32
+
+
+/*** Probes ***/
+
+typedef struct
+{
+	const char *label;
+	const char *symbol;	// Demangled name without the parameters
+	const char *table;	// PROGMEM object counted in the flash of the function, or NULL
+	uint32_t addr;		// byte address in flash, 0 if not found
+	uint32_t size;		// bytes of flash of the function and its table
+	int active;
+	uint16_t sp;
+	avr_cycle_count_t start;
+	uint64_t count;
+	uint64_t total;
+	uint64_t min;
+	uint64_t max;
+} probe_t;
+
+static probe_t probes[] = {
+	{ "ISR(TIMER1_COMPA_vect)",		"__vector_11" },
+	{ "INT0 vector",				"__vector_1" },
+	{ "ISR(PCINT1_vect)",			"__vector_4" },
+	{ "alarmIsr()",					"alarmIsr" },
+	{ "ISR(ADC_vect)",				"__vector_21" },
+	{ "ISR(TWI_vect)",				"__vector_24" },
+	{ "alarm_Check()",				"DS3231RTC_Alarms::alarm_Check" },
+	{ "UIupdate()",					"Human_Machine_Interface::UIupdate" },
+	{ "relayArrayCommand()",		"liftRelayArray::relayArrayCommand" },
+	{ "relayAutoCommand()",			"liftRelayArray::relayAutoCommand" },
+	{ "relayStart()",				"liftRelayArray::relayStart" },
+	{ "relayRamp()",				"liftRelayArray::relayRamp" },
+	{ "sunCompute()",				"Solar_Schedule::sunCompute",	"SUNsin" },
+	{ "sunLookup()",				"Solar_Schedule::sunLookup",	"SUNdays" },
+	{ "loop()",						"loop" },
+};
+#define NPROBES		(sizeof(probes) / sizeof(probes[0]))
+#define PROBE_LOOP	(NPROBES - 1)
+
+// loop() passes split by the UI state they started in.
+static probe_t loopByState[MAX_UISTATE];
+static uint32_t hmiAddr;		// SRAM address of HMI, UIstate is its first member
+static uint8_t loopState;
+
+static void probe_record(probe_t *p, uint64_t cycles)
+{
+	if (!p->count || cycles < p->min)
+	{
+		p->min = cycles;
+	}
+	if (cycles > p->max)
+	{
+		p->max = cycles;
+	}
+	p->count++;
+	p->total += cycles;
+}
+
+static void probes_step(avr_t *avr)
+{
+	uint16_t sp = avr->data[R_SPL] | (avr->data[R_SPH] << 8);
+
+	for (unsigned i = 0; i < NPROBES; i++)
+	{
+		probe_t *p = &probes[i];
+		if (!p->addr)
+		{
+			continue;
+		}
+		if (!p->active)
+		{
+			if (avr->pc == p->addr)
+			{
+				p->active = 1;
+				p->sp = sp;
+				p->start = avr->cycle;
+				if (i == PROBE_LOOP && hmiAddr)
+				{
+					loopState = avr->data[hmiAddr] % MAX_UISTATE;
+				}
+			}
+		}
+		else if (sp > p->sp)
+		{
+			uint64_t cycles = avr->cycle - p->start;
+			probe_record(p, cycles);
+			if (i == PROBE_LOOP)
+			{
+				probe_record(&loopByState[loopState], cycles);
+			}
+			p->active = 0;
+		}
+	}
+}
+
+
+/*** ELF symbols and sizes ***/
+
+static uint32_t secText, secData, secBss;
+
+// True if the symbol, demangled, is the function name followed by its parameters,
+// a clone suffix or nothing.
+static int symbol_is(const char *sname, const char *name)
+{
+	int status;
+	char *demangled = __cxa_demangle(sname, NULL, NULL, &status);
+	const char *s = (demangled && !status) ? demangled : sname;
+	size_t n = strlen(name);
+	int match = !strncmp(s, name, n) && (s[n] == '(' || s[n] == '.' || s[n] == '\0');
+	free(demangled);
+	return match;
+}
+
+static int elf_scan(const char *path)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0 || elf_version(EV_CURRENT) == EV_NONE)
+	{
+		return -1;
+	}
+	Elf *elf = elf_begin(fd, ELF_C_READ, NULL);
+	size_t shstrndx;
+	if (!elf || elf_getshdrstrndx(elf, &shstrndx))
+	{
+		close(fd);
+		return -1;
+	}
+
+	Elf_Scn *scn = NULL;
+	while ((scn = elf_nextscn(elf, scn)) != NULL)
+	{
+		GElf_Shdr shdr;
+		gelf_getshdr(scn, &shdr);
+		const char *name = elf_strptr(elf, shstrndx, shdr.sh_name);
+
+		// Same accounting as avr-size: flash = .text + .data, RAM = .data + .bss + .noinit
+		if (!strcmp(name, ".text"))
+		{
+			secText = shdr.sh_size;
+		}
+		else if (!strcmp(name, ".data"))
+		{
+			secData = shdr.sh_size;
+		}
+		else if (!strcmp(name, ".bss") || !strcmp(name, ".noinit"))
+		{
+			secBss += shdr.sh_size;
+		}
+
+		if (shdr.sh_type != SHT_SYMTAB)
+		{
+			continue;
+		}
+		Elf_Data *data = elf_getdata(scn, NULL);
+		for (size_t i = 0; i < shdr.sh_size / shdr.sh_entsize; i++)
+		{
+			GElf_Sym sym;
+			gelf_getsym(data, i, &sym);
+			const char *sname = elf_strptr(elf, shdr.sh_link, sym.st_name);
+			if (!sname)
+			{
+				continue;
+			}
+			for (unsigned p = 0; p < NPROBES; p++)
+			{
+				if (GELF_ST_TYPE(sym.st_info) == STT_FUNC && symbol_is(sname, probes[p].symbol))
+				{
+					if (probes[p].addr)
+					{
+						fprintf(stderr, "%s: more than one symbol, %s is not probed\n", probes[p].label, sname);
+						continue;
+					}
+					probes[p].addr = sym.st_value;
+					probes[p].size += sym.st_size;
+				}
+				if (GELF_ST_TYPE(sym.st_info) == STT_OBJECT && probes[p].table && !strcmp(sname, probes[p].table))
+				{
+					probes[p].size += sym.st_size;
+				}
+			}
+			if (!strcmp(sname, "HMI"))
+			{
+				hmiAddr = sym.st_value - SRAM_OFFSET;
+			}
+		}
+	}
+	elf_end(elf);
+	close(fd);
+	return 0;
+}
+
+
+/*** DS3231 on the TWI bus ***/
+
+typedef struct
+{
+	avr_irq_t *irq;
+	uint8_t reg[0x13];
+	uint8_t pointer;
+	uint8_t selected;
+	uint8_t first;		// next written byte is the register pointer
+} ds3231_t;
+
+static ds3231_t rtc;
+static avr_t *avr;
+static avr_irq_t *int0Pin;
+
+static uint8_t dec2bcd(uint8_t n)
+{
+	return n + 6 * (n / 10);
+}
+
+// The clock starts at 05:59:50 and runs from the simulated cycle count.
+static void ds3231_update_time(void)
+{
+	uint32_t s = 6 * 3600UL - 10 + avr->cycle / F_CPU;
+	rtc.reg[0] = dec2bcd(s % 60);
+	rtc.reg[1] = dec2bcd((s / 60) % 60);
+	rtc.reg[2] = dec2bcd((s / 3600) % 24);
+}
+
+static void ds3231_int_update(void)
+{
+	uint8_t asserted = (rtc.reg[0x0E] & 0x04) && (rtc.reg[0x0F] & rtc.reg[0x0E] & 0x03);
+	avr_raise_irq(int0Pin, asserted ? 0 : 1);
+}
+
+static void ds3231_hook(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	avr_twi_msg_irq_t v;
+	v.u.v = value;
+	(void)irq;
+	(void)param;
+
+	if (v.u.twi.msg & TWI_COND_STOP)
+	{
+		rtc.selected = 0;
+		ds3231_int_update();
+	}
+	if (v.u.twi.msg & TWI_COND_START)
+	{
+		rtc.selected = 0;
+		if ((v.u.twi.addr & 0xFE) == DS3231_ADDR)
+		{
+			rtc.selected = v.u.twi.addr;
+			rtc.first = !(v.u.twi.addr & 1);
+			ds3231_update_time();
+			avr_raise_irq(rtc.irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, rtc.selected, 1));
+		}
+	}
+	if (!rtc.selected)
+	{
+		return;
+	}
+	if (v.u.twi.msg & TWI_COND_WRITE)
+	{
+		avr_raise_irq(rtc.irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, rtc.selected, 1));
+		if (rtc.first)
+		{
+			rtc.pointer = v.u.twi.data % sizeof(rtc.reg);
+			rtc.first = 0;
+		}
+		else
+		{
+			if (rtc.pointer == 0x0F)
+			{
+				// Alarm flags can only be cleared.
+				rtc.reg[0x0F] &= v.u.twi.data | ~0x03;
+			}
+			else
+			{
+				rtc.reg[rtc.pointer] = v.u.twi.data;
+			}
+			rtc.pointer = (rtc.pointer + 1) % sizeof(rtc.reg);
+		}
+	}
+	if (v.u.twi.msg & TWI_COND_READ)
+	{
+		uint8_t data = rtc.reg[rtc.pointer];
+		rtc.pointer = (rtc.pointer + 1) % sizeof(rtc.reg);
+		avr_raise_irq(rtc.irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_READ, rtc.selected, data));
+	}
+}
+
+static void ds3231_attach(void)
+{
+	static const char *names[] = { "8>ds3231.out", "32<ds3231.in" };
+	rtc.irq = avr_alloc_irq(&avr->irq_pool, 0, 2, names);
+	avr_irq_register_notify(rtc.irq + TWI_IRQ_OUTPUT, ds3231_hook, NULL);
+	avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), rtc.irq + TWI_IRQ_OUTPUT);
+	avr_connect_irq(rtc.irq + TWI_IRQ_INPUT, avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+
+	rtc.reg[0x03] = 5;		// Friday 5 July 2019
+	rtc.reg[0x04] = 0x05;
+	rtc.reg[0x05] = 0x07;
+	rtc.reg[0x06] = 0x19;
+	rtc.reg[0x0E] = 0x1C;
+}
+
+static void ds3231_fire(uint8_t alarm)
+{
+	rtc.reg[0x0F] |= (alarm == 1) ? 0x01 : 0x02;
+	ds3231_int_update();
+}
+
+
+/*** AT24C32 on the TWI bus ***/
+
+typedef struct
+{
+	avr_irq_t *irq;
+	uint8_t mem[AT24C32_SIZE];
+	uint16_t pointer;
+	uint8_t selected;
+	uint8_t addrBytes;	// address bytes still expected after the write address
+	uint8_t written;	// data bytes came in, the write cycle starts at the stop
+	avr_cycle_count_t busy;	// cycle the write cycle ends
+	uint32_t pageWrites;
+	uint32_t bytesWritten;
+	uint32_t bytesRead;
+	uint32_t nacks;		// addresses not acknowledged during a write cycle
+} at24c32_t;
+
+static at24c32_t eeprom;
+
+static void at24c32_hook(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+	avr_twi_msg_irq_t v;
+	v.u.v = value;
+	(void)irq;
+	(void)param;
+
+	if (v.u.twi.msg & TWI_COND_STOP)
+	{
+		if (eeprom.written)
+		{
+			eeprom.busy = avr->cycle + AT24C32_TWR;
+			eeprom.pageWrites++;
+			eeprom.written = 0;
+		}
+		eeprom.selected = 0;
+	}
+	if (v.u.twi.msg & TWI_COND_START)
+	{
+		eeprom.selected = 0;
+		if ((v.u.twi.addr & 0xFE) == AT24C32_ADDR)
+		{
+			if (avr->cycle < eeprom.busy)
+			{
+				eeprom.nacks++;
+				return;
+			}
+			eeprom.selected = v.u.twi.addr;
+			eeprom.addrBytes = (v.u.twi.addr & 1) ? 0 : 2;
+			avr_raise_irq(eeprom.irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, eeprom.selected, 1));
+		}
+	}
+	if (!eeprom.selected)
+	{
+		return;
+	}
+	if (v.u.twi.msg & TWI_COND_WRITE)
+	{
+		avr_raise_irq(eeprom.irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_ACK, eeprom.selected, 1));
+		if (eeprom.addrBytes)
+		{
+			eeprom.pointer = ((eeprom.pointer << 8) | v.u.twi.data) % AT24C32_SIZE;
+			eeprom.addrBytes--;
+		}
+		else
+		{
+			// The address rolls over within the page.
+			eeprom.mem[eeprom.pointer] = v.u.twi.data;
+			eeprom.pointer = (eeprom.pointer & ~(AT24C32_PAGE - 1)) | ((eeprom.pointer + 1) & (AT24C32_PAGE - 1));
+			eeprom.written = 1;
+			eeprom.bytesWritten++;
+		}
+	}
+	if (v.u.twi.msg & TWI_COND_READ)
+	{
+		uint8_t data = eeprom.mem[eeprom.pointer];
+		eeprom.pointer = (eeprom.pointer + 1) % AT24C32_SIZE;
+		eeprom.bytesRead++;
+		avr_raise_irq(eeprom.irq + TWI_IRQ_INPUT, avr_twi_irq_msg(TWI_COND_READ, eeprom.selected, data));
+	}
+}
+
+// The EEPROM starts erased, the journal finds no page and starts a new one.
+static void at24c32_attach(void)
+{
+	static const char *names[] = { "8>at24c32.out", "32<at24c32.in" };
+	eeprom.irq = avr_alloc_irq(&avr->irq_pool, 0, 2, names);
+	avr_irq_register_notify(eeprom.irq + TWI_IRQ_OUTPUT, at24c32_hook, NULL);
+	avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), eeprom.irq + TWI_IRQ_OUTPUT);
+	avr_connect_irq(eeprom.irq + TWI_IRQ_INPUT, avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+
+	memset(eeprom.mem, 0xFF, sizeof(eeprom.mem));
+}
+
+
+/*** Session script ***/
+
+typedef enum { KEY, ALARM, SERIAL, SWITCH, END } action_t;
+
+// End switches of the lift, closed to ground: A1 (PC1) when open, A2 (PC2) when closed.
+#define DOORopen		1
+#define DOORclosed		2
+
+typedef struct
+{
+	uint32_t ms;		// time since the previous step
+	action_t action;
+	uint32_t arg;		// KEY: ADC value, ALARM: 1 or 2, SWITCH: DOORopen or DOORclosed
+	const char *text;	// SERIAL: line typed into the console
+} step_t;
+
+// Keys are pressed for 50 ms and then released; the keypad debounces them in about 8 ms.
+static const step_t script[] = {
+	{ 5000, KEY, KEY_SELECT },	// 1
+	{ 1000, KEY, KEY_RIGHT },	// 2
+	{ 1000, KEY, KEY_RIGHT },	// 3
+	{ 1000, KEY, KEY_RIGHT },	// 4
+	{ 1000, KEY, KEY_UP },
+	{ 1000, KEY, KEY_LEFT },	// 3
+	{ 1000, KEY, KEY_DOWN },
+	{ 1000, KEY, KEY_LEFT },	// 2
+	{ 1000, KEY, KEY_LEFT },	// 1
+	{ 1000, KEY, KEY_LEFT },	// 0
+	{ 1000, KEY, KEY_RIGHT },	// 10
+	{ 1000, KEY, KEY_SELECT },	// 11
+	{ 1000, KEY, KEY_RIGHT },	// 12
+	{ 1000, KEY, KEY_RIGHT },	// 13
+	{ 1000, KEY, KEY_RIGHT },	// 14
+	{ 1000, KEY, KEY_LEFT },	// 13
+	{ 1000, KEY, KEY_LEFT },	// 12
+	{ 1000, KEY, KEY_LEFT },	// 11
+	{ 1000, KEY, KEY_LEFT },	// 10
+	{ 1000, KEY, KEY_RIGHT },	// 20
+	{ 1000, KEY, KEY_SELECT },	// 21
+	{ 1000, KEY, KEY_RIGHT },	// 22
+	{ 1000, KEY, KEY_RIGHT },	// 23
+	{ 1000, KEY, KEY_RIGHT },	// 24
+	{ 1000, KEY, KEY_LEFT },	// 23
+	{ 1000, KEY, KEY_LEFT },	// 22
+	{ 1000, KEY, KEY_LEFT },	// 21
+	{ 1000, KEY, KEY_LEFT },	// 20
+	{ 1000, KEY, KEY_RIGHT },	// 0
+	{ 1000, SERIAL, 0, "sun\n" },	// both sunrise backends, while the UI is awake
+	{ 2000, ALARM, 1 },			// open, the lift runs until its end switch
+	{ 3000, SWITCH, DOORopen },
+	{ 3000, ALARM, 2 },			// close
+	{ 3000, SWITCH, DOORclosed },
+	{ 3000, END, 0 },
+};
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s PCD_main.ino.elf\n", argv[0]);
+		return 2;
+	}
+
+	elf_firmware_t f;
+	memset(&f, 0, sizeof(f));
+	if (elf_read_firmware(argv[1], &f) || elf_scan(argv[1]))
+	{
+		fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[1]);
+		return 1;
+	}
+	// The Arduino builder does not embed the MCU in the .elf.
+	strcpy(f.mmcu, "atmega328p");
+	f.frequency = F_CPU;
+
+	avr = avr_make_mcu_by_name(f.mmcu);
+	if (!avr)
+	{
+		fprintf(stderr, "%s: simavr has no %s core\n", argv[0], f.mmcu);
+		return 1;
+	}
+	avr_init(avr);
+	avr_load_firmware(avr, &f);
+	avr->avcc = 5000;
+	avr->aref = 5000;
+	avr->log = LOG_NONE;
+
+	int0Pin = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('D'), 2);
+	avr_irq_t *keypad = avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0);
+	avr_irq_t *uart = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+	avr_irq_t *openPin = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('C'), 1);
+	avr_irq_t *closedPin = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('C'), 2);
+	ds3231_attach();
+	at24c32_attach();
+	avr_raise_irq(int0Pin, 1);
+	avr_raise_irq(keypad, KEY_NONE);
+	avr_raise_irq(openPin, 1);		// The door starts closed.
+	avr_raise_irq(closedPin, 0);
+
+	unsigned s = 0;
+	avr_cycle_count_t next = MS(script[0].ms);
+	avr_cycle_count_t release = 0;
+	int state = cpu_Running;
+
+	while (state != cpu_Done && state != cpu_Crashed)
+	{
+		state = avr_run(avr);
+		probes_step(avr);
+
+		if (release && avr->cycle >= release)
+		{
+			avr_raise_irq(keypad, KEY_NONE);
+			release = 0;
+		}
+		if (avr->cycle < next)
+		{
+			continue;
+		}
+		if (script[s].action == END)
+		{
+			break;
+		}
+		if (script[s].action == KEY)
+		{
+			avr_raise_irq(keypad, script[s].arg);
+			release = avr->cycle + MS(50);
+		}
+		else if (script[s].action == SERIAL)
+		{
+			// The UART model queues the bytes and receives them at the baud rate.
+			for (const char *c = script[s].text; *c; c++)
+			{
+				avr_raise_irq(uart, (uint8_t)*c);
+			}
+		}
+		else if (script[s].action == SWITCH)
+		{
+			avr_raise_irq(openPin, script[s].arg != DOORopen);
+			avr_raise_irq(closedPin, script[s].arg != DOORclosed);
+		}
+		else
+		{
+			ds3231_fire(script[s].arg);
+		}
+		s++;
+		next += MS(script[s].ms);
+	}
+	if (state == cpu_Crashed)
+	{
+		fprintf(stderr, "%s: firmware crashed at pc 0x%04x\n", argv[0], avr->pc);
+		return 1;
+	}
+
+	printf("PCD simavr benchmark, %s\n", argv[1]);
+	printf("flash %u B   .data %u B   .bss %u B   (%.2f s simulated)\n\n",
+		secText + secData, secData, secBss, (double)avr->cycle / F_CPU);
+	printf("%-26s %8s %9s %9s %9s %8s %8s\n", "probe", "calls", "min cyc", "avg cyc", "max cyc", "max us", "flash B");
+
+	for (unsigned i = 0; i < NPROBES; i++)
+	{
+		probe_t *p = &probes[i];
+		if (!p->addr)
+		{
+			printf("%-26s %s\n", p->label, "(no symbol, inlined)");
+			continue;
+		}
+		printf("%-26s %8llu %9llu %9llu %9llu %8.1f %8u\n", p->label, (unsigned long long)p->count,
+			(unsigned long long)p->min, (unsigned long long)(p->count ? p->total / p->count : 0),
+			(unsigned long long)p->max, p->max * 1e6 / F_CPU, p->size);
+	}
+	for (unsigned i = 0; i < MAX_UISTATE; i++)
+	{
+		probe_t *p = &loopByState[i];
+		if (!p->count)
+		{
+			continue;
+		}
+		char label[32];
+		snprintf(label, sizeof(label), "loop() in UIstate %u", i);
+		printf("%-26s %8llu %9llu %9llu %9llu %8.1f\n", label, (unsigned long long)p->count,
+			(unsigned long long)p->min, (unsigned long long)(p->total / p->count),
+			(unsigned long long)p->max, p->max * 1e6 / F_CPU);
+	}
+
+	// Share of the simulated time spent in the Timer1 deadline interrupt.
+	probe_t *t1 = &probes[0];
+	if (t1->count)
+	{
+		printf("\nTimer1 ISR load: %.4f %% of all cycles, %llu calls, %llu cycles worst case\n",
+			100.0 * t1->total / avr->cycle, (unsigned long long)t1->count, (unsigned long long)t1->max);
+	}
+	printf("AT24C32: %u page writes, %u bytes written, %u bytes read, %u addresses not acknowledged in a write cycle\n",
+		eeprom.pageWrites, eeprom.bytesWritten, eeprom.bytesRead, eeprom.nacks);
+	return 0;
+}
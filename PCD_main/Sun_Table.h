@@ -0,0 +1,109 @@
+#ifndef Sun_Table
+#define Sun_Table
+/*
+ * Sun_Table.h
+ *
+ * Description:
+ *	Generated by PCD_host/pcd_suntable 55.68 12.57, do not edit.
+ *	Sunrise and sunset of day 1 to 366 in minutes after midnight UTC, 12 bits each.
+ */
+
+#define SUNtableLatitude	5568		// Hundredths of a degree, north positive
+#define SUNtableLongitude	1257		// Hundredths of a degree, east positive
+
+const uint8_t SUNdays[366][3] PROGMEM = {
+	{ 0xCB, 0x61, 0x37 }, { 0xCB, 0x81, 0x37 }, { 0xCA, 0x91, 0x37 }, { 0xCA, 0xA1, 0x37 },
+	{ 0xCA, 0xB1, 0x37 }, { 0xC9, 0xD1, 0x37 }, { 0xC8, 0xE1, 0x37 }, { 0xC8, 0xF1, 0x37 },
+	{ 0xC7, 0x11, 0x38 }, { 0xC6, 0x31, 0x38 }, { 0xC6, 0x41, 0x38 }, { 0xC5, 0x61, 0x38 },
+	{ 0xC4, 0x71, 0x38 }, { 0xC3, 0x91, 0x38 }, { 0xC2, 0xB1, 0x38 }, { 0xC1, 0xD1, 0x38 },
+	{ 0xC0, 0xF1, 0x38 }, { 0xBE, 0x01, 0x39 }, { 0xBD, 0x21, 0x39 }, { 0xBC, 0x41, 0x39 },
+	{ 0xBA, 0x61, 0x39 }, { 0xB9, 0x81, 0x39 }, { 0xB8, 0xA1, 0x39 }, { 0xB6, 0xC1, 0x39 },
+	{ 0xB5, 0xE1, 0x39 }, { 0xB3, 0x01, 0x3A }, { 0xB1, 0x21, 0x3A }, { 0xB0, 0x41, 0x3A },
+	{ 0xAE, 0x71, 0x3A }, { 0xAC, 0x91, 0x3A }, { 0xAB, 0xB1, 0x3A }, { 0xA9, 0xD1, 0x3A },
+	{ 0xA7, 0xF1, 0x3A }, { 0xA5, 0x11, 0x3B }, { 0xA3, 0x31, 0x3B }, { 0xA1, 0x61, 0x3B },
+	{ 0x9F, 0x81, 0x3B }, { 0x9D, 0xA1, 0x3B }, { 0x9B, 0xC1, 0x3B }, { 0x99, 0xE1, 0x3B },
+	{ 0x97, 0x11, 0x3C }, { 0x95, 0x31, 0x3C }, { 0x93, 0x51, 0x3C }, { 0x91, 0x71, 0x3C },
+	{ 0x8F, 0x91, 0x3C }, { 0x8C, 0xC1, 0x3C }, { 0x8A, 0xE1, 0x3C }, { 0x88, 0x01, 0x3D },
+	{ 0x86, 0x21, 0x3D }, { 0x83, 0x41, 0x3D }, { 0x81, 0x71, 0x3D }, { 0x7F, 0x91, 0x3D },
+	{ 0x7C, 0xB1, 0x3D }, { 0x7A, 0xD1, 0x3D }, { 0x77, 0xF1, 0x3D }, { 0x75, 0x11, 0x3E },
+	{ 0x73, 0x41, 0x3E }, { 0x70, 0x61, 0x3E }, { 0x6E, 0x81, 0x3E }, { 0x6B, 0xA1, 0x3E },
+	{ 0x69, 0xC1, 0x3E }, { 0x66, 0xE1, 0x3E }, { 0x64, 0x01, 0x3F }, { 0x61, 0x21, 0x3F },
+	{ 0x5F, 0x41, 0x3F }, { 0x5C, 0x71, 0x3F }, { 0x5A, 0x91, 0x3F }, { 0x57, 0xB1, 0x3F },
+	{ 0x55, 0xD1, 0x3F }, { 0x52, 0xF1, 0x3F }, { 0x4F, 0x11, 0x40 }, { 0x4D, 0x31, 0x40 },
+	{ 0x4A, 0x51, 0x40 }, { 0x48, 0x71, 0x40 }, { 0x45, 0x91, 0x40 }, { 0x43, 0xB1, 0x40 },
+	{ 0x40, 0xD1, 0x40 }, { 0x3D, 0xF1, 0x40 }, { 0x3B, 0x11, 0x41 }, { 0x38, 0x31, 0x41 },
+	{ 0x35, 0x51, 0x41 }, { 0x33, 0x71, 0x41 }, { 0x30, 0x91, 0x41 }, { 0x2E, 0xB1, 0x41 },
+	{ 0x2B, 0xD1, 0x41 }, { 0x28, 0xF1, 0x41 }, { 0x26, 0x11, 0x42 }, { 0x23, 0x31, 0x42 },
+	{ 0x20, 0x51, 0x42 }, { 0x1E, 0x71, 0x42 }, { 0x1B, 0x91, 0x42 }, { 0x19, 0xB1, 0x42 },
+	{ 0x16, 0xD1, 0x42 }, { 0x13, 0xF1, 0x42 }, { 0x11, 0x11, 0x43 }, { 0x0E, 0x31, 0x43 },
+	{ 0x0C, 0x51, 0x43 }, { 0x09, 0x71, 0x43 }, { 0x06, 0x91, 0x43 }, { 0x04, 0xB1, 0x43 },
+	{ 0x01, 0xD1, 0x43 }, { 0xFF, 0xF0, 0x43 }, { 0xFC, 0x10, 0x44 }, { 0xFA, 0x30, 0x44 },
+	{ 0xF7, 0x50, 0x44 }, { 0xF5, 0x70, 0x44 }, { 0xF2, 0x90, 0x44 }, { 0xF0, 0xB0, 0x44 },
+	{ 0xED, 0xD0, 0x44 }, { 0xEB, 0xF0, 0x44 }, { 0xE8, 0x10, 0x45 }, { 0xE6, 0x30, 0x45 },
+	{ 0xE3, 0x50, 0x45 }, { 0xE1, 0x70, 0x45 }, { 0xDF, 0x90, 0x45 }, { 0xDC, 0xB0, 0x45 },
+	{ 0xDA, 0xD0, 0x45 }, { 0xD8, 0xF0, 0x45 }, { 0xD5, 0x10, 0x46 }, { 0xD3, 0x30, 0x46 },
+	{ 0xD1, 0x50, 0x46 }, { 0xCF, 0x70, 0x46 }, { 0xCC, 0x90, 0x46 }, { 0xCA, 0xB0, 0x46 },
+	{ 0xC8, 0xD0, 0x46 }, { 0xC6, 0xF0, 0x46 }, { 0xC4, 0x00, 0x47 }, { 0xC2, 0x20, 0x47 },
+	{ 0xC0, 0x40, 0x47 }, { 0xBE, 0x60, 0x47 }, { 0xBC, 0x80, 0x47 }, { 0xBA, 0xA0, 0x47 },
+	{ 0xB8, 0xC0, 0x47 }, { 0xB6, 0xE0, 0x47 }, { 0xB4, 0x00, 0x48 }, { 0xB2, 0x20, 0x48 },
+	{ 0xB0, 0x30, 0x48 }, { 0xAE, 0x50, 0x48 }, { 0xAD, 0x70, 0x48 }, { 0xAB, 0x90, 0x48 },
+	{ 0xA9, 0xB0, 0x48 }, { 0xA8, 0xC0, 0x48 }, { 0xA6, 0xE0, 0x48 }, { 0xA5, 0x00, 0x49 },
+	{ 0xA3, 0x10, 0x49 }, { 0xA2, 0x30, 0x49 }, { 0xA1, 0x40, 0x49 }, { 0x9F, 0x60, 0x49 },
+	{ 0x9E, 0x80, 0x49 }, { 0x9D, 0x90, 0x49 }, { 0x9C, 0xA0, 0x49 }, { 0x9A, 0xC0, 0x49 },
+	{ 0x99, 0xD0, 0x49 }, { 0x98, 0xF0, 0x49 }, { 0x97, 0x00, 0x4A }, { 0x97, 0x10, 0x4A },
+	{ 0x96, 0x20, 0x4A }, { 0x95, 0x30, 0x4A }, { 0x94, 0x40, 0x4A }, { 0x94, 0x50, 0x4A },
+	{ 0x93, 0x60, 0x4A }, { 0x92, 0x70, 0x4A }, { 0x92, 0x80, 0x4A }, { 0x92, 0x90, 0x4A },
+	{ 0x91, 0xA0, 0x4A }, { 0x91, 0xA0, 0x4A }, { 0x91, 0xB0, 0x4A }, { 0x91, 0xC0, 0x4A },
+	{ 0x91, 0xC0, 0x4A }, { 0x91, 0xD0, 0x4A }, { 0x91, 0xD0, 0x4A }, { 0x91, 0xD0, 0x4A },
+	{ 0x91, 0xE0, 0x4A }, { 0x91, 0xE0, 0x4A }, { 0x92, 0xE0, 0x4A }, { 0x92, 0xE0, 0x4A },
+	{ 0x92, 0xE0, 0x4A }, { 0x93, 0xE0, 0x4A }, { 0x93, 0xE0, 0x4A }, { 0x94, 0xE0, 0x4A },
+	{ 0x95, 0xD0, 0x4A }, { 0x95, 0xD0, 0x4A }, { 0x96, 0xD0, 0x4A }, { 0x97, 0xC0, 0x4A },
+	{ 0x98, 0xC0, 0x4A }, { 0x99, 0xB0, 0x4A }, { 0x9A, 0xA0, 0x4A }, { 0x9B, 0xA0, 0x4A },
+	{ 0x9C, 0x90, 0x4A }, { 0x9D, 0x80, 0x4A }, { 0x9F, 0x70, 0x4A }, { 0xA0, 0x60, 0x4A },
+	{ 0xA1, 0x50, 0x4A }, { 0xA2, 0x40, 0x4A }, { 0xA4, 0x30, 0x4A }, { 0xA5, 0x20, 0x4A },
+	{ 0xA7, 0x10, 0x4A }, { 0xA8, 0xF0, 0x49 }, { 0xAA, 0xE0, 0x49 }, { 0xAB, 0xD0, 0x49 },
+	{ 0xAD, 0xB0, 0x49 }, { 0xAE, 0xA0, 0x49 }, { 0xB0, 0x80, 0x49 }, { 0xB2, 0x70, 0x49 },
+	{ 0xB3, 0x50, 0x49 }, { 0xB5, 0x30, 0x49 }, { 0xB7, 0x20, 0x49 }, { 0xB9, 0x00, 0x49 },
+	{ 0xBA, 0xE0, 0x48 }, { 0xBC, 0xC0, 0x48 }, { 0xBE, 0xB0, 0x48 }, { 0xC0, 0x90, 0x48 },
+	{ 0xC2, 0x70, 0x48 }, { 0xC4, 0x50, 0x48 }, { 0xC5, 0x30, 0x48 }, { 0xC7, 0x10, 0x48 },
+	{ 0xC9, 0xF0, 0x47 }, { 0xCB, 0xD0, 0x47 }, { 0xCD, 0xB0, 0x47 }, { 0xCF, 0x80, 0x47 },
+	{ 0xD1, 0x60, 0x47 }, { 0xD3, 0x40, 0x47 }, { 0xD5, 0x20, 0x47 }, { 0xD7, 0x00, 0x47 },
+	{ 0xD8, 0xD0, 0x46 }, { 0xDA, 0xB0, 0x46 }, { 0xDC, 0x90, 0x46 }, { 0xDE, 0x70, 0x46 },
+	{ 0xE0, 0x40, 0x46 }, { 0xE2, 0x20, 0x46 }, { 0xE4, 0x00, 0x46 }, { 0xE6, 0xD0, 0x45 },
+	{ 0xE8, 0xB0, 0x45 }, { 0xEA, 0x80, 0x45 }, { 0xEC, 0x60, 0x45 }, { 0xEE, 0x30, 0x45 },
+	{ 0xF0, 0x10, 0x45 }, { 0xF1, 0xE0, 0x44 }, { 0xF3, 0xC0, 0x44 }, { 0xF5, 0x90, 0x44 },
+	{ 0xF7, 0x70, 0x44 }, { 0xF9, 0x40, 0x44 }, { 0xFB, 0x20, 0x44 }, { 0xFD, 0xF0, 0x43 },
+	{ 0xFF, 0xD0, 0x43 }, { 0x01, 0xA1, 0x43 }, { 0x03, 0x81, 0x43 }, { 0x05, 0x51, 0x43 },
+	{ 0x06, 0x21, 0x43 }, { 0x08, 0x01, 0x43 }, { 0x0A, 0xD1, 0x42 }, { 0x0C, 0xA1, 0x42 },
+	{ 0x0E, 0x81, 0x42 }, { 0x10, 0x51, 0x42 }, { 0x12, 0x31, 0x42 }, { 0x14, 0x01, 0x42 },
+	{ 0x16, 0xD1, 0x41 }, { 0x17, 0xB1, 0x41 }, { 0x19, 0x81, 0x41 }, { 0x1B, 0x51, 0x41 },
+	{ 0x1D, 0x31, 0x41 }, { 0x1F, 0x01, 0x41 }, { 0x21, 0xD1, 0x40 }, { 0x23, 0xB1, 0x40 },
+	{ 0x25, 0x81, 0x40 }, { 0x27, 0x51, 0x40 }, { 0x29, 0x31, 0x40 }, { 0x2B, 0x01, 0x40 },
+	{ 0x2C, 0xE1, 0x3F }, { 0x2E, 0xB1, 0x3F }, { 0x30, 0x81, 0x3F }, { 0x32, 0x61, 0x3F },
+	{ 0x34, 0x31, 0x3F }, { 0x36, 0x01, 0x3F }, { 0x38, 0xE1, 0x3E }, { 0x3A, 0xB1, 0x3E },
+	{ 0x3C, 0x91, 0x3E }, { 0x3E, 0x61, 0x3E }, { 0x40, 0x31, 0x3E }, { 0x42, 0x11, 0x3E },
+	{ 0x44, 0xE1, 0x3D }, { 0x46, 0xC1, 0x3D }, { 0x48, 0x91, 0x3D }, { 0x4A, 0x71, 0x3D },
+	{ 0x4C, 0x41, 0x3D }, { 0x4E, 0x21, 0x3D }, { 0x50, 0xF1, 0x3C }, { 0x52, 0xD1, 0x3C },
+	{ 0x54, 0xA1, 0x3C }, { 0x56, 0x81, 0x3C }, { 0x58, 0x51, 0x3C }, { 0x5A, 0x31, 0x3C },
+	{ 0x5C, 0x01, 0x3C }, { 0x5E, 0xE1, 0x3B }, { 0x61, 0xC1, 0x3B }, { 0x63, 0x91, 0x3B },
+	{ 0x65, 0x71, 0x3B }, { 0x67, 0x51, 0x3B }, { 0x69, 0x21, 0x3B }, { 0x6B, 0x01, 0x3B },
+	{ 0x6D, 0xE1, 0x3A }, { 0x6F, 0xB1, 0x3A }, { 0x71, 0x91, 0x3A }, { 0x74, 0x71, 0x3A },
+	{ 0x76, 0x51, 0x3A }, { 0x78, 0x31, 0x3A }, { 0x7A, 0x11, 0x3A }, { 0x7C, 0xF1, 0x39 },
+	{ 0x7E, 0xD1, 0x39 }, { 0x80, 0xA1, 0x39 }, { 0x83, 0x81, 0x39 }, { 0x85, 0x71, 0x39 },
+	{ 0x87, 0x51, 0x39 }, { 0x89, 0x31, 0x39 }, { 0x8B, 0x11, 0x39 }, { 0x8D, 0xF1, 0x38 },
+	{ 0x8F, 0xD1, 0x38 }, { 0x91, 0xB1, 0x38 }, { 0x93, 0xA1, 0x38 }, { 0x96, 0x81, 0x38 },
+	{ 0x98, 0x61, 0x38 }, { 0x9A, 0x51, 0x38 }, { 0x9C, 0x31, 0x38 }, { 0x9E, 0x21, 0x38 },
+	{ 0xA0, 0x01, 0x38 }, { 0xA2, 0xF1, 0x37 }, { 0xA3, 0xD1, 0x37 }, { 0xA5, 0xC1, 0x37 },
+	{ 0xA7, 0xB1, 0x37 }, { 0xA9, 0xA1, 0x37 }, { 0xAB, 0x81, 0x37 }, { 0xAD, 0x71, 0x37 },
+	{ 0xAE, 0x61, 0x37 }, { 0xB0, 0x51, 0x37 }, { 0xB2, 0x41, 0x37 }, { 0xB3, 0x31, 0x37 },
+	{ 0xB5, 0x21, 0x37 }, { 0xB7, 0x21, 0x37 }, { 0xB8, 0x11, 0x37 }, { 0xBA, 0x01, 0x37 },
+	{ 0xBB, 0x01, 0x37 }, { 0xBC, 0xF1, 0x36 }, { 0xBE, 0xF1, 0x36 }, { 0xBF, 0xE1, 0x36 },
+	{ 0xC0, 0xE1, 0x36 }, { 0xC1, 0xE1, 0x36 }, { 0xC2, 0xD1, 0x36 }, { 0xC3, 0xD1, 0x36 },
+	{ 0xC4, 0xD1, 0x36 }, { 0xC5, 0xD1, 0x36 }, { 0xC6, 0xD1, 0x36 }, { 0xC7, 0xD1, 0x36 },
+	{ 0xC8, 0xE1, 0x36 }, { 0xC8, 0xE1, 0x36 }, { 0xC9, 0xE1, 0x36 }, { 0xC9, 0xF1, 0x36 },
+	{ 0xCA, 0xF1, 0x36 }, { 0xCA, 0x01, 0x37 }, { 0xCB, 0x01, 0x37 }, { 0xCB, 0x11, 0x37 },
+	{ 0xCB, 0x21, 0x37 }, { 0xCB, 0x31, 0x37 }, { 0xCB, 0x31, 0x37 }, { 0xCB, 0x41, 0x37 },
+	{ 0xCB, 0x51, 0x37 }, { 0xCB, 0x61, 0x37 }
+};
+
+#endif
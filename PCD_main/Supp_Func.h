@@ -4,8 +4,8 @@
  * Supp_Func.h
  * Author:		Hans V. Rasmussen
  * Created:		13/06-2017 18:47
- * Modified:	30/07-2017 16:32
- * Version:		1.2
+ * Modified:	17/10-2026 12:00
+ * Version:		1.3
  * 
  * Description:
  *	This library includes some extra functionality for the DS3231.
@@ -13,6 +13,161 @@
 
 //Change log
 /*
+Version: 1.3
+
+Added:
+	- UIgetState in Human_Machine_Interface.
+	- Host build of the sketch in PCD_host, against mocked Arduino core, registers, ADC, I2C, EEPROM and LCD.
+		- pcd_bench drives loop() and UIupdate() and reports the cost of each iteration.
+		- pcd_simbench runs the compiled firmware under simavr and reports cycles per ISR, function and loop() pass.
+		- pcd_yearsim runs years of schedules with injected faults and power losses on all cores, and checks every event.
+	- class LCD_Framebuffer, a 16x2 shadow of the LCD with per character dirty bits.
+		- UIupdate draws into LCDfb and flushes it once per call, only changed characters and blink changes reach the LCD.
+	- class Power_Manager, replaces the delay(100) at the end of loop().
+		- Idle sleep with the 1 ms tick while the lift moves or the UI has been used within PWRuiAwake.
+		- Otherwise power-down with the tick, ADC and LCD off, woken by INT0 (low level), RIGHT/UP on A0 or serial RX.
+	- class Software_Clock, a tmElements_t advanced one second at a time by the Timer1 tick (TMRclock since Timer1_Scheduler).
+		- Re-synced from the DS3231 at boot, after power-down, after setting the time and every CLKresync seconds.
+	- class Keypad_ADC, samples the keypad with the ADC auto triggered by Timer0 and classifies it in ISR(ADC_vect).
+		- Debounced by an integrator over BTNdebounce samples, posts press, release and hold (repeat) events to a queue.
+	- UIscreens, a table in flash with the label, field, edited digit and SELECT/LEFT/RIGHT targets of every UIstate.
+	- class Serial_Console, a line based serial console polled from loop() that never waits for the UART.
+		- Commands: help, status, open, close, stop, time, alarm1, alarm2, binary, journal, sun, place, offsets,
+		  week, weekadd, weekdel, lift, dead, ramp and probes.
+	- class Telemetry_Binary, framed binary records (sync, type, length, payload, CRC8) sent through the console.
+		- Time, alarm, relay and counter records, decoded on Linux by PCD_host/pcd_decode.
+	- class Event_Log, typed log entries queued in constant time and printed through the console when loop() is idle.
+		- Entries that do not fit are counted and reported as dropped, nothing waits for the UART.
+	- class Config_Store, the alarms, the lift run time and the solar schedule in one CRC protected record with a schema version.
+		- Every save goes to the next of CFGslots slots in the EEPROM with a higher sequence number, unchanged bytes are not written.
+		- configLoad takes the newest valid record in one pass, or the alarms of version 1.2, or the defaults.
+		- A record of an older schema in CFGschemas is migrated, the fields it lacks get their defaults.
+	- class Journal_AT24C32, an append only journal of door events on the AT24C32 of the DS3231 module.
+		- Boot, alarm, relay, manual and clock records with delta time stamps, collected in RAM and written a page at a time.
+		- Console command journal streams it out, oldest first.
+	- class Solar_Schedule, opens and closes at sunrise and sunset plus an offset, reprogramming both DS3231 alarms.
+		- Times from a fixed point solar calculation (sunCompute), or from SUNdays in Sun_Table.h (sunLookup).
+		- Sun_Table.h is generated by PCD_host/pcd_suntable for the location of the door.
+		- The solar alarms also match the date, each is set to the next day's time once it has fired.
+		- Console commands sun, place and offsets.
+	- class Week_Schedule, a weekly table of up to SCHentries open and close events multiplexed onto ALARM_1.
+		- Kept sorted by minute of the week in the EEPROM, the next event is found by binary search and only it is armed.
+		- An event may run the lift for a set time instead of to its end switch, e.g. to open the door a crack.
+		- Console commands week, weekadd and weekdel.
+		- The event of ALARM_1 is found by the time it was armed with, the software clock may still show the minute before.
+	- End switches of the lift on A1 (open) and A2 (closed), read by ISR(PCINT1_vect).
+		- The ISR switches the relays off as soon as the switch in the direction of travel closes.
+		- RAposition follows the door: POSunknown, POSopen, POSclosed, POSopening or POSclosing.
+		- A run that reaches no end switch within liftHold is stopped as a fault (LOGfault, JRNfault).
+	- Travel time statistics per direction in liftRelayArray, LFT_Stats: last, min, mean and max, and a histogram.
+		- Only full runs, from one end switch to the other, are counted, timed by the 1 ms tick.
+		- After LFTlearn runs a run more than LFTdeviation percent off the mean is a fault (LOGdeviation, JRNdeviation).
+		- Console command lift shows them, lift 0 clears them.
+	- class Event_Queue, one single producer, single consumer ring of typed events from the ISRs to loop().
+		- EVTalarm (INT0), EVTkey (keypad), EVTswitch (end switch) and EVTdeadline/EVTtimed (Timer1), with the run time in ms.
+		- loop() takes them oldest first, one alarm and one key per pass, powerWait returns while any are left.
+	- class Timer1_Scheduler, one shot deadlines on Timer1 instead of the 1 ms tick.
+		- Timer1 runs at F_CPU/1024 (64 us) only while a deadline is armed, OCR1A is set to the nearest one.
+		- Spans beyond TMRstep are reached in steps, which also keep the 32 bit time base of timerNow.
+		- TMRclock gives the second of Software_Clock, TMRrelay the deadline of the running lift.
+	- class template Relay_Driver, the relay array by port, open and close masks, polarity and topology (RA_Relays).
+		- Every command is one masked write of the port, the masks are checked by static_assert when compiling.
+		- RAremote for an AC lift whose remote the relays press, RAbridge for a DC motor on an H-bridge of the relays.
+	- Relay sequencer in liftRelayArray, RAstate: RSidle, RSdead (all off for the dead time) and RSrunning.
+		- relayArrayCommand switches all relays off and arms TMRdead, relayStart in the Timer1 ISR switches the direction on.
+		- The dead time is deadTime of Config (RAdeadTime by default), console command dead.
+	- DC drive of RAbridge: Timer2 PWM on OC2B (D3) enables the H-bridge, ramped by the TMRramp deadline of Timer1.
+		- Acceleration and deceleration follow RMPprofiles in flash, one entry per rampStep ms, console command ramp.
+		- Full runs slow down to RMPcrawl RMPapproach ms (at full speed) before the learned end of travel.
+	- class DS3231_Driver, replaces the DS3232RTC library.
+		- rtcRead reads registers 0x00 to 0x0F in one burst, time, alarms and flags are decoded from that copy.
+		- A1F and A2F are cleared together by one write, an alarm is programmed in one write with the control and status.
+	- class TWI_Engine (I2C), an interrupt driven master of the TWI at TWIclock (400 kHz), replaces the Wire library.
+		- A queue of TWI_Request, each runs in ISR(TWI_vect) and ends in a callback with TWIdone, TWInack or TWItimeout.
+		- Every transfer has a deadline on TMRtwi of Timer1, a NACK is retried after TWIretry ms up to its retry count.
+		- A bus held low by a slave is freed by clocking SCL up to TWIrecover times, then a STOP (twiRecover).
+	- class Task_Profiler (Profiler), run time probes compiled in with PRFenabled 1, timed by micros().
+		- ISR(TIMER1_COMPA_vect), ISR(TWI_vect), twiWait, alarm_Check, relayArrayCommand, LCDfb.flush and UIupdate per UIstate.
+		- Each keeps count, min, max and a log2 histogram (PRF_Stats), console command probes prints them, probes 0 clears them.
+
+Changed:
+	- alarmIsr masks INT0 until alarm_Check has cleared the DS3231 flags, and alarm_Check catches a second pending alarm.
+	- UIupdate and the alarm messages in loop() read the time from Clock instead of RTC.get().
+	- UIupdate takes one press or hold event per call from Keypad, read_LCD_buttons returns the debounced key held down.
+	- UIupdate draws and navigates from UIscreens, all HH:MM digits are edited by UIeditDigit. Labels are in flash.
+	- The alarm messages of loop(), alarm1_set and alarm2_set go to Log instead of Serial.
+	- init_alarms sets both DS3231 alarms from Config, alarm1_set and alarm2_set save through Config.
+	- alarm1_set and alarm2_set switch the schedule back to SUNmanual, setting an alarm by hand overrides the sun.
+	- CFG_Record gains the solar schedule, CFGversion is 3. Records of the older schemas are migrated by configLoad.
+	- relayAutoCommand takes the run time of the event, 0 for the liftHold of Config.
+	- alarm_program takes ALMdaily, ALMdate or ALMweekday. alarm_disable switches an alarm interrupt off.
+	- Config_Store leaves the top SCHsize bytes of the EEPROM to Week_Schedule, CFGslots only counts the slots below it.
+		- configLoad ignores records at or above SCHaddress, a record left there belongs to the schedule now.
+	- CONtx is 128, a command waits for CONreplyMax free and the help is queued a line at a time.
+	- consolePoll queues the help a line at a time from CONhelp, it no longer has to fit CONtx at once.
+	- relayAutoCommand stops the lift at its end switch, liftHold of Config (RAHold, now 8 s) is only the fault timeout.
+	- relayArrayCommand does not start the lift towards an end it is already at, and returns whether it started.
+	- PCINT1 is enabled all the time for the end switches, power-down adds the keypad to PCMSK1 instead.
+	- The ISRs stop the lift at its end switch or its deadline and post an event, loop() never reads RACounter1.
+	- relayArrayCommand takes the run time and arms the deadline (RAdeadline) with the relays, relayEvent does the bookkeeping.
+	- alarm_Check is called for EVTalarm, a second alarm still holding INT0 low is posted again.
+	- Keypad posts its events to Events, UIupdate takes the event to handle as its argument.
+	- Timer1 interrupts fall from 1000 per second to one per second, plus one per lift run, and none at all in power-down.
+	- The lift is timed from RAstart with timerNow, powerDown no longer touches Timer1, it stops with the I/O clock.
+	- relayArrayCommand and the ISRs switch the relays through RA_Relays, a direction is switched on and the other off at once.
+	- relayArrayCommand returns at once, true if the start was accepted. A reversal always passes through all off and the dead time.
+	- The dead time is 100 ms by default instead of 10 ms, long enough for the contactors of most AC lifts to release.
+	- An end switch that closed during the dead time posts EVTthere, the lift never ran and no STOP is recorded.
+	- CFG_Record gains deadTime, CFGversion is 4. Records of schema 3 are migrated with the default dead time.
+	- CFG_Record gains rampProfile and rampStep, CFGversion is 5. Records of schema 4 are migrated with the default ramp.
+	- Travel times are counted at full speed, relayTravel weighs every ms by the PWM duty (always full with RAremote).
+	- sunPoll rearms an alarm SUNgrace seconds after its time, Timer1 leading the DS3231 no longer clears it unfired.
+	- alarm_Check reports both alarms when both flags are set, alarm 1 first, the second on the next pass.
+	- alarm_Check uses the burst of clockSync after a power-down wake instead of reading the DS3231 again.
+	- Console command status shows the DS3231 time and both alarms.
+	- rtcRead, the alarm writes of DS3231_Driver and journalFlush return at once, the TWI_Engine completes them.
+		- Writes are applied to the register copy at once, a read that ends meanwhile does not overwrite them.
+		- A failed alarm write is retried once from the copy, then the copy is marked stale.
+	- alarm_Check reads the DS3231 when its copy is stale and continues in alarm_Read, loop() does not wait for the bus.
+	- Clock re-syncs in the background, clockSynced takes the burst in the ISR and clockUpdate applies it in loop().
+	- Console command status answers with the DS3231 line once its read has ended, plus the I2C errors and recoveries.
+	- The journal command streams pages as their reads end (EVTtwi), the dump no longer waits for each page.
+	- The journal fills all JRNpage bytes of a page, the TWI_Engine has no 32 byte buffer that left 2 of them unused.
+	- A DS3231 write with all DSwrites requests pending waits in the copy, rtcWriteEnded writes it. rtcWrite no longer waits.
+	- A journal page that fills while the previous write is on the bus waits in RAM, journalWriteEnded writes it.
+	- The console commands sun 0 and week 0 call alarm_restore, only init_alarms in setup() waits for the registers.
+	- powerWait writes the journal a pass before power-down, and waits for clockSync in its idle loop after it.
+		- A read of clockSync after a wake-up that fails is tried again, up to PWRsyncTries reads in all.
+	- consolePoll runs a command only once the output ring has CONreplyMax free, no reply is cut short any more.
+		- The lift command is queued a line at a time, its four lines did not fit CONtx together.
+		- Characters write still has to drop are counted, consolePoll reports them.
+	- About 980 B of .data and .bss is the sketch's own, the setup() banner moved to flash with F().
+	- setup() prints PCDversion, the version of this change log, instead of 0.91.
+	- The host mock of the TWI works on the registers, with the bus timing of TWBR and a slave that can hold SDA low.
+
+Removed:
+	- analogRead of the keypad in ISR(TIMER1_COMPA_vect), and btnStat, UIdelay, UIdelayStat and UIbtnHold with it.
+	- The 25 hand written cases of UIupdate.
+	- The blocking debug menu and 3 second countdown in setup(), the console replaces them.
+	- alarm1_addr, alarm2_addr and the alarm1_time/alarm2_time unions, Config replaces them.
+	- alarmIsrWasCalled, the event queue of Keypad, RAtravel and runHold, Events replaces them.
+	- The 1 ms CTC tick of Timer1 and CLKms, RACounter1 and RAdeadline with it.
+	- RAoff and the commented out active high relay code, RAactiveLow selects the polarity.
+	- _delay_ms(10) in relayArrayCommand and RACounter1Status, RAstate replaces it.
+	- The DS3232RTC library and its host mock (Mock_RTC.cpp), DS3231_Driver replaces them.
+	- The Wire library and its host mock (Mock_Wire.cpp, Wire.h), TWI_Engine replaces them.
+
+Notes:
+	- Only RIGHT and UP pull A0 below the digital low threshold, so only they (or serial input) wake the display.
+	- The SQW pin of the DS3231 carries the alarm interrupt, so it can not also give a 1 Hz signal. Clock counts Timer1 instead.
+	- The solar schedule ignores daylight saving time, utcOffset has to be changed by hand if the clock follows it.
+	- Without end switches on A1 and A2 the pull-ups read both as open, every run then stops as a fault after liftHold.
+	- The travel time statistics are kept in RAM only, they start over after a reset.
+	- Timer0 still overflows every 1.024 ms for millis() and the keypad ADC, so idle sleep keeps waking at that rate.
+	- Only setup() waits for the TWI (twiWait), in idle sleep. loop() goes on and takes the results from the done functions.
+	- The probes include the ISRs that interrupt them, and micros() stands still in power-down, no probe spans it.
+
+
 Version: 1.2
 
 Added:
@@ -68,12 +223,18 @@ Version: 1.0
 */
 
 #include <avr/eeprom.h>
-#include <DS3232RTC.h>				//http://github.com/JChristensen/DS3232RTC
 #include <Streaming.h>				//http://arduiniana.org/libraries/streaming/
 #include <TimeLib.h>				//http://playground.arduino.cc/Code/Time
-#include <Wire.h>					//http://arduino.cc/en/Reference/Wire
 #include <LiquidCrystal.h>			// Arduino library for LCD
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/crc16.h>
+#include <util/delay.h>
+#include <util/twi.h>
+#include "Sun_Table.h"				// Generated by PCD_host/pcd_suntable
+
+// Define version of the sketch, the one of the change log at the top. Printed by setup().
+#define PCDversion	"1.3"
 
 // Define Buttons for LCD
 #define btnPIN		A0
@@ -84,1539 +245,6423 @@ Version: 1.0
 #define btnDOWN		4
 #define btnLEFT		5
 
-// Define time to wait between buttons presses (change this time to tune the button handling)
-#define UIbtnHold	500
+// Define keypad sampling, one sample per Timer0 overflow (1.024 ms)
+#define BTNdebounce		8		// Depth of the debounce integrator, a clean change takes 2 x BTNdebounce samples
+#define BTNhold			1000	// Samples a key is held before it starts repeating
+#define BTNrepeat		250		// Samples between repeats while held
+
+// Define keypad events, the key is in the lower 4 bits
+#define BTNpress		0x10
+#define BTNrelease		0x20
+#define BTNrepeated		0x30
+#define BTNtypeMask		0xF0
+#define BTNkeyMask		0x0F
+
+// Define size of the LCD
+#define LCDcols		16
+#define LCDrows		2
 
 // Define commands for Relay Array
 #define liftSTOP	0	// Stops the lift
 #define liftCW		1	// Opens the door - Retracts in the cable
 #define liftCCW		2	// Closes the door - Extends the cable
 
-// define pins of Relay Array
+// define pins of Relay Array, on port D (RA_PortD)
 #define RAControl1	DDD4
 #define RAControl2	DDD5
 #define RAControl3	DDD6
 #define RAControl4	DDD7
+#define RAopenMask	((1 << RAControl1) | (1 << RAControl4))	// Relays switched on to open the door, liftCW
+#define RAcloseMask	((1 << RAControl2) | (1 << RAControl3))	// Relays switched on to close the door, liftCCW
+
+// define how the relays drive the lift, see Relay_Driver
+#define RAremote	0		// AC lift, the relays act as a second remote
+#define RAbridge	1		// DC motor, the relays form an H-bridge: each direction one high side and one low side relay
+#define RAtopology	RAremote
+#define RAactiveLow	true	// The relay module switches on with a low input
+
+// define pins of the end switches, on port C with pull-ups, closed to ground at the end of travel
+#define LSopen		PINC1	// A1, door fully open
+#define LSclosed	PINC2	// A2, door fully closed
+
+// Define positions of the door, RAposition
+#define POSunknown	0		// Between the ends, or not known since boot
+#define POSopen		1
+#define POSclosed	2
+#define POSopening	3
+#define POSclosing	4
+
+// Define time after which a run that did not reach its end switch is stopped as a fault (ms)
+#define RAHold		8000
+
+// Define time all relays are off before the lift starts or reverses (ms), deadTime of Config
+#define RAdeadTime	100
+#define RAdeadMax	2000
+
+// Define the DC drive of RAbridge, Timer2 fast PWM at F_CPU/8/256 (7.8 kHz) on OC2B (PD3, D3) enables the H-bridge
+#define RAenable		DDD3
+#define RMPsteps		16		// Entries of a profile in RMPprofiles
+#define RMPoff			0		// rampProfile: no ramps and no final approach, full on at once
+#define RMPlinear		1
+#define RMPscurve		2
+#define RMPprofileDefault	RMPscurve
+#define RMPstepDefault	20		// ms per entry, rampStep of Config
+#define RMPstepMax		250
+#define RMPfull			255		// Duty of the H-bridge enable, of 255
+#define RMPcrawl		96		// Duty of the final approach
+#define RMPapproach		300		// ms at full speed before the learned end of travel that the final approach begins
+
+// Define states of the ramp, RMPstate
+#define RMPaccel		0		// Up the profile
+#define RMPcruise		1		// Full duty until RAslow
+#define RMPdecel		2		// Down the profile to RMPcrawl
+#define RMPfinal		3		// RMPcrawl until the end switch
+
+// Define states of the relay sequencer, RAstate
+#define RSidle		0		// All relays off
+#define RSdead		1		// All relays off for the dead time, RApending is switched on when TMRdead expires
+#define RSrunning	2		// The relays of RAdirection are on
+
+// Define travel time statistics, LFT_Stats, one per direction
+#define LFTbins			8		// Histogram bins of the deviation from the mean
+#define LFTbinPercent	5		// Width of a bin, the outer two take everything beyond
+#define LFTlearn		8		// Runs that make the baseline before deviations are reported
+#define LFTdeviation	15		// Percent off the mean that counts as a fault
+
+// Define time between re-syncs of the software clock with the DS3231 (s)
+#define CLKresync	600
+
+// Define DS3231 registers, DS3231_Driver reads the first DSburst of them in one transaction
+#define DSaddr			0x68	// I2C address
+#define DSseconds		0x00	// Seconds, minutes, hours, day of week, date, month, year
+#define DSalarm1		0x07	// Seconds, minutes, hours, day/date
+#define DSalarm2		0x0B	// Minutes, hours, day/date
+#define DScontrol		0x0E
+#define DSstatus		0x0F
+#define DSburst			0x10
+#define DSmask			0x80	// AxMy of an alarm register, the register takes no part in the match
+#define DSdayOfWeek		0x40	// DY/DT of the day/date register
+#define DSa1ie			0x01	// Control: the alarm interrupts, and INT/SQW as interrupt output
+#define DSa2ie			0x02
+#define DSintcn			0x04
+#define DSa1f			0x01	// Status: the alarm flags, a 1 written leaves a flag as it is
+#define DSa2f			0x02
+#define DSen32khz		0x08
+#define DSosf			0x80
+#define DStimeout		5		// ms a transfer with the DS3231 may take
+#define DSwrites		2		// Writes that can be queued at once, more wait in the copy for one of them to end
+
+// Define the TWI engine, TWI_Request transfers queued for ISR(TWI_vect) instead of the blocking Wire library
+#define TWIclock		400000UL	// SCL, the DS3231 and the AT24C32 both take 400 kHz. 100000UL for long cables
+#define TWIqueue		8		// Requests waiting for the bus, must be a power of 2
+#define TWIretry		1		// ms between tries while an address is not acknowledged and the request retries
+#define TWIsda			PC4		// A4
+#define TWIscl			PC5		// A5
+#define TWIrecover		9		// SCL pulses that let a slave finish the byte it holds SDA low in
+#define TWIhalfBit		5		// us of each half of those pulses (100 kHz)
+
+// Define states of a TWI_Request, from TWIdone on it has ended
+#define TWIidle			0		// Never submitted
+#define TWIqueued		1
+#define TWIbusy			2		// On the bus, or between two tries
+#define TWIdone			3
+#define TWInack			4		// Address or data not acknowledged
+#define TWIfailed		5		// Bus error, the bus was recovered
+#define TWItimeout		6		// Not done within its timeout, the bus was recovered
+
+// Define serial console
+#define CONline			32		// Longest command line
+#define CONtx			128		// Size of the output ring, must be a power of 2 and at most 256, above CONreplyMax
+#define CONrxPerPass	64		// Most bytes taken from Serial per loop() pass, the size of its receive buffer
+#define CONrtcLine		96		// Console space the rtc line of status may need
+#define CONreplyMax		112		// Console space the longest reply of a command needs (sun), longer ones come a line at a time
+#define CONliftLines	4		// Lines of the lift command, two per direction
+
+// Define binary telemetry, frames are TELsync, type, length, payload, CRC8 (poly 0x07) of type, length and payload.
+// All values are little endian, every record starts with the time_t it was made at.
+#define TELdefault		0		// Start in binary mode, the console command binary switches at runtime
+#define TELsync			0xA5	// Never sent in text, which is 7 bit
+#define TELmaxPayload	16
+#define TELperiod		3600	// Seconds between counter records
+#define TELtime			0x01	// time_t (after boot and setting the time)
+#define TELalarm		0x02	// time_t, uint8_t alarm
+#define TELrelay		0x03	// time_t, uint8_t liftSTOP/liftCW/liftCCW
+#define TELcounters		0x04	// time_t, uint16_t wake-ups, lift runs, alarms, clock syncs
+
+// Define event log, entries are printed by Event_Log::logDrain when loop() is idle
+#define LOGqueue		16		// Size of the entry queue, must be a power of 2
+#define LOGlineMax		48		// Console space one printed entry may need
+
+// Define log entries, every entry holds an id, a uint8_t and a time_t
+#define LOGalarm		1		// Alarm triggered, alarm number and time
+#define LOGalarmSet		2		// Alarm set, alarm number and alarm time
+#define LOGfault		3		// No end switch within liftHold, liftCW or liftCCW and the time
+#define LOGdeviation	4		// Run far off the mean travel time, liftCW or liftCCW and the time
+
+// Define weekly schedule, SCH_Header and the sorted SCH_Entry table at the top of the EEPROM
+#define SCHentries		48		// Events the table holds
+#define SCHversion		1		// Schema of SCH_Header and SCH_Entry
+#define SCHsize			(4 + SCHentries * 4)
+#define SCHaddress		(E2END + 1 - SCHsize)
+#define SCHopen			1		// Actions, the same numbers relayAutoCommand takes
+#define SCHclose		2
+#define SCHminutes		(7 * 24 * 60)	// Minutes in a week, SCH_Entry.minute counts from Sunday 00:00
+#define SCHidle			0xFF	// Week_Schedule::dumpIndex while not listing
+
+// Define configuration store, the EEPROM below SCHaddress is divided in CFGslots records of sizeof(CFG_Record) bytes
+#define CFGversion		5		// Schema of CFG_Record, version 1.2 stored bare time_t at address 0 and 10
+#define CFGslots		(SCHaddress / sizeof(CFG_Record))
+#define CFGlegacyAlarm1	0		// Addresses of the version 1.2 alarms, read once if no record of any schema is valid
+#define CFGlegacyAlarm2	10
+#define CFGopenDefault	(7 * SECS_PER_HOUR)		// Alarm times used when the EEPROM holds nothing valid
+#define CFGcloseDefault	(21 * SECS_PER_HOUR)
+
+// Define alarm matching, see DS3231RTC_Alarms::alarm_program
+#define ALMdaily		0		// Hours, minutes and seconds
+#define ALMdate			1		// And the date of the month
+#define ALMweekday		2		// And the day of the week
+
+// Define solar schedule, the modes of CFG_Record.mode
+#define SUNmanual		0		// Alarms as set by hand
+#define SUNfixed		1		// Sunrise and sunset from Solar_Schedule::sunCompute, for the place in Config
+#define SUNtable		2		// Sunrise and sunset from SUNdays, for the place Sun_Table.h was generated for
+#define SCHweekly		3		// ALARM_1 from Week_Schedule, ALARM_2 unused
+#define SUNutcDefault	60		// Minutes the clock is ahead of UTC (CET)
+#define SUNhorizon		(-476)	// sin(-0.833 degrees) in Q15, refraction and the radius of the sun
+#define SUNgrace		2		// Seconds the software clock may lead the DS3231 before an armed time has passed
+
+// Define journal on the AT24C32, a ring of JRNpages pages that each start with a JRNheader byte header:
+// uint32_t time_t the page starts at, uint16_t sequence number. Records follow until the first 0xFF byte or the end of the page.
+#define JRNaddr			0x57	// I2C address, A0-A2 are pulled up on the module
+#define JRNsize			4096
+#define JRNpage			32		// Page of the AT24C32, one write cycle
+#define JRNpages		(JRNsize / JRNpage)
+#define JRNheader		6
+#define JRNmaxAge		3600	// Seconds records may wait in RAM while awake, power-down always writes them
+#define JRNpollMax		10		// ms a transfer may take, retried while a write cycle does not acknowledge
+
+// Define journal records, the type is in the upper 4 bits of the first byte and the argument in the lower.
+// The first byte is followed by the seconds since the previous record, 7 bits per byte and the low bits first,
+// except for JRNclock, which is followed by the new time_t.
+#define JRNclock		0x00	// Clock set or went backwards
+#define JRNboot			0x10
+#define JRNalarm		0x20	// Alarm 1 or 2 triggered
+#define JRNrelay		0x30	// Relay command liftSTOP, liftCW or liftCCW
+#define JRNmanual		0x40	// open, close or stop from the console, as liftCW, liftCCW or liftSTOP
+#define JRNfault		0x50	// Lift stopped without reaching its end switch, liftCW or liftCCW
+#define JRNdeviation	0x60	// Run more than LFTdeviation percent off the mean, liftCW or liftCCW
+#define JRNtypeMask		0xF0
+#define JRNargMask		0x0F
+
+// Define events the ISRs post to loop() through Events, EVT_Entry
+#define EVTqueue		16		// Size of the queue, must be a power of 2
+#define EVTalarm		1		// INT0, one of the DS3231 alarms fired
+#define EVTkey			2		// Keypad event, BTNpress, BTNrelease or BTNrepeated | key
+#define EVTswitch		3		// End switch stopped the lift, POSopen or POSclosed, ms of a full run or 0
+#define EVTdeadline		4		// liftHold stopped the lift, liftCW or liftCCW and ms
+#define EVTtimed		5		// A timed run ended, liftCW or liftCCW and ms
+#define EVTthere		6		// relayStart found the end switch closed after the dead time, POSopen or POSclosed, the lift never ran
+#define EVTtwi			7		// An I2C transfer loop() waits for ended, the pass serves it
+
+// Define deadlines of Timers, Timer1 at F_CPU/1024
+#define TMRclock		0		// Software_Clock, every second
+#define TMRrelay		1		// liftRelayArray, the deadline of the running lift
+#define TMRdead			2		// liftRelayArray, the end of the dead time
+#define TMRramp			3		// liftRelayArray, the next step of the PWM ramp of RAbridge
+#define TMRtwi			4		// TWI_Engine, the timeout of the transfer on the bus, or its next try
+#define TMRslots		5
+#define TMRsecond		15625UL	// Ticks of 64 us in a second
+#define TMRms(ms)		((uint32_t)(ms) * 125 / 8)	// Ticks in ms
+#define TMRstep			0x8000	// Longest step between compare matches, the time base needs one per wrap of TCNT1
+#define TMRsoon			2		// Closest OCR1A is set ahead of TCNT1, nearer deadlines are that much late
+
+// Define profiling probes, Task_Profiler. Set PRFenabled to 1 to compile them in, 16 bytes of RAM per probe.
+#ifndef PRFenabled
+#define PRFenabled		0
+#endif
+#define PRFbins			8		// Log2 histogram of the run times, bin 0 is below PRFbinFirst us, the last takes the rest
+#define PRFbinFirst		8		// us, two steps of micros()
+#define PRFtimer1		0		// ISR(TIMER1_COMPA_vect)
+#define PRFtwi			1		// ISR(TWI_vect), one step of a transfer
+#define PRFtwiWait		2		// TWI_Engine::twiWait, loop() waiting for the bus
+#define PRFalarm		3		// DS3231RTC_Alarms::alarm_Check
+#define PRFrelay		4		// liftRelayArray::relayArrayCommand
+#define PRFlcd			5		// LCD_Framebuffer::flush, the writes to the LCD
+#define PRFui			6		// Human_Machine_Interface::UIupdate, one probe per entry of UIscreens from here on
+#define PRFprobes		(PRFui + UIscreenCount)
+#define PRFlineMax		64		// Console space one line of the table may need
+
+// Probe points, PRFbegin at the start of a task and PRFend on every way out of it. Nothing is left with PRFenabled 0.
+#if PRFenabled
+#define PRFbegin(stamp)			uint16_t stamp = Profiler.prfNow()
+#define PRFend(probe, stamp)	Profiler.prfAdd(probe, stamp)
+#else
+#define PRFbegin(stamp)
+#define PRFend(probe, stamp)
+#endif
 
-// Define time for Relay Array to stop lift again (ms)
-#define RAHold		4000
+// Define power management (set PWRdeepSleep to 0 to never power down)
+#define PWRdeepSleep	1
+#define PWRuiAwake		30000	// Time after the last key press before the UI sleeps (ms)
+#define PWRloopPeriod	100		// Time between loop() passes while awake (ms)
+#define PWRsyncTries	3		// Reads of the DS3231 after a wake-up, before the clock goes on with the old time
 
 // Declare external global lcd
 extern LiquidCrystal lcd;
-extern DS3232RTC RTC;
 
 // Global variables:
 
-volatile boolean	alarmIsrWasCalled = false;	// Variable to check if the interrupt has happened.
+// relayArray, written by loop() only with interrupts off while the lift runs:
+volatile uint8_t	RAstate = RSidle;			// Relay sequencer, set to RSidle by the ISR that stops the lift.
+volatile uint8_t	RApending = liftSTOP;		// Direction switched on at the end of the dead time.
+volatile uint16_t	RArun = 0;					// ms from the start to the TMRrelay deadline.
+volatile uint32_t	RAstart = 0;				// timerNow when the lift started.
+volatile uint16_t	RAslow = 0;					// Travel (ms at full speed) at which the final approach begins, 0 for none.
+
+// DC drive of RAbridge, written by the ISRs while the lift runs:
+volatile uint8_t	RMPstate = RMPaccel;
+volatile uint8_t	RMPindex = 0;				// Next entry of the profile.
+volatile uint8_t	RMPduty = RMPfull;			// Duty since RMPsince.
+volatile uint32_t	RMPsince = 0;				// timerNow of the last change of duty.
+volatile uint32_t	RMPtravel = 0;				// Ticks at full speed from RAstart to RMPsince.
+volatile boolean	RAtimed = false;			// The TMRrelay deadline ends a timed run rather than a fault.
+volatile uint8_t	RAdirection = liftSTOP;		// What the relays drive, set to liftSTOP by the ISR that stops it.
+volatile uint8_t	RAposition = POSunknown;	// Where the door is.
+volatile uint8_t	RAfrom = POSunknown;		// RAposition when the lift started, only full runs are timed.
+
+// Telemetry counters, since boot:
+uint16_t			TELwakeups = 0;		// Wake-ups from power-down.
+uint16_t			TELliftRuns = 0;	// Lift started.
+uint16_t			TELalarms = 0;		// Alarms handled.
+uint16_t			TELsyncs = 0;		// Software clock synced from the DS3231.
+
+// Software clock:
+volatile uint8_t	CLKpending = 0;		// Whole seconds not yet added to the clock, counted by the TMRclock deadline.
+
+// Configuration, one record in the EEPROM (28 bytes):
+struct CFG_Record
+{
+	uint8_t version;	// CFGversion
+	uint16_t sequence;	// Incremented by every save, the highest valid one is the newest
+	uint32_t alarm1;	// time_t of alarm1 (open), only hours, minutes and seconds are used
+	uint32_t alarm2;	// time_t of alarm2 (close)
+	uint16_t liftHold;	// ms a run may take before it is stopped as a fault, RAHold by default
+	uint8_t mode;		// SUNmanual, SUNfixed, SUNtable or SCHweekly
+	int16_t latitude;	// Hundredths of a degree, north positive
+	int16_t longitude;	// Hundredths of a degree, east positive
+	int8_t openOffset;	// Minutes from sunrise to opening
+	int8_t closeOffset;	// Minutes from sunset to closing
+	int16_t utcOffset;	// Minutes the clock is ahead of UTC
+	uint16_t deadTime;	// ms all relays are off before the lift starts or reverses, RAdeadTime by default
+	uint8_t rampProfile;	// RMPoff, RMPlinear or RMPscurve, only used by RAbridge
+	uint8_t rampStep;	// ms per entry of the profile
+	uint16_t crc;		// _crc16_update from 0xFFFF over the bytes before it
+} __attribute__((packed));
+
+// Schemas configLoad reads, newest first: version and size of CFG_Record. Every schema adds its fields
+// before the crc, so an older record is the start of the current one, the added fields keep their defaults.
+const uint8_t CFGschemas[][2] PROGMEM = {
+	{ CFGversion,	sizeof(CFG_Record) },
+	{ 4,			26 },	// Up to deadTime
+	{ 3,			24 },	// Up to utcOffset, the solar schedule
+	{ 2,			16 }	// Alarms and liftHold, a reserved byte where mode is now
+};
+#define CFGschemaCount	(sizeof(CFGschemas) / sizeof(CFGschemas[0]))
+
+// Weekly schedule, in the EEPROM at SCHaddress:
+struct SCH_Header
+{
+	uint8_t count;		// Entries in use
+	uint8_t version;	// SCHversion
+	uint16_t crc;		// _crc16_update from 0xFFFF over count, version and the entries in use
+} __attribute__((packed));
+
+struct SCH_Entry
+{
+	uint16_t minute;	// Minute of the week, from Sunday 00:00
+	uint8_t action;		// SCHopen or SCHclose
+	uint8_t hold;		// Tenths of a second the lift runs, 0 to run to the end switch
+} __attribute__((packed));
 
-// UI:
-volatile uint8_t	btnStat = 0;	// variable for testing button state every 1 ms.
+// One event from an ISR to loop().
+struct EVT_Entry
+{
+	uint8_t type;		// EVTalarm, EVTkey, EVTswitch, EVTdeadline, EVTtimed, EVTthere or EVTtwi
+	uint8_t arg;
+	uint16_t ms;		// ms the lift ran for the lift events, 0 for the others
+};
 
-volatile uint16_t	UIdelay = 0;
-volatile boolean	UIdelayStat = 0;
+// One I2C transfer for TWI_Engine: writes reg and tx, then reads rx after a repeated start.
+// The request and its buffers belong to the engine from twiSubmit until done is called.
+struct TWI_Request
+{
+	uint8_t address;		// 7 bit slave address
+	uint8_t reg[2];			// Register or memory address, sent first
+	uint8_t regLength;
+	const uint8_t *tx;		// Data written after reg
+	uint8_t txLength;
+	uint8_t *rx;			// Data read, 0 bytes for a write
+	uint8_t rxLength;
+	uint8_t timeout;		// ms from the first START, then the bus is recovered
+	boolean retry;			// Try again every TWIretry ms while the address is not acknowledged
+	void (*done)(TWI_Request &request);	// Called from the ISR when it ends, may be 0
+	volatile uint8_t status;	// TWIidle ... TWItimeout
+};
 
-// relayArray:
-volatile uint16_t	RACounter1 = 0;
-volatile boolean	RACounter1Status = 0;
+// Travel times of one direction, end switch to end switch, in ms.
+struct LFT_Stats
+{
+	uint16_t runs;			// Full runs since boot or lift 0
+	uint16_t last;
+	uint16_t min;
+	uint16_t max;
+	uint32_t mean;			// Mean in 1/16 ms, the average of the first LFTlearn runs, then a moving average
+	uint8_t faults;			// Deviations and runs stopped by liftHold
+	uint8_t hist[LFTbins];	// Deviation from the mean in LFTbinPercent steps, halved when a bin is full
+};
 
-// Debugging:
-// volatile uint16_t	T1Timer = 0;
-// volatile uint8_t	test = 0;
+// Run times of one probe of Task_Profiler, in us.
+struct PRF_Stats
+{
+	uint32_t count;			// Runs since boot or probes 0
+	uint16_t min;
+	uint16_t max;
+	uint8_t hist[PRFbins];	// Runs by log2 of the run time from PRFbinFirst us on, halved when a bin is full
+};
 
-// addresses of the alarms on the EEPROM (one time_t object takes 7 bytes)
-uint8_t		alarm1_addr = 0;
-uint8_t		alarm2_addr = 10;
+// Solar engine:
+// sin() of 0 to 90 degrees in 64 steps, Q15. Angles are 16 bit binary angles, 65536 is a full turn.
+const uint16_t SUNsin[65] PROGMEM = {
+	0, 804, 1608, 2411, 3212, 4011, 4808, 5602,
+	6393, 7180, 7962, 8740, 9512, 10279, 11039, 11793,
+	12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+	18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+	23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+	27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+	30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+	32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+	32768
+};
 
 
-// Functions:
+// UI screens:
+// Every UIstate is one entry in UIscreens. The first line shows the label, the second line the field as HH:MM.
+// On an editor screen UP/DOWN change one digit of the field, and SELECT saves it before going to onSelect.
+// To add a screen, add a label and an entry with an unused state number.
+#define UIstay			0xFF	// Key does nothing
+#define UIview			0xFF	// Screen shows the field without editing it
 
-void alarmIsr()	// INT0 triggered function.
+#define UIfieldClock	0
+#define UIfieldAlarm1	1
+#define UIfieldAlarm2	2
+
+struct UI_Screen
 {
-	alarmIsrWasCalled = true;
-}
+	uint8_t state;		// UIstate of the screen
+	const char *label;	// First line, in flash
+	uint8_t field;		// UIfieldClock, UIfieldAlarm1 or UIfieldAlarm2
+	uint8_t digit;		// Digit edited by UP/DOWN, 0-3 for H H : M M, or UIview
+	uint8_t onSelect;	// Next UIstate on SELECT
+	uint8_t onLeft;		// Next UIstate on LEFT
+	uint8_t onRight;	// Next UIstate on RIGHT
+};
+
+const char UIlblClock[]		PROGMEM = "Klokkeslaet";
+const char UIlblClockSet[]	PROGMEM = "Skift Klokkeslet";
+const char UIlblOpen[]		PROGMEM = "Doeren aabner:";
+const char UIlblOpenSet[]	PROGMEM = "Skift aabning:";
+const char UIlblClose[]		PROGMEM = "Doeren Lukker:";
+const char UIlblCloseSet[]	PROGMEM = "Skift lukketid:";
+
+const UI_Screen UIscreens[] PROGMEM = {
+	// state	label			field			digit	SELECT	LEFT	RIGHT
+	{ 0,		UIlblClock,		UIfieldClock,	UIview,	1,		20,		10 },		// First entry is the fallback
+	{ 1,		UIlblClockSet,	UIfieldClock,	0,		UIstay,	0,		2 },
+	{ 2,		UIlblClockSet,	UIfieldClock,	1,		UIstay,	1,		3 },
+	{ 3,		UIlblClockSet,	UIfieldClock,	2,		UIstay,	2,		4 },
+	{ 4,		UIlblClockSet,	UIfieldClock,	3,		0,		3,		UIstay },
+	{ 10,		UIlblOpen,		UIfieldAlarm1,	UIview,	11,		0,		20 },
+	{ 11,		UIlblOpenSet,	UIfieldAlarm1,	0,		UIstay,	10,		12 },
+	{ 12,		UIlblOpenSet,	UIfieldAlarm1,	1,		UIstay,	11,		13 },
+	{ 13,		UIlblOpenSet,	UIfieldAlarm1,	2,		UIstay,	12,		14 },
+	{ 14,		UIlblOpenSet,	UIfieldAlarm1,	3,		10,		13,		UIstay },
+	{ 20,		UIlblClose,		UIfieldAlarm2,	UIview,	21,		10,		0 },
+	{ 21,		UIlblCloseSet,	UIfieldAlarm2,	0,		UIstay,	20,		22 },
+	{ 22,		UIlblCloseSet,	UIfieldAlarm2,	1,		UIstay,	21,		23 },
+	{ 23,		UIlblCloseSet,	UIfieldAlarm2,	2,		UIstay,	22,		24 },
+	{ 24,		UIlblCloseSet,	UIfieldAlarm2,	3,		20,		23,		UIstay },
+};
+#define UIscreenCount	(sizeof(UIscreens) / sizeof(UIscreens[0]))
+
+
+// Console commands, in the order of the switch in Serial_Console::consoleExecute.
+#define CONcmdLength	8
+
+const char CONcommands[][CONcmdLength] PROGMEM = {
+	"help", "status", "open", "close", "stop", "time", "alarm1", "alarm2", "binary", "journal",
+	"sun", "place", "offsets", "week", "weekadd", "weekdel", "lift", "dead", "ramp", "probes"
+};
+#define CONcmdCount		(sizeof(CONcommands) / sizeof(CONcommands[0]))
+
+// Help, queued a line at a time by consolePoll as the output ring has room, together it is longer than CONtx.
+const char CONhelp1[] PROGMEM = "status | open | close | stop | time yyyy-mm-dd hh:mm[:ss] | alarm1 hh:mm | alarm2 hh:mm | binary 0|1 | journal";
+const char CONhelp2[] PROGMEM = "sun [0 manual|1 fixed|2 table] | place lat lon | offsets open close utc (minutes)";
+const char CONhelp3[] PROGMEM = "week [0|1] | weekadd days(1=Mon..7) hh:mm 1 open|2 close [tenths] | weekdel n [m]";
+const char CONhelp4[] PROGMEM = "lift [0] | dead [ms] | ramp [0 off|1 linear|2 s-curve] [ms per step] | probes [0]";
+const char *const CONhelp[] PROGMEM = { CONhelp1, CONhelp2, CONhelp3, CONhelp4 };
+#define CONhelpLines	(sizeof(CONhelp) / sizeof(CONhelp[0]))
+
+#if PRFenabled
+// Names of the probes of Task_Profiler before PRFui, the probes of UIupdate are named by their UIstate.
+const char PRFnames[PRFui][8] PROGMEM = { "timer1", "twi", "twiwait", "alarm", "relay", "lcd" };
+#endif
+
+// Ramps of the DC drive, duty of the H-bridge enable by step. Read upwards to start, downwards to slow down.
+const uint8_t RMPprofiles[2][RMPsteps] PROGMEM = {
+	{ 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 255 },	// RMPlinear
+	{ 3, 11, 24, 40, 59, 81, 104, 128, 151, 174, 196, 215, 231, 244, 252, 255 }		// RMPscurve, smoothstep
+};
+
+
+// Functions:
+
+void alarmIsr();	// INT0 triggered function, with the other ISRs at the end.
+void rtcReadDone(TWI_Request &request);		// Ends of the I2C transfers, also at the end.
+void rtcWriteDone(TWI_Request &request);
+void journalReadDone(TWI_Request &request);
+void journalWriteDone(TWI_Request &request);
 
 
 // Classes
 
-class Human_Machine_Interface
+class Event_Queue
 {
 public:
-	Human_Machine_Interface();
-	
+	Event_Queue();	// Constructor
+
 	/**
-	* \brief Takes in variable of type time_t and prints contents to serial or LCD. 
-	*	Text is 20 characters long.
-	* 
-	* \param t
-	* 
-	* \return void
+	 * \brief Adds an event, it is dropped if the queue is full.
+	 *	Called from ISRs, which do not nest, or from loop() with interrupts off.
+	 * 
+	 * \param uint8_t type, uint8_t arg, uint16_t ms
+	 * 
+	 * \return void
 	 */
-	void printDateTime(time_t t);
-	
+	void eventPost(uint8_t type, uint8_t arg, uint16_t ms);
+
 	/**
-	 * \brief Takes in variable of type tmElements_t and prints contents to serial or LCD. 
-	 *	Does not print year, text is 15 characters long.
+	 * \brief Takes the oldest event, called from loop() only.
 	 * 
-	 * \param TM
+	 * \param EVT_Entry &event
 	 * 
-	 * \return void
+	 * \return boolean - false if there was none
 	 */
-	void printDateTime(tmElements_t TM);
+	boolean eventGet(EVT_Entry &event);
 
 	/**
-	 * \brief Checks LCD buttons and returns value corresponding to button.
+	 * \brief Returns true if an event of the type is queued, of any type for 0.
 	 * 
-	 * \param void
+	 * \param uint8_t type
 	 * 
-	 * \return uint8_t
+	 * \return boolean
 	 */
-	uint8_t read_LCD_buttons(void);
-	
+	boolean eventPending(uint8_t type = 0);
+
 	/**
-	 * \brief handles user input/output, should be called regurlarly
+	 * \brief Returns the number of events dropped because the queue was full, since boot.
 	 * 
 	 * \param void
 	 * 
-	 * \return void
+	 * \return uint8_t
 	 */
-	void UIupdate(void);
+	uint8_t eventDropped(void);
 
 protected:
 private:
-	uint8_t UIstate;
-	tmElements_t tid;
+	EVT_Entry events[EVTqueue];
+	volatile uint8_t head, tail;	// The ISRs write at head, loop() reads at tail.
+	volatile uint8_t dropped;
 };
 
 
-class DS3231RTC_Alarms
+class LCD_Framebuffer : public Print
 {
 public:
-	DS3231RTC_Alarms();	// Constructor
-	
+	LCD_Framebuffer(LiquidCrystal &display);	// Constructor
+
 	/**
-	* \brief Initializes the alarms and the interrupt.
-	* 
-	* \param 
-	* 
-	* \return void
-	*/
-	void init_alarms(void);
-	
+	 * \brief Blanks the shadow buffer. Nothing is sent to the LCD.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void clear(void);
+
 	/**
-	 * \brief Takes in pointer, checks whether alarm1 or alarm2 have been triggered.
+	 * \brief Moves the write position in the shadow buffer.
 	 * 
-	 * \param uint8_t *
+	 * \param col, row
 	 * 
 	 * \return void
 	 */
-	void alarm_Check(uint8_t *stat);
-	
+	void setCursor(uint8_t col, uint8_t row);
+
 	/**
-	 * \brief returns the time when alarm1 is expected
+	 * \brief Makes the LCD blink at the current write position from the next flush.
 	 * 
 	 * \param void
 	 * 
-	 * \return time_t
+	 * \return void
 	 */
-	time_t alarm1_get(void);
+	void blink(void);
 
 	/**
-	 * \brief returns the time when alarm2 is expected
+	 * \brief Stops the blinking from the next flush.
 	 * 
 	 * \param void
 	 * 
-	 * \return time_t
+	 * \return void
 	 */
-	time_t alarm2_get(void);
+	void noBlink(void);
 
 	/**
-	 * \brief Takes in tmElements_t and sets timer1 to trigger once a day.
-	 *	Only uses seconds, minutes and hours.
+	 * \brief Writes one character into the shadow buffer, used by print() and <<.
 	 * 
-	 * \param TM
+	 * \param c
 	 * 
-	 * \return boolean
+	 * \return size_t
 	 */
-	void alarm1_set(tmElements_t TM);
-	
+	virtual size_t write(uint8_t c);
+	using Print::write;
+
 	/**
-	 * \brief Takes in tmElements_t and sets timer2 to trigger once a day.
-	 *	Only uses seconds, minutes and hours.
+	 * \brief Sends the characters that differ from the LCD, then the blink position and state.
 	 * 
-	 * \param TM
+	 * \param void
 	 * 
-	 * \return boolean
+	 * \return void
 	 */
-	void alarm2_set(tmElements_t TM);
-	
-	
-	/************************************************************************
-	To change alarms do the following:                        
-	          
-	RTC.setAlarm(ALM1_MATCH_SECONDS, 0, 0, 0, 1);		//daydate parameter should be between 1 and 7
-	RTC.alarm(ALARM_1);									//ensure RTC interrupt flag is cleared
-	RTC.alarmInterrupt(ALARM_1, true);
-	
-	RTC.setAlarm syntax for alarm1 is 
-	void setAlarm(ALARM_TYPES_t alarmType, byte seconds, byte minutes, byte hours, byte daydate);
-	
-	RTC.setAlarm syntax for alarm2 is 
-	void setAlarm(ALARM_TYPES_t alarmType, byte minutes, byte hours, byte daydate);
-	
-	
-	Values for Alarm 1
-	ALM1_EVERY_SECOND -- causes an alarm once per second.
-	ALM1_MATCH_SECONDS -- causes an alarm when the seconds match (i.e. once per minute).
-	ALM1_MATCH_MINUTES -- causes an alarm when the minutes and seconds match.
-	ALM1_MATCH_HOURS -- causes an alarm when the hours and minutes and seconds match.
-	ALM1_MATCH_DATE -- causes an alarm when the date of the month and hours and minutes and seconds match.
-	ALM1_MATCH_DAY -- causes an alarm when the day of the week and hours and minutes and seconds match.
-	
-	Values for Alarm 2
-	ALM2_EVERY_MINUTE -- causes an alarm once per minute.
-	ALM2_MATCH_MINUTES -- causes an alarm when the minutes match (i.e. once per hour).
-	ALM2_MATCH_HOURS -- causes an alarm when the hours and minutes match.
-	ALM2_MATCH_DATE -- causes an alarm when the date of the month and hours and minutes match.
-	ALM2_MATCH_DAY -- causes an alarm when the day of the week and hours and minutes match.
-	************************************************************************/
-	
+	void flush(void);
+
 protected:
 private:
-	// union: make a variable that can be interpreted multiple ways, ex as a long int or as an array of 8 bytes.
-	// This will be used when writing time_t to the EEPROM, as the EEPROM with current libraries only takes chars to store.
-	// By using union one can easily split the unsigned long int time_t into 8 bytes of data and then write them, example:
-	// 	union_name.long_variable = makeTime(TM);
-	// 	for (int i = 0; i < 7; i++)
-	// 	{
-	// 		eeprom_write_byte((uint8_t *)alarm1_addr+i, u.byte_array[0+i]);
-	// 	}
-	union {
-		unsigned long int long_time;
-		byte byte_array[7];
-	} alarm1_time;
-
-	union {
-		unsigned long int long_time;
-		byte byte_array[7];
-	} alarm2_time;
+	LiquidCrystal &lcd;
+	char frame[LCDrows][LCDcols];	// What the UI wants on the LCD.
+	char shown[LCDrows][LCDcols];	// What is on the LCD.
+	uint16_t dirty[LCDrows];		// One bit per column where frame and shown differ.
+	uint8_t col, row;				// Write position in frame.
+	uint8_t lcdCol, lcdRow;			// Address counter of the LCD, LCDcols if unknown.
+	uint8_t blinkCol, blinkRow;
+	boolean blinkOn, shownBlinkOn;
 };
 
 
-class liftRelayArray
+class Keypad_ADC
 {
 public:
-	liftRelayArray();	// Constructor
+	Keypad_ADC();	// Constructor
 
 	/**
-	 * \brief Initializes the pins required
+	 * \brief Starts the ADC on the keypad pin, converting on every Timer0 overflow.
+	 *	analogRead must not be used afterwards, the ADC belongs to the keypad.
 	 * 
 	 * \param void
 	 * 
 	 * \return void
 	 */
-	void relayArrayInit(void);
+	void keypadInit(void);
 
 	/**
-	 * \brief Executes a command for the lift
+	 * \brief Classifies and debounces one ADC result, called from ISR(ADC_vect).
 	 * 
-	 * \param cmd - liftCW, liftCCW, liftSTOP
+	 * \param adc
 	 * 
 	 * \return void
 	 */
-	void relayArrayCommand(uint8_t cmd);
-	
+	void keypadSample(uint16_t adc);
+
 	/**
-	 * \brief Function that controls what actually should happen when alarm happens.
+	 * \brief Returns the debounced key held down, btnRESET if none.
 	 * 
-	 * \param uint8_t alarmtrig
+	 * \param void
 	 * 
-	 * \return void
+	 * \return uint8_t
 	 */
-	void relayAutoCommand(uint8_t alarmtrig);
-	
+	uint8_t keypadHeld(void);
+
+	/**
+	 * \brief Returns true if a key was pressed since the last call.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean keypadActivity(void);
+
 protected:
 private:
-};
-
+	/**
+	 * \brief Returns the key whose ladder voltage the ADC result is closest to.
+	 * 
+	 * \param adc
+	 * 
+	 * \return uint8_t
+	 */
+	uint8_t keypadClassify(uint16_t adc);
 
-// make objects of the classes:
-Human_Machine_Interface HMI;// Make a object of the 'class Human_Machine_Interface' named 'HMI'
-DS3231RTC_Alarms RTC_alarm;	// Make a object of the 'class DS3231RTC_Alarms' named 'RTC_alarm'
-liftRelayArray relayArray;	// Make a object of the 'class liftRelayArray' named 'relayArray'
+	uint8_t candidate;				// Key the integrator is counting for.
+	uint8_t integrator;				// 0 .. BTNdebounce, the key changes when it is full.
+	volatile uint8_t stable;		// Debounced key.
+	uint16_t holdCount;				// Samples since the last press or repeat.
+	volatile boolean activity;
+};
 
 
-Human_Machine_Interface::Human_Machine_Interface() : UIstate(0)
+class Timer1_Scheduler
 {
+public:
+	Timer1_Scheduler();	// Constructor
 
-	breakTime(0, tid);
-
-	// Standard constructor procedure:
-	//	give variables values by constructor : var_name(var_val) {}
+	/**
+	 * \brief Sets Timer1 up stopped, with the compare interrupt enabled. It runs while a deadline is armed.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void timerInit(void);
 
+	/**
+	 * \brief Returns the time base in ticks of 64 us. It only advances while a deadline is armed.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint32_t
+	 */
+	uint32_t timerNow(void);
 
-// old constructor code
-// 	UIstate = 0;
-// 	time_t temp = 0;
-// 	tid = HMI.ConvTotm(temp);
-// 	tid.Hour = 8;
-// 	tid.Minute = 30;
-}
+	/**
+	 * \brief Arms a deadline ticks from now, replacing one the slot had. Use TMRms for ms.
+	 * 
+	 * \param uint8_t slot - TMRclock or TMRrelay, uint32_t ticks
+	 * 
+	 * \return void
+	 */
+	void timerStart(uint8_t slot, uint32_t ticks);
 
-void Human_Machine_Interface::printDateTime(time_t t)
-{
-	// Print the current time to serial with time_t as input.
-	Serial << ((day(t)<10) ? "0" : "") << _DEC(day(t)) << ' ';
-	Serial << (month(t)) << " " << _DEC(year(t)) << ' ';
-	Serial << ((hour(t)<10) ? "0" : "") << _DEC(hour(t)) << ':';
-	Serial << ((minute(t)<10) ? "0" : "") << _DEC(minute(t)) << ':';
-	Serial << ((second(t)<10) ? "0" : "") << _DEC(second(t));
-}
+	/**
+	 * \brief Disarms a deadline, Timer1 stops if it was the last.
+	 * 
+	 * \param uint8_t slot
+	 * 
+	 * \return void
+	 */
+	void timerCancel(uint8_t slot);
 
-void Human_Machine_Interface::printDateTime(tmElements_t TM)
-{
-	// Print the current time to serial with tmElements_t as input.
-	Serial << ((TM.Day<10) ? "0" : "") << TM.Day << ' ';
-	Serial << (TM.Month) << ' ';
-	Serial << ((TM.Hour<10) ? "0" : "") << TM.Hour << ':';
-	Serial << ((TM.Minute<10) ? "0" : "") << TM.Minute << ':';
-	Serial << ((TM.Second<10) ? "0" : "") << TM.Second << endl;
-}
+	/**
+	 * \brief Re-arms a slot that expired ticks after its last deadline, without drift. Called from the ISR.
+	 * 
+	 * \param uint8_t slot, uint32_t ticks
+	 * 
+	 * \return void
+	 */
+	void timerRepeat(uint8_t slot, uint32_t ticks);
 
-uint8_t Human_Machine_Interface::read_LCD_buttons(void)
-{
-	// read the value from the sensor
-	int adc_key_in = analogRead(btnPIN);
-	
-	if (adc_key_in > 1050) return btnRESET;
-	if (adc_key_in < 50)   return btnRIGHT;
-	if (adc_key_in < 250)  return btnUP;
-	if (adc_key_in < 450)  return btnDOWN;
-	if (adc_key_in < 650)  return btnLEFT;
-	if (adc_key_in < 850)  return btnSELECT;
-	
-	return 0;                // when all others fail, return 0.
-}
+	/**
+	 * \brief Disarms and returns the deadlines that have passed, one bit per slot. Called from ISR(TIMER1_COMPA_vect).
+	 * 
+	 * \param void
+	 * 
+	 * \return uint8_t
+	 */
+	uint8_t timerExpired(void);
 
-void Human_Machine_Interface::UIupdate(void)
-{
- 	uint8_t userState = 0;
-	if (UIdelay >= UIbtnHold)
-	{
-		UIdelay = 0;
-		UIdelayStat = 0;
+	/**
+	 * \brief Sets OCR1A to the nearest deadline, or one TMRstep ahead, or stops Timer1 if none is armed.
+	 *	Called with interrupts off.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void timerProgram(void);
 
-		userState = btnStat;	// insert user input here.
-		btnStat = 0;
-	}
-	else
-	{
-		UIdelayStat = 1;
-	}
+protected:
+private:
+	/**
+	 * \brief Adds the ticks since the last call to base, with interrupts off.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void timerAdvance(void);
 
-//	userState = HMI.read_LCD_buttons();
+	uint32_t deadline[TMRslots];	// In base ticks.
+	volatile uint32_t base;			// Time base when TCNT1 was last.
+	volatile uint16_t last;
+	volatile uint8_t armed;			// One bit per slot.
+};
 
-	switch (UIstate)
-	{
-		case 0:
-			// Update tid with time from DS3231
-			breakTime(RTC.get(), tid);
 
-			// Print time here on LCD
-			lcd.noBlink();
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Klokkeslaet";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
+class TWI_Engine
+{
+public:
+	TWI_Engine();	// Constructor
 
-			// user input
-			switch (userState)
+	/**
+	 * \brief Sets the TWI up for TWIclock, with the pull-ups of SDA and SCL on.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void twiInit(void);
+
+	/**
+	 * \brief Queues a transfer and returns at once, the bus is started if it was idle.
+	 *	Its done function is called from the ISR when it has ended.
+	 * 
+	 * \param request
+	 * 
+	 * \return boolean - false if the request is still pending or the queue is full
+	 */
+	boolean twiSubmit(TWI_Request &request);
+
+	/**
+	 * \brief Whether a request was submitted and has not ended yet.
+	 * 
+	 * \param request
+	 * 
+	 * \return boolean
+	 */
+	boolean twiPending(const TWI_Request &request);
+
+	/**
+	 * \brief Whether any transfer is queued or on the bus.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean twiBusy(void);
+
+	/**
+	 * \brief Idles until the queue is empty, at most the timeouts of the queued requests.
+	 *	For setup() only, loop() waits for the done functions instead.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void twiWait(void);
+
+	/**
+	 * \brief Advances the transfer on the bus by one step, called from ISR(TWI_vect).
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void twiService(void);
+
+	/**
+	 * \brief Tries a paused request again, or aborts the one past its timeout. Called for TMRtwi.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void twiTimer(void);
+
+	/**
+	 * \brief Returns the number of transfers that were not acknowledged, failed or timed out, since boot.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint16_t
+	 */
+	uint16_t twiErrors(void);
+
+	/**
+	 * \brief Returns the number of times a slave held SDA low and was clocked free, since boot.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint16_t
+	 */
+	uint16_t twiRecoveries(void);
+
+protected:
+private:
+	/**
+	 * \brief Makes the oldest request current and arms its timeout, with interrupts off.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void twiBegin(void);
+
+	/**
+	 * \brief Ends the current request with status and calls its done function.
+	 * 
+	 * \param status
+	 * 
+	 * \return void
+	 */
+	void twiFinish(uint8_t status);
+
+	/**
+	 * \brief Sends a STOP if stop is set, and a START for the next request if there is one.
+	 * 
+	 * \param stop
+	 * 
+	 * \return void
+	 */
+	void twiNext(boolean stop);
+
+	/**
+	 * \brief Takes the TWI off the pins, frees the bus and ends the current request with status.
+	 * 
+	 * \param status
+	 * 
+	 * \return void
+	 */
+	void twiAbort(uint8_t status);
+
+	/**
+	 * \brief Clocks SCL by hand until the slave releases SDA, then makes a STOP. The TWI must be off.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void twiRecover(void);
+
+	TWI_Request *queue[TWIqueue];
+	volatile uint8_t head, tail;	// twiSubmit adds at head, the current request is at tail.
+	volatile boolean running;		// A request is current, on the bus or paused.
+	boolean paused;					// Between two tries of the current request.
+	boolean reading;				// The current request is past its repeated start.
+	uint8_t index;					// Bytes of the current phase sent or received.
+	uint32_t deadline;				// Timers.timerNow() the current request times out at.
+	uint16_t errors;
+	uint16_t recoveries;
+};
+
+
+// Packed BCD of the DS3231 registers.
+constexpr uint8_t bcd2dec(uint8_t n) { return n - 6 * (n >> 4); }
+constexpr uint8_t dec2bcd(uint8_t n) { return n + 6 * (n / 10); }
+
+class DS3231_Driver
+{
+public:
+	DS3231_Driver();	// Constructor
+
+	/**
+	 * \brief Queues a read of registers 0x00-0x0F of the DS3231 in one transaction, the register
+	 *	pointer and the data with a repeated start in between. When it ends the copy is updated
+	 *	and Clock and RTC_alarm are told. The other calls decode this copy.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean - false if the read could not be queued
+	 */
+	boolean rtcRead(void);
+
+	/**
+	 * \brief Whether a read is queued or on the bus.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean rtcReading(void);
+
+	/**
+	 * \brief Whether the last read that ended succeeded, so the copy is what the DS3231 holds.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean rtcAnswered(void);
+
+	/**
+	 * \brief Takes the registers of a read that ended into the copy, called by rtcReadDone.
+	 * 
+	 * \param ok - the read succeeded
+	 * 
+	 * \return void
+	 */
+	void rtcReadEnded(boolean ok);
+
+	/**
+	 * \brief Ends a write, called by rtcWriteDone.
+	 * 
+	 * \param request
+	 * 
+	 * \return void
+	 */
+	void rtcWriteEnded(TWI_Request &request);
+
+	/**
+	 * \brief Whether the copy was read after the last alarm interrupt, so its flags are current.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean rtcFresh(void);
+
+	/**
+	 * \brief Marks the copy as older than an alarm, called by alarmIsr.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void rtcStale(void);
+
+	/**
+	 * \brief Decodes the time of the copy.
+	 * 
+	 * \param TM
+	 * 
+	 * \return void
+	 */
+	void rtcTime(tmElements_t &TM);
+
+	/**
+	 * \brief Decodes alarm 1 or 2 of the copy: its time of day, and the date or day of the week it matches.
+	 * 
+	 * \param alarm, TM
+	 * 
+	 * \return uint8_t - ALMdaily, ALMdate or ALMweekday
+	 */
+	uint8_t rtcAlarmTime(uint8_t alarm, tmElements_t &TM);
+
+	/**
+	 * \brief Whether the interrupt of alarm 1 or 2 is enabled in the copy.
+	 * 
+	 * \param alarm
+	 * 
+	 * \return boolean
+	 */
+	boolean rtcEnabled(uint8_t alarm);
+
+	/**
+	 * \brief The flags of the copy of the alarms whose interrupt is enabled.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint8_t - DSa1f and DSa2f
+	 */
+	uint8_t rtcAlarms(void);
+
+	/**
+	 * \brief Clears the given alarm flags with one write of the status register, the others stay.
+	 *	RTC_alarm.alarm_Rearm is called once the write has ended.
+	 * 
+	 * \param flags - DSa1f and DSa2f
+	 * 
+	 * \return boolean - false if the write could not be queued
+	 */
+	boolean rtcClear(uint8_t flags);
+
+	/**
+	 * \brief Writes the time in one transaction, which also restarts the countdown chain of the DS3231.
+	 * 
+	 * \param t
+	 * 
+	 * \return boolean - false if the write could not be queued
+	 */
+	boolean rtcSet(time_t t);
+
+	/**
+	 * \brief Sets alarm 1 or 2 to t, enables its interrupt and clears its flag, with one write
+	 *	from its first register through the status register.
+	 * 
+	 * \param alarm, t, match - ALMdaily, ALMdate or ALMweekday
+	 * 
+	 * \return boolean - false if the write could not be queued
+	 */
+	boolean rtcAlarm(uint8_t alarm, time_t t, uint8_t match);
+
+	/**
+	 * \brief Disables the interrupt of alarm 1 or 2 and clears its flag, with one write of control and status.
+	 * 
+	 * \param alarm
+	 * 
+	 * \return boolean - false if the write could not be queued
+	 */
+	boolean rtcDisable(uint8_t alarm);
+
+protected:
+private:
+	/**
+	 * \brief Takes registers first to last of r into the copy and queues a write of them, in one
+	 *	transaction. If all write requests are pending, the registers are written from the copy
+	 *	when one of them has ended, together with any others that wait.
+	 * 
+	 * \param r, first, last, clear, rearm - r is indexed by register, clear are the alarm flags
+	 *	the write clears, rearm calls RTC_alarm.alarm_Rearm when the write has ended
+	 * 
+	 * \return boolean - false if the write could not be queued
+	 */
+	boolean rtcWrite(const uint8_t *r, uint8_t first, uint8_t last, uint8_t clear, boolean rearm = false);
+
+	/**
+	 * \brief Queues write request w of registers first to last of the copy, with interrupts off.
+	 * 
+	 * \param w, first, last, clear, rearm - as rtcWrite
+	 * 
+	 * \return boolean - false if the write could not be queued
+	 */
+	boolean rtcSubmit(uint8_t w, uint8_t first, uint8_t last, uint8_t clear, boolean rearm);
+
+	/**
+	 * \brief The status register to write that clears the given flags and keeps the rest.
+	 * 
+	 * \param flags
+	 * 
+	 * \return uint8_t
+	 */
+	uint8_t rtcStatusClearing(uint8_t flags);
+
+	uint8_t regs[DSburst];	// Copy of registers 0x00-0x0F
+	volatile boolean fresh;	// Read since the last alarm interrupt
+	volatile boolean again;	// Read once more, rtcRead was called while the read was on the bus
+	volatile boolean answered;	// The last read succeeded
+
+	TWI_Request reading;
+	uint8_t in[DSburst];	// Registers of the read, until it has ended
+	TWI_Request writing[DSwrites];
+	uint8_t out[DSwrites][DSburst];
+	uint8_t clear[DSwrites];		// Alarm flags the write clears
+	boolean rearm[DSwrites];
+	boolean retried[DSwrites];
+	boolean deferred;		// Registers deferFirst to deferLast of the copy wait for a write request.
+	uint8_t deferFirst;
+	uint8_t deferLast;
+	uint8_t deferClear;
+	boolean deferRearm;
+};
+
+
+class Software_Clock
+{
+public:
+	Software_Clock();	// Constructor
+
+	/**
+	 * \brief Starts reading the time from the DS3231, clockSynced restarts the second counter with it.
+	 *	The phase of the seconds is only known to within half a second.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void clockSync(void);
+
+	/**
+	 * \brief Takes the time of the read clockSync started, called by DS3231_Driver::rtcReadEnded.
+	 *	clockUpdate applies it.
+	 * 
+	 * \param ok - the read succeeded, otherwise the clock keeps counting on its own
+	 * 
+	 * \return void
+	 */
+	void clockSynced(boolean ok);
+
+	/**
+	 * \brief Whether the read clockSync started has not ended yet, clockNow is still the old time.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean clockSyncing(void);
+
+	/**
+	 * \brief Whether a read of clockSync has ended with a time that clockUpdate has not applied yet.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean clockLoaded(void);
+
+	/**
+	 * \brief Waits for the read clockSync started and applies it, for setup() only.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void clockWait(void);
+
+	/**
+	 * \brief Writes a new time to the DS3231 and the clock.
+	 * 
+	 * \param t
+	 * 
+	 * \return void
+	 */
+	void clockSet(time_t t);
+
+	/**
+	 * \brief Adds the seconds counted by Timer1 since the last call, re-syncs every CLKresync seconds.
+	 *	Should be called every loop() pass.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void clockUpdate(void);
+
+	/**
+	 * \brief Returns the current time without touching the I2C bus.
+	 * 
+	 * \param void
+	 * 
+	 * \return tmElements_t
+	 */
+	tmElements_t clockGet(void);
+
+	/**
+	 * \brief Returns the current time as time_t.
+	 * 
+	 * \param void
+	 * 
+	 * \return time_t
+	 */
+	time_t clockNow(void);
+
+protected:
+private:
+	/**
+	 * \brief Adds one second to tm, carrying into minutes, hours, days, months and years.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void clockAdvance(void);
+
+	tmElements_t tm;
+	uint16_t sinceSync;		// Seconds since the last clockSync.
+	tmElements_t next;		// Time read by clockSync, until clockUpdate applies it.
+	volatile boolean syncing;	// clockSync waits for the DS3231.
+	volatile boolean loaded;	// next holds a time.
+};
+
+
+class Human_Machine_Interface
+{
+public:
+	Human_Machine_Interface();
+	
+	/**
+	* \brief Takes in variable of type time_t and prints contents to serial or LCD. 
+	*	Text is 20 characters long.
+	* 
+	* \param t
+	* 
+	* \return void
+	 */
+	void printDateTime(time_t t);
+	
+	/**
+	 * \brief Takes in variable of type tmElements_t and prints contents to serial or LCD. 
+	 *	Does not print year, text is 15 characters long.
+	 * 
+	 * \param TM
+	 * 
+	 * \return void
+	 */
+	void printDateTime(tmElements_t TM);
+
+	/**
+	 * \brief Returns the debounced button held down right now.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint8_t
+	 */
+	uint8_t read_LCD_buttons(void);
+	
+	/**
+	 * \brief handles user input/output, should be called regurlarly
+	 * 
+	 * \param uint8_t event - EVTkey argument to handle, 0 for none
+	 * 
+	 * \return void
+	 */
+	void UIupdate(uint8_t event = 0);
+
+	/**
+	 * \brief Returns the state the UI is currently in.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint8_t
+	 */
+	uint8_t UIgetState(void);
+
+protected:
+private:
+	/**
+	 * \brief Copies the clock or an alarm into tid.
+	 * 
+	 * \param field
+	 * 
+	 * \return void
+	 */
+	void UIloadField(uint8_t field);
+
+	/**
+	 * \brief Writes tid to the clock or an alarm.
+	 * 
+	 * \param field
+	 * 
+	 * \return void
+	 */
+	void UIsaveField(uint8_t field);
+
+	/**
+	 * \brief Steps one digit of a two digit value up or down. The digit wraps around,
+	 *	and the value never exceeds max (23 for hours, 59 for minutes).
+	 * 
+	 * \param value, max, tens, up
+	 * 
+	 * \return uint8_t
+	 */
+	uint8_t UIeditDigit(uint8_t value, uint8_t max, boolean tens, boolean up);
+
+	uint8_t UIstate;
+	tmElements_t tid;
+};
+
+
+class DS3231RTC_Alarms
+{
+public:
+	DS3231RTC_Alarms();	// Constructor
+	
+	/**
+	* \brief Initializes the alarms and the interrupt. Waits for the registers, for setup() only.
+	* 
+	* \param 
+	* 
+	* \return void
+	*/
+	void init_alarms(void);
+
+	/**
+	 * \brief Sets both alarms from Config, or only disables alarm 2 for the weekly schedule.
+	 *	Queues the writes and returns, the copy of the registers has to be read already.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void alarm_restore(void);
+	
+	/**
+	 * \brief Takes in pointer, checks whether alarm1 or alarm2 have been triggered. Called for EVTalarm.
+	 *	Both flags come from one burst read and are cleared with one write. If the copy of the
+	 *	registers is older than the interrupt, a read is queued and EVTalarm posted again when it
+	 *	has ended. If both alarms fired, alarm1 is reported now and alarm2 on the next pass.
+	 * 
+	 * \param uint8_t * - 1, 2, or 0 if neither flag was set or the read is pending
+	 * 
+	 * \return void
+	 */
+	void alarm_Check(uint8_t *stat);
+
+	/**
+	 * \brief Posts EVTalarm for alarm_Check once the read it queued has ended, called by
+	 *	DS3231_Driver::rtcReadEnded.
+	 * 
+	 * \param ok - the read succeeded
+	 * 
+	 * \return void
+	 */
+	void alarm_Read(boolean ok);
+
+	/**
+	 * \brief Re-enables INT0 once the flags are cleared, and posts EVTalarm if the line is still low.
+	 *	Called when the write of rtcClear has ended.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void alarm_Rearm(void);
+
+	/**
+	 * \brief Whether an alarm is queued or alarm_Check waits for its read.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean alarm_Pending(void);
+	
+	/**
+	 * \brief returns the time when alarm1 is expected
+	 * 
+	 * \param void
+	 * 
+	 * \return time_t
+	 */
+	time_t alarm1_get(void);
+
+	/**
+	 * \brief returns the time when alarm2 is expected
+	 * 
+	 * \param void
+	 * 
+	 * \return time_t
+	 */
+	time_t alarm2_get(void);
+
+	/**
+	 * \brief Takes in tmElements_t and sets timer1 to trigger once a day.
+	 *	Only uses seconds, minutes and hours.
+	 * 
+	 * \param TM
+	 * 
+	 * \return boolean
+	 */
+	void alarm1_set(tmElements_t TM);
+	
+	/**
+	 * \brief Takes in tmElements_t and sets timer2 to trigger once a day.
+	 *	Only uses seconds, minutes and hours.
+	 * 
+	 * \param TM
+	 * 
+	 * \return boolean
+	 */
+	void alarm2_set(tmElements_t TM);
+
+	/**
+	 * \brief Sets the DS3231 alarm to the hours, minutes and seconds of t, without saving it.
+	 * 
+	 * \param alarm, t, match - alarm is 1 or 2, match is ALMdaily, ALMdate or ALMweekday
+	 * 
+	 * \return void
+	 */
+	void alarm_program(uint8_t alarm, time_t t, uint8_t match = ALMdaily);
+
+	/**
+	 * \brief Stops the DS3231 alarm from interrupting, until alarm_program sets it again.
+	 * 
+	 * \param alarm - 1 or 2
+	 * 
+	 * \return void
+	 */
+	void alarm_disable(uint8_t alarm);
+	
+protected:
+private:
+	uint8_t held;	// The other flag when both alarms fired, reported on the next pass
+	volatile boolean waiting;	// alarm_Check queued a read
+};
+
+
+// Number of relays in a mask, for the checks of Relay_Driver.
+constexpr uint8_t relayCount(uint8_t m) { return m ? (m & 1) + relayCount(m >> 1) : 0; }
+
+// Port registers of the relay array, as references the compiler can resolve.
+struct RA_PortD
+{
+	static volatile uint8_t &port(void) { return PORTD; }
+	static volatile uint8_t &ddr(void) { return DDRD; }
+};
+
+template <class Port, uint8_t OpenMask, uint8_t CloseMask, bool ActiveLow, uint8_t Topology>
+class Relay_Driver
+{
+public:
+	static const uint8_t mask = OpenMask | CloseMask;
+
+	/**
+	 * \brief Makes the relay pins outputs, switched off before they are driven.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	static void relayInit(void);
+
+	/**
+	 * \brief Switches the relays of one direction on and all others off, in one write of the port.
+	 * 
+	 * \param uint8_t dir - liftCW, liftCCW, anything else switches all off
+	 * 
+	 * \return void
+	 */
+	static void relayOn(uint8_t dir);
+
+	/**
+	 * \brief Switches all relays off, in one write of the port. Safe in the ISRs.
+	 *	RAbridge disables the H-bridge first, the relays never break the motor current.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	static void relayOff(void);
+
+	/**
+	 * \brief Sets the duty of the H-bridge enable on OC2B, 0 holds it low. Does nothing for RAremote.
+	 * 
+	 * \param uint8_t duty - 0 to RMPfull
+	 * 
+	 * \return void
+	 */
+	static void relayDuty(uint8_t duty);
+
+protected:
+private:
+	/**
+	 * \brief Writes the relays in on, the other pins of the port are kept. Interrupts are off for the write.
+	 * 
+	 * \param uint8_t on - the relays to switch on, the others in mask are switched off
+	 * 
+	 * \return void
+	 */
+	static void relayWrite(uint8_t on);
+
+	static_assert(OpenMask && CloseMask, "Relay_Driver: each direction needs a relay");
+	static_assert(!(OpenMask & CloseMask), "Relay_Driver: a relay can not serve both directions");
+	static_assert((Topology != RAbridge) || ((relayCount(OpenMask) == 2) && (relayCount(CloseMask) == 2)),
+		"Relay_Driver: an H-bridge switches one high side and one low side relay per direction");
+};
+
+typedef Relay_Driver<RA_PortD, RAopenMask, RAcloseMask, RAactiveLow, RAtopology> RA_Relays;
+
+
+class liftRelayArray
+{
+public:
+	liftRelayArray();	// Constructor
+
+	/**
+	 * \brief Initializes the pins required
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void relayArrayInit(void);
+
+	/**
+	 * \brief Executes a command for the lift without waiting. The lift is not started towards an end whose switch is closed.
+	 *	All relays go off first, the lift starts when the dead time has passed and runs until its end switch,
+	 *	or until hold or liftHold has passed, whichever is first.
+	 * 
+	 * \param cmd - liftCW, liftCCW, liftSTOP, hold - ms the lift runs, 0 to run to the end switch
+	 * 
+	 * \return boolean - true if the start was accepted
+	 */
+	boolean relayArrayCommand(uint8_t cmd, uint16_t hold = 0);
+
+	/**
+	 * \brief Switches RApending on at the end of the dead time, unless its end switch has closed meanwhile.
+	 *	Called from ISR(TIMER1_COMPA_vect).
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void relayStart(void);
+
+	/**
+	 * \brief Takes the PWM ramp of RAbridge one step further. Called from ISR(TIMER1_COMPA_vect) for TMRramp.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void relayRamp(void);
+
+	/**
+	 * \brief Returns how far the running lift has come, in ticks at full speed. Time at a lower duty counts less.
+	 *	Call with interrupts off.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint32_t
+	 */
+	uint32_t relayTravel(void);
+	
+	/**
+	 * \brief Function that controls what actually should happen when alarm happens.
+	 * 
+	 * \param uint8_t alarmtrig, hold - ms the lift runs if it starts now, 0 to run to the end switch
+	 * 
+	 * \return void
+	 */
+	void relayAutoCommand(uint8_t alarmtrig, uint16_t hold = 0);
+
+	/**
+	 * \brief Logs a stop of the lift by an ISR, and times it if it was a full run.
+	 * 
+	 * \param const EVT_Entry &event - EVTswitch, EVTdeadline, EVTtimed or EVTthere
+	 * 
+	 * \return void
+	 */
+	void relayEvent(const EVT_Entry &event);
+
+	/**
+	 * \brief Returns where the door is.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint8_t - POSunknown, POSopen, POSclosed, POSopening or POSclosing
+	 */
+	uint8_t relayPosition(void);
+
+	/**
+	 * \brief Returns the travel time statistics of one direction.
+	 * 
+	 * \param uint8_t dir - liftCW or liftCCW
+	 * 
+	 * \return const LFT_Stats &
+	 */
+	const LFT_Stats &relayStats(uint8_t dir);
+
+	/**
+	 * \brief Forgets the travel times of both directions, e.g. after the lift has been serviced.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void relayStatsClear(void);
+	
+protected:
+private:
+	/**
+	 * \brief Adds the travel time of a full run to the statistics of its direction, and reports it if it is off the mean.
+	 * 
+	 * \param uint8_t dir - liftCW or liftCCW, uint16_t ms
+	 * 
+	 * \return void
+	 */
+	void relayRecord(uint8_t dir, uint16_t ms);
+
+	/**
+	 * \brief Sets the duty of the H-bridge enable and adds the travel at the old duty to RMPtravel.
+	 * 
+	 * \param uint8_t duty
+	 * 
+	 * \return void
+	 */
+	void relayDuty(uint8_t duty);
+
+	LFT_Stats stats[2];	// liftCW, liftCCW
+};
+
+
+class Power_Manager
+{
+public:
+	Power_Manager();	// Constructor
+
+	/**
+	 * \brief Selects the pin change interrupts used for waking up, call after the other inits.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void powerInit(void);
+
+	/**
+	 * \brief Marks the user as present, keeps the tick running and turns the LCD back on.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void powerActivity(void);
+
+	/**
+	 * \brief Sleeps until the next loop() pass is due. Idles for PWRloopPeriod while busy,
+	 *	otherwise powers down until an alarm, a key or serial input. The journal is written
+	 *	first, and after power-down it idles until the clock has been read again.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void powerWait(void);
+
+protected:
+private:
+	/**
+	 * \brief Returns true while the lift is moving, the UI is in use or a transfer is on the I2C bus.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean powerBusy(void);
+
+	/**
+	 * \brief Powers down with the tick, ADC and LCD off.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void powerDown(void);
+
+	unsigned long lastActivity;	// millis() of the last key press.
+	boolean displayOn;
+	boolean flushed;			// The journal was written for the next power-down.
+};
+
+
+class Serial_Console : public Print
+{
+public:
+	Serial_Console();	// Constructor
+
+	/**
+	 * \brief Sends what fits in the UART buffer, and takes up to CONrxPerPass received bytes.
+	 *	A complete line is executed once its reply fits, CONreplyMax. Should be called every loop() pass.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void consolePoll(void);
+
+	/**
+	 * \brief Returns true while output is queued or a line has been started.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean consoleBusy(void);
+
+	/**
+	 * \brief Returns how many characters fit in the output queue.
+	 *
+	 * \param void
+	 *
+	 * \return uint8_t
+	 */
+	uint8_t consoleFree(void);
+
+	/**
+	 * \brief Queues one character for sending, used by print() and <<. Counted as dropped if the queue is full.
+	 * 
+	 * \param c
+	 * 
+	 * \return size_t
+	 */
+	virtual size_t write(uint8_t c);
+	using Print::write;
+
+	/**
+	 * \brief Prints a number with a leading zero below 10.
+	 * 
+	 * \param val, delim - delim is printed after the number unless it is 0
+	 * 
+	 * \return void
+	 */
+	void consoleI00(uint8_t val, char delim);
+
+protected:
+private:
+	/**
+	 * \brief Runs the command in line.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void consoleExecute(void);
+
+	/**
+	 * \brief Reads up to count numbers separated by anything that is not a digit.
+	 * 
+	 * \param str, num, count
+	 * 
+	 * \return uint8_t - how many numbers were found
+	 */
+	uint8_t consoleNumbers(const char *str, uint16_t *num, uint8_t count);
+
+	/**
+	 * \brief Reads up to count numbers with an optional sign and up to two decimals, as hundredths.
+	 * 
+	 * \param str, num, count
+	 * 
+	 * \return uint8_t - how many numbers were found
+	 */
+	uint8_t consoleDecimals(const char *str, int32_t *num, uint8_t count);
+
+	/**
+	 * \brief Prints hundredths as a signed number with two decimals.
+	 * 
+	 * \param val
+	 * 
+	 * \return void
+	 */
+	void consoleHundredths(int16_t val);
+
+	/**
+	 * \brief Prints what the DS3231 holds from the read status queued, and the I2C error counts.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void consoleRtc(void);
+
+#if PRFenabled
+	/**
+	 * \brief Prints one line of the probes table: count, min, max and the histogram of a probe.
+	 * 
+	 * \param uint8_t probe
+	 * 
+	 * \return void
+	 */
+	void consoleProbe(uint8_t probe);
+#endif
+
+	/**
+	 * \brief Prints one line of the lift command: the travel times or the histogram of a direction.
+	 * 
+	 * \param uint8_t index - 0 to CONliftLines - 1
+	 * 
+	 * \return void
+	 */
+	void consoleLift(uint8_t index);
+
+	char line[CONline + 1];
+	uint8_t lineLength;
+	boolean lineOverflow;	// The line is longer than CONline and will be rejected.
+	uint8_t helpLine;		// Next line of CONhelp to queue, CONhelpLines when done.
+	boolean rtcLine;		// status waits for its read of the DS3231.
+	uint8_t liftLine;		// Next line of the lift command, CONliftLines when done.
+	uint16_t dropped;		// Characters the full ring did not take, not reported yet.
+#if PRFenabled
+	uint8_t probeLine;		// Next probe to print, PRFprobes when done.
+#endif
+	uint8_t tx[CONtx];
+	uint8_t txHead, txTail;
+};
+
+
+class Telemetry_Binary
+{
+public:
+	Telemetry_Binary();	// Constructor
+
+	/**
+	 * \brief Switches binary records on or off. Sends the time and the counters when switched on.
+	 *
+	 * \param on
+	 *
+	 * \return void
+	 */
+	void telemetryEnable(boolean on);
+
+	/**
+	 * \brief Returns true in binary mode, the text messages of loop() are left out then.
+	 *
+	 * \param void
+	 *
+	 * \return boolean
+	 */
+	boolean telemetryEnabled(void);
+
+	/**
+	 * \brief Sends the counters every TELperiod seconds. Should be called every loop() pass.
+	 *
+	 * \param void
+	 *
+	 * \return void
+	 */
+	void telemetryPoll(void);
+
+	/**
+	 * \brief Sends a TELtime record.
+	 *
+	 * \param void
+	 *
+	 * \return void
+	 */
+	void telemetryTime(void);
+
+	/**
+	 * \brief Sends a TELalarm record.
+	 *
+	 * \param alarm - 1 or 2
+	 *
+	 * \return void
+	 */
+	void telemetryAlarm(uint8_t alarm);
+
+	/**
+	 * \brief Sends a TELrelay record.
+	 *
+	 * \param cmd - liftCW, liftCCW, liftSTOP
+	 *
+	 * \return void
+	 */
+	void telemetryRelay(uint8_t cmd);
+
+	/**
+	 * \brief Sends a TELcounters record.
+	 *
+	 * \param void
+	 *
+	 * \return void
+	 */
+	void telemetryCounters(void);
+
+protected:
+private:
+	/**
+	 * \brief Queues one frame in the console output, or nothing if it does not fit.
+	 *
+	 * \param type, payload, length - payload starts with 4 bytes for the time, filled in here
+	 *
+	 * \return void
+	 */
+	void telemetryFrame(uint8_t type, uint8_t *payload, uint8_t length);
+
+	boolean enabled;
+	time_t lastCounters;
+};
+
+
+struct LOG_Entry
+{
+	uint8_t id;		// LOGalarm, LOGalarmSet, LOGfault, LOGdeviation
+	uint8_t arg;
+	time_t t;
+};
+
+class Event_Log
+{
+public:
+	Event_Log();	// Constructor
+
+	/**
+	 * \brief Queues an entry in constant time, or counts it as dropped if the queue is full.
+	 *	Never called from an ISR, the queue is only used by loop().
+	 * 
+	 * \param id, arg, t - see the LOG defines
+	 * 
+	 * \return void
+	 */
+	void logPost(uint8_t id, uint8_t arg, time_t t);
+
+	/**
+	 * \brief Prints queued entries to Console while it has room for a whole line.
+	 *	Called by Power_Manager::powerWait, when the work of the loop() pass is done.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void logDrain(void);
+
+	/**
+	 * \brief Returns true while entries or a drop count are waiting to be printed.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean logPending(void);
+
+protected:
+private:
+	/**
+	 * \brief Prints one entry.
+	 * 
+	 * \param entry
+	 * 
+	 * \return void
+	 */
+	void logPrint(const LOG_Entry &entry);
+
+	LOG_Entry queue[LOGqueue];
+	uint8_t head, tail;
+	uint16_t dropped;	// Entries lost since the last report.
+};
+
+
+class Config_Store
+{
+public:
+	Config_Store();	// Constructor
+
+	/**
+	 * \brief Reads every slot once and keeps the newest record with a valid CRC and version.
+	 *	Without one, the newest record of an older schema in CFGschemas, saved again in the current one.
+	 *	Only if no schema has a valid record, the alarms of version 1.2 if they were set, or the defaults.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean - true if a valid record was found
+	 */
+	boolean configLoad(void);
+
+	/**
+	 * \brief Writes the record to the slot after the newest one, with the next sequence number.
+	 *	Only bytes that differ from the EEPROM are written.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void configSave(void);
+
+	/**
+	 * \brief Returns the record in RAM, change it and call configSave to keep the change.
+	 * 
+	 * \param void
+	 * 
+	 * \return CFG_Record &
+	 */
+	CFG_Record &configGet(void);
+
+protected:
+private:
+	/**
+	 * \brief Returns the CRC of a record of any schema, over everything but its crc field.
+	 * 
+	 * \param record, length - of the record without the crc field
+	 * 
+	 * \return uint16_t
+	 */
+	uint16_t configCrc(const void *record, uint8_t length);
+
+	CFG_Record record;
+	uint8_t slot;		// Slot of the newest record, the next save goes to the one after.
+};
+
+
+class Journal_AT24C32
+{
+public:
+	Journal_AT24C32();	// Constructor
+
+	/**
+	 * \brief Finds the newest page, continues it in RAM and adds a JRNboot record.
+	 *	Call after the clock is running.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void journalInit(void);
+
+	/**
+	 * \brief Adds a record stamped with the current time to the page in RAM.
+	 *	A full page is written to the AT24C32 and a new one started. If a write is on the bus,
+	 *	the full page waits in RAM for it to end.
+	 * 
+	 * \param type, arg - see the JRN defines
+	 * 
+	 * \return void
+	 */
+	void journalAdd(uint8_t type, uint8_t arg);
+
+	/**
+	 * \brief Queues a write of the page in RAM to the AT24C32 if it holds records that are not written yet.
+	 *	A page still being written is written again by a later call.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean - true if a write was queued
+	 */
+	boolean journalFlush(void);
+
+	/**
+	 * \brief Ends a page read of the dump, called by journalReadDone.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void journalReadEnded(void);
+
+	/**
+	 * \brief Ends a page write, called by journalWriteDone.
+	 * 
+	 * \param ok - the AT24C32 took the page
+	 * 
+	 * \return void
+	 */
+	void journalWriteEnded(boolean ok);
+
+	/**
+	 * \brief Idle work: writes records older than JRNmaxAge and prints the journal while a dump runs.
+	 *	Called by Power_Manager::powerWait.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void journalPoll(void);
+
+	/**
+	 * \brief Starts printing the journal to Console, oldest page first.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void journalDump(void);
+
+	/**
+	 * \brief Returns true while a dump is running.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean journalBusy(void);
+
+protected:
+private:
+	/**
+	 * \brief Queues a read of length bytes of a page. It is retried while the AT24C32
+	 *	ends a write cycle, up to JRNpollMax ms.
+	 * 
+	 * \param index, buffer, length
+	 * 
+	 * \return boolean - false if the read could not be queued
+	 */
+	boolean journalFetch(uint8_t index, uint8_t *buffer, uint8_t length);
+
+	/**
+	 * \brief Copies a page to written and queues its write, with interrupts off.
+	 * 
+	 * \param index, buffer
+	 * 
+	 * \return boolean - false if the write could not be queued
+	 */
+	boolean journalWrite(uint8_t index, const uint8_t *buffer);
+
+	/**
+	 * \brief Starts an empty page at index, at time t.
+	 * 
+	 * \param index, t
+	 * 
+	 * \return void
+	 */
+	void journalStart(uint8_t index, time_t t);
+
+	/**
+	 * \brief Decodes the record at offset of a page, and moves offset past it.
+	 * 
+	 * \param buffer, offset, t - t is the time of the previous record, and becomes the time of this one
+	 * 
+	 * \return uint8_t - the first byte of the record, type and argument
+	 */
+	uint8_t journalDecode(const uint8_t *buffer, uint8_t *offset, time_t *t);
+
+	/**
+	 * \brief Prints the next record of the dump, reading the next page when needed.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean - false when the dump is done
+	 */
+	boolean journalDumpNext(void);
+
+	uint8_t page[JRNpage];	// Page being filled.
+	uint8_t pageIndex;
+	uint8_t pageLength;
+	uint16_t sequence;		// Sequence number of the page being filled.
+	time_t last;			// Time of the newest record.
+	volatile boolean dirty;	// page holds records not written yet.
+	time_t dirtySince;
+
+	TWI_Request reader;
+	TWI_Request writer;
+	uint8_t written[JRNpage];	// Copy of page being written.
+	uint8_t writeIndex;		// Page written by writer.
+	uint8_t full[JRNpage];	// Page that filled while writer was on the bus, journalWriteEnded writes it next.
+	uint8_t fullIndex;
+	volatile boolean fullWaiting;
+	uint8_t lost;			// Records dropped because two full pages waited for writer, since boot.
+
+	uint8_t dump[JRNpage];	// Page being printed.
+	uint8_t dumpIndex;
+	uint8_t dumpLeft;		// Pages still to print after dump.
+	uint8_t dumpOffset;		// 0 while no dump is running.
+	time_t dumpTime;
+	uint16_t dumpRecords;
+	boolean dumpReading;	// reader fetches the page after dumpIndex into dump.
+};
+
+
+class Solar_Schedule
+{
+public:
+	Solar_Schedule();	// Constructor
+
+	/**
+	 * \brief In SUNfixed and SUNtable, sets each DS3231 alarm to its next day's time once it has passed.
+	 *	Should be called every loop() pass, after alarm_Check.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void sunPoll(void);
+
+	/**
+	 * \brief Makes the next sunPoll set the alarms, after the clock or the configuration changed.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void sunInvalidate(void);
+
+	/**
+	 * \brief Calculates sunrise and sunset at the place in Config, in fixed point.
+	 *	Uses the NOAA approximations of the declination and the equation of time.
+	 * 
+	 * \param day, rise, set - day of the year 1-366, times in minutes after midnight UTC
+	 * 
+	 * \return void
+	 */
+	void sunCompute(uint16_t day, uint16_t *rise, uint16_t *set);
+
+	/**
+	 * \brief Reads sunrise and sunset from SUNdays, for SUNtableLatitude and SUNtableLongitude.
+	 * 
+	 * \param day, rise, set - day of the year 1-366, times in minutes after midnight UTC
+	 * 
+	 * \return void
+	 */
+	void sunLookup(uint16_t day, uint16_t *rise, uint16_t *set);
+
+	/**
+	 * \brief Returns the day of the year of t, 1-366.
+	 * 
+	 * \param t
+	 * 
+	 * \return uint16_t
+	 */
+	uint16_t sunDay(time_t t);
+
+protected:
+private:
+	/**
+	 * \brief sin() and cos() of a binary angle from SUNsin, interpolated, in Q15.
+	 * 
+	 * \param angle
+	 * 
+	 * \return int32_t
+	 */
+	int32_t sunSin(uint16_t angle);
+	int32_t sunCos(uint16_t angle);
+
+	/**
+	 * \brief acos() of a Q15 value by bisection, as a binary angle of 0 to 180 degrees.
+	 * 
+	 * \param x
+	 * 
+	 * \return uint16_t
+	 */
+	uint16_t sunAcos(int32_t x);
+
+	/**
+	 * \brief Returns the first opening or closing time after 'after', on its day or the next.
+	 * 
+	 * \param after, open
+	 * 
+	 * \return time_t
+	 */
+	time_t sunNext(time_t after, boolean open);
+
+	time_t armed[2];	// Times alarm1 and alarm2 are set to, 0 to set them on the next pass.
+};
+
+
+class Week_Schedule
+{
+public:
+	Week_Schedule();	// Constructor
+
+	/**
+	 * \brief Reads the table header from the EEPROM, an empty table if its CRC does not match.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void weekLoad(void);
+
+	/**
+	 * \brief In SCHweekly, turns alarm 1 into the action of the event that fired and arms ALARM_1
+	 *	with the next event. Also streams the list started by weekDump. Call after alarm_Check.
+	 * 
+	 * \param alarm_stat - from alarm_Check, replaced by SCHopen or SCHclose
+	 * 
+	 * \return void
+	 */
+	void weekPoll(uint8_t *alarm_stat);
+
+	/**
+	 * \brief Makes the next weekPoll arm ALARM_1, after the clock or the table changed.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void weekInvalidate(void);
+
+	/**
+	 * \brief Adds an event to the table, or replaces the event at the same minute.
+	 * 
+	 * \param minute, action, hold - minute of the week from Sunday 00:00, SCHopen or SCHclose, tenths of a second or 0
+	 * 
+	 * \return boolean - false if the table is full
+	 */
+	boolean weekAdd(uint16_t minute, uint8_t action, uint8_t hold);
+
+	/**
+	 * \brief Removes an event, later events move down one place.
+	 * 
+	 * \param index
+	 * 
+	 * \return void
+	 */
+	void weekDelete(uint8_t index);
+
+	/**
+	 * \brief Returns an event of the table.
+	 * 
+	 * \param index
+	 * 
+	 * \return SCH_Entry
+	 */
+	SCH_Entry weekGet(uint8_t index);
+
+	/**
+	 * \brief Returns how many events the table holds.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint8_t
+	 */
+	uint8_t weekCount(void);
+
+	/**
+	 * \brief Returns the run time of the event that fired last, in ms, 0 to run to the end switch.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint16_t
+	 */
+	uint16_t weekHold(void);
+
+	/**
+	 * \brief Starts listing the table on the console, a line at a time from weekPoll.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void weekDump(void);
+
+	/**
+	 * \brief Returns true while the list is being printed.
+	 * 
+	 * \param void
+	 * 
+	 * \return boolean
+	 */
+	boolean weekBusy(void);
+
+protected:
+private:
+	/**
+	 * \brief Binary search for the first event at or after minute.
+	 * 
+	 * \param minute
+	 * 
+	 * \return uint8_t - count if there is none
+	 */
+	uint8_t weekFind(uint16_t minute);
+
+	/**
+	 * \brief Returns the minute of the week of t, from Sunday 00:00.
+	 * 
+	 * \param t
+	 * 
+	 * \return uint16_t
+	 */
+	uint16_t weekMinute(time_t t);
+
+	/**
+	 * \brief Sets ALARM_1 to the first event after now, wrapping to the next week. Right after ALARM_1 fired,
+	 *	the first event after armedTime, the clock may still show the minute before it.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void weekArm(void);
+
+	/**
+	 * \brief Writes count and a new CRC to the header.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void weekSeal(void);
+
+	uint8_t count;		// Events in the table
+	boolean armed;		// False to arm on the next weekPoll
+	uint16_t hold;		// Run time of the event that fired last
+	time_t armedTime;	// Time ALARM_1 is set to, 0 before the first weekArm
+	boolean fired;		// ALARM_1 fired at armedTime, weekArm has not run since
+	uint8_t dumpIndex;	// Next event to list, SCHidle if not listing
+};
+
+
+#if PRFenabled
+class Task_Profiler
+{
+public:
+	Task_Profiler();	// Constructor
+
+	/**
+	 * \brief Returns the time stamp a probe starts at, the low 16 bits of micros(). Timer0 runs free, in steps of 4 us.
+	 * 
+	 * \param void
+	 * 
+	 * \return uint16_t
+	 */
+	uint16_t prfNow(void);
+
+	/**
+	 * \brief Adds the time since start to a probe. A probe is only added to from one context, an ISR or loop().
+	 * 
+	 * \param uint8_t probe - PRFtimer1 to PRFui + UIscreenCount - 1, uint16_t start - from prfNow
+	 * 
+	 * \return void
+	 */
+	void prfAdd(uint8_t probe, uint16_t start);
+
+	/**
+	 * \brief Copies the statistics of a probe with interrupts off.
+	 * 
+	 * \param uint8_t probe, PRF_Stats &st
+	 * 
+	 * \return void
+	 */
+	void prfGet(uint8_t probe, PRF_Stats &st);
+
+	/**
+	 * \brief Clears all probes.
+	 * 
+	 * \param void
+	 * 
+	 * \return void
+	 */
+	void prfClear(void);
+
+protected:
+private:
+	PRF_Stats stats[PRFprobes];
+};
+#endif
+
+
+// make objects of the classes:
+Event_Queue Events;			// Make a object of the 'class Event_Queue' named 'Events'
+Timer1_Scheduler Timers;	// Make a object of the 'class Timer1_Scheduler' named 'Timers'
+TWI_Engine I2C;				// Make a object of the 'class TWI_Engine' named 'I2C'
+LCD_Framebuffer LCDfb(lcd);	// Make a object of the 'class LCD_Framebuffer' named 'LCDfb', drawing on 'lcd'
+Keypad_ADC Keypad;			// Make a object of the 'class Keypad_ADC' named 'Keypad'
+DS3231_Driver RTC;			// Make a object of the 'class DS3231_Driver' named 'RTC'
+Software_Clock Clock;		// Make a object of the 'class Software_Clock' named 'Clock'
+Human_Machine_Interface HMI;// Make a object of the 'class Human_Machine_Interface' named 'HMI'
+DS3231RTC_Alarms RTC_alarm;	// Make a object of the 'class DS3231RTC_Alarms' named 'RTC_alarm'
+liftRelayArray relayArray;	// Make a object of the 'class liftRelayArray' named 'relayArray'
+Power_Manager Power;		// Make a object of the 'class Power_Manager' named 'Power'
+Serial_Console Console;		// Make a object of the 'class Serial_Console' named 'Console'
+Telemetry_Binary Telemetry;	// Make a object of the 'class Telemetry_Binary' named 'Telemetry'
+Event_Log Log;				// Make a object of the 'class Event_Log' named 'Log'
+Config_Store Config;		// Make a object of the 'class Config_Store' named 'Config'
+Journal_AT24C32 Journal;	// Make a object of the 'class Journal_AT24C32' named 'Journal'
+Solar_Schedule Sun;			// Make a object of the 'class Solar_Schedule' named 'Sun'
+Week_Schedule Week;			// Make a object of the 'class Week_Schedule' named 'Week'
+#if PRFenabled
+Task_Profiler Profiler;		// Make a object of the 'class Task_Profiler' named 'Profiler'
+#endif
+
+
+Event_Queue::Event_Queue() : head(0), tail(0), dropped(0)
+{
+	// Constructor for the event queue, empty at boot.
+}
+
+void Event_Queue::eventPost(uint8_t type, uint8_t arg, uint16_t ms)
+{
+	uint8_t next = (head + 1) & (EVTqueue - 1);
+
+	if (next == tail)
+	{
+		dropped++;
+		return;
+	}
+	events[head].type = type;
+	events[head].arg = arg;
+	events[head].ms = ms;
+	head = next;	// Published last, loop() sees the whole entry.
+}
+
+boolean Event_Queue::eventGet(EVT_Entry &event)
+{
+	uint8_t t = tail;
+
+	if (t == head)
+	{
+		return false;
+	}
+	event = events[t];
+	tail = (t + 1) & (EVTqueue - 1);	// Freed only after the copy.
+	return true;
+}
+
+boolean Event_Queue::eventPending(uint8_t type)
+{
+	for (uint8_t t = tail; t != head; t = (t + 1) & (EVTqueue - 1))
+	{
+		if (!type || (events[t].type == type))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+uint8_t Event_Queue::eventDropped(void)
+{
+	return dropped;
+}
+
+LCD_Framebuffer::LCD_Framebuffer(LiquidCrystal &display) : lcd(display), col(0), row(0), lcdCol(LCDcols), lcdRow(0),
+	blinkCol(0), blinkRow(0), blinkOn(false), shownBlinkOn(false)
+{
+	// Constructor for the framebuffer, the LCD is blank after lcd.begin().
+	memset(frame, ' ', sizeof(frame));
+	memset(shown, ' ', sizeof(shown));
+	memset(dirty, 0, sizeof(dirty));
+}
+
+void LCD_Framebuffer::clear(void)
+{
+	for (uint8_t r = 0; r < LCDrows; r++)
+	{
+		for (uint8_t c = 0; c < LCDcols; c++)
+		{
+			frame[r][c] = ' ';
+			if (shown[r][c] == ' ')
+			{
+				dirty[r] &= ~(1 << c);
+			}
+			else
+			{
+				dirty[r] |= (1 << c);
+			}
+		}
+	}
+	col = 0;
+	row = 0;
+}
+
+void LCD_Framebuffer::setCursor(uint8_t col, uint8_t row)
+{
+	LCD_Framebuffer::col = col;
+	LCD_Framebuffer::row = row;
+}
+
+void LCD_Framebuffer::blink(void)
+{
+	blinkOn = true;
+	blinkCol = col;
+	blinkRow = row;
+}
+
+void LCD_Framebuffer::noBlink(void)
+{
+	blinkOn = false;
+}
+
+size_t LCD_Framebuffer::write(uint8_t c)
+{
+	// Characters beyond the visible area are dropped, like text past column 16 is on the LCD.
+	if (col >= LCDcols || row >= LCDrows)
+	{
+		return 0;
+	}
+
+	frame[row][col] = c;
+	if (shown[row][col] == (char)c)
+	{
+		dirty[row] &= ~(1 << col);
+	}
+	else
+	{
+		dirty[row] |= (1 << col);
+	}
+	col++;
+	return 1;
+}
+
+void LCD_Framebuffer::flush(void)
+{
+	boolean moved = false;	// Whether the LCD address counter moved away from the blink position.
+	PRFbegin(probe);
+
+	for (uint8_t r = 0; r < LCDrows; r++)
+	{
+		for (uint8_t c = 0; dirty[r] && c < LCDcols; c++)
+		{
+			if (!(dirty[r] & (1 << c)))
+			{
+				continue;
+			}
+
+			// The LCD increments its address after each character, so runs of changes need one setCursor.
+			if (lcdCol != c || lcdRow != r)
+			{
+				lcd.setCursor(c, r);
+			}
+			lcd.write(frame[r][c]);
+			shown[r][c] = frame[r][c];
+			dirty[r] &= ~(1 << c);
+			lcdCol = c + 1;
+			lcdRow = r;
+			moved = true;
+		}
+	}
+
+	if (blinkOn)
+	{
+		if (moved || !shownBlinkOn || lcdCol != blinkCol || lcdRow != blinkRow)
+		{
+			lcd.setCursor(blinkCol, blinkRow);
+			lcdCol = blinkCol;
+			lcdRow = blinkRow;
+		}
+		if (!shownBlinkOn)
+		{
+			lcd.blink();
+		}
+	}
+	else if (shownBlinkOn)
+	{
+		lcd.noBlink();
+	}
+	shownBlinkOn = blinkOn;
+	PRFend(PRFlcd, probe);
+}
+
+
+Keypad_ADC::Keypad_ADC() : candidate(btnRESET), integrator(0), stable(btnRESET), holdCount(0),
+	activity(false)
+{
+	// Constructor for the keypad, no key is held at boot.
+}
+
+void Keypad_ADC::keypadInit(void)
+{
+	noInterrupts();
+	ADMUX = (1 << REFS0) | (btnPIN - A0);	// AVcc reference, keypad channel.
+	ADCSRB = (1 << ADTS2);					// Trigger source Timer0 overflow, which the Arduino core runs for millis().
+	ADCSRA = (1 << ADEN) | (1 << ADATE) | (1 << ADIE) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);	// 125 kHz ADC clock.
+	interrupts();
+}
+
+uint8_t Keypad_ADC::keypadClassify(uint16_t adc)
+{
+	if (adc < 50)	return btnRIGHT;
+	if (adc < 250)	return btnUP;
+	if (adc < 450)	return btnDOWN;
+	if (adc < 650)	return btnLEFT;
+	if (adc < 850)	return btnSELECT;
+
+	return btnRESET;
+}
+
+void Keypad_ADC::keypadSample(uint16_t adc)
+{
+	uint8_t key = keypadClassify(adc);
+
+	// Integrate towards the candidate key, a different reading counts down and replaces it at 0.
+	if (key == candidate)
+	{
+		if (integrator < BTNdebounce)
+		{
+			integrator++;
+		}
+	}
+	else if (integrator)
+	{
+		integrator--;
+	}
+	else
+	{
+		candidate = key;
+	}
+
+	if ((integrator == BTNdebounce) && (candidate != stable))
+	{
+		if (stable != btnRESET)
+		{
+			Events.eventPost(EVTkey, BTNrelease | stable, 0);
+		}
+		stable = candidate;
+		if (stable != btnRESET)
+		{
+			Events.eventPost(EVTkey, BTNpress | stable, 0);
+			activity = true;
+		}
+		holdCount = 0;
+	}
+	else if ((stable != btnRESET) && (++holdCount >= BTNhold))
+	{
+		Events.eventPost(EVTkey, BTNrepeated | stable, 0);
+		holdCount = BTNhold - BTNrepeat;
+	}
+}
+
+uint8_t Keypad_ADC::keypadHeld(void)
+{
+	return stable;
+}
+
+boolean Keypad_ADC::keypadActivity(void)
+{
+	boolean pressed = activity;
+
+	activity = false;
+	return pressed;
+}
+
+
+Timer1_Scheduler::Timer1_Scheduler() : base(0), last(0), armed(0)
+{
+	// Constructor for the deadline scheduler, nothing is armed at boot.
+	memset(deadline, 0, sizeof(deadline));
+}
+
+void Timer1_Scheduler::timerInit(void)
+{
+	noInterrupts();
+	TCCR1A = 0;				// Normal mode, counting up to 0xFFFF.
+	TCCR1B = 0;				// Stopped until a deadline is armed.
+	TIMSK1 = (1 << OCIE1A);
+	last = TCNT1;
+	interrupts();
+}
+
+void Timer1_Scheduler::timerAdvance(void)
+{
+	uint16_t cnt = TCNT1;
+
+	base += (uint16_t)(cnt - last);	// At most one wrap since the last call, TMRstep sees to that.
+	last = cnt;
+}
+
+uint32_t Timer1_Scheduler::timerNow(void)
+{
+	uint8_t sreg = SREG;
+	uint32_t now;
+
+	noInterrupts();
+	now = base + (uint16_t)(TCNT1 - last);
+	SREG = sreg;
+	return now;
+}
+
+void Timer1_Scheduler::timerStart(uint8_t slot, uint32_t ticks)
+{
+	uint8_t sreg = SREG;
+
+	noInterrupts();
+	timerAdvance();
+	deadline[slot] = base + ticks;
+	armed |= (1 << slot);
+	timerProgram();
+	SREG = sreg;
+}
+
+void Timer1_Scheduler::timerCancel(uint8_t slot)
+{
+	uint8_t sreg = SREG;
+
+	noInterrupts();
+	armed &= ~(1 << slot);
+	timerProgram();
+	SREG = sreg;
+}
+
+void Timer1_Scheduler::timerRepeat(uint8_t slot, uint32_t ticks)
+{
+	deadline[slot] += ticks;
+	armed |= (1 << slot);
+}
+
+uint8_t Timer1_Scheduler::timerExpired(void)
+{
+	uint8_t expired = 0;
+
+	timerAdvance();
+	for (uint8_t i = 0; i < TMRslots; i++)
+	{
+		if ((armed & (1 << i)) && ((int32_t)(deadline[i] - base) < TMRsoon))
+		{
+			expired |= (1 << i);
+		}
+	}
+	armed &= ~expired;
+	return expired;
+}
+
+void Timer1_Scheduler::timerProgram(void)
+{
+	uint32_t next = TMRstep;
+	int32_t left;
+
+	timerAdvance();
+	if (!armed)
+	{
+		TCCR1B = 0;			// Nothing to wait for, no interrupts at all.
+		return;
+	}
+	for (uint8_t i = 0; i < TMRslots; i++)
+	{
+		left = (int32_t)(deadline[i] - base);
+		if ((armed & (1 << i)) && (left < (int32_t)next))
+		{
+			next = (left < TMRsoon) ? TMRsoon : left;
+		}
+	}
+	// One tick is 1024 cycles, TCNT1 can not pass OCR1A before it is written.
+	OCR1A = last + (uint16_t)next;
+	TCCR1B = (1 << CS12) | (1 << CS10);
+}
+
+
+TWI_Engine::TWI_Engine() : head(0), tail(0), running(false), paused(false), reading(false), index(0), deadline(0),
+	errors(0), recoveries(0)
+{
+	// Constructor for the TWI engine, idle until twiSubmit.
+}
+
+void TWI_Engine::twiInit(void)
+{
+	DDRC &= ~((1 << TWIsda) | (1 << TWIscl));
+	PORTC |= (1 << TWIsda) | (1 << TWIscl);	// Weak, the DS3231 module has 4.7k pull-ups of its own.
+	TWSR = 0;								// Prescaler 1
+	TWBR = ((F_CPU / TWIclock) - 16) / 2;
+	TWCR = (1 << TWEN);
+}
+
+boolean TWI_Engine::twiSubmit(TWI_Request &request)
+{
+	uint8_t sreg = SREG;
+
+	noInterrupts();
+	if (twiPending(request) || (((head - tail) & (2 * TWIqueue - 1)) == TWIqueue))
+	{
+		SREG = sreg;
+		return false;
+	}
+	request.status = TWIqueued;
+	queue[head & (TWIqueue - 1)] = &request;
+	head = (head + 1) & (2 * TWIqueue - 1);
+	if (!running)
+	{
+		twiBegin();
+		TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
+	}
+	SREG = sreg;
+	return true;
+}
+
+boolean TWI_Engine::twiPending(const TWI_Request &request)
+{
+	return (request.status == TWIqueued) || (request.status == TWIbusy);
+}
+
+boolean TWI_Engine::twiBusy(void)
+{
+	return running;
+}
+
+void TWI_Engine::twiWait(void)
+{
+	PRFbegin(probe);
+
+	// Every request ends by its timeout, which Timer1 keeps running for.
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	while (running)
+	{
+		sleep_mode();
+	}
+	PRFend(PRFtwiWait, probe);
+}
+
+void TWI_Engine::twiBegin(void)
+{
+	TWI_Request &r = *queue[tail & (TWIqueue - 1)];
+
+	running = true;
+	paused = false;
+	reading = !r.regLength && !r.txLength;
+	index = 0;
+	r.status = TWIbusy;
+	deadline = Timers.timerNow() + TMRms(r.timeout);
+	Timers.timerStart(TMRtwi, TMRms(r.timeout));
+}
+
+void TWI_Engine::twiFinish(uint8_t status)
+{
+	TWI_Request &r = *queue[tail & (TWIqueue - 1)];
+
+	tail = (tail + 1) & (2 * TWIqueue - 1);
+	if (status != TWIdone)
+	{
+		errors++;
+	}
+	r.status = status;
+	if (r.done)
+	{
+		r.done(r);		// May submit again, after the current request.
+	}
+}
+
+void TWI_Engine::twiNext(boolean stop)
+{
+	uint8_t control = (1 << TWINT) | (1 << TWEN) | (stop ? (1 << TWSTO) : 0);
+
+	if (head != tail)
+	{
+		twiBegin();
+		TWCR = control | (1 << TWSTA) | (1 << TWIE);	// The START follows the STOP.
+		return;
+	}
+	running = false;
+	Timers.timerCancel(TMRtwi);
+	TWCR = control;
+}
+
+void TWI_Engine::twiService(void)
+{
+	TWI_Request &r = *queue[tail & (TWIqueue - 1)];
+	uint8_t control = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+	uint32_t left;
+
+	switch (TW_STATUS)
+	{
+		case TW_START:
+		case TW_REP_START:
+			TWDR = (r.address << 1) | (reading ? TW_READ : TW_WRITE);
+			index = 0;
+		break;
+
+		case TW_MT_SLA_ACK:
+		case TW_MT_DATA_ACK:
+			if (index < r.regLength)
+			{
+				TWDR = r.reg[index++];
+			}
+			else if (index < r.regLength + r.txLength)
+			{
+				TWDR = r.tx[index++ - r.regLength];
+			}
+			else if (r.rxLength)
+			{
+				reading = true;
+				control |= (1 << TWSTA);	// Repeated start, the bus stays ours.
+			}
+			else
+			{
+				twiFinish(TWIdone);
+				twiNext(true);
+				return;
+			}
+		break;
+
+		case TW_MR_DATA_ACK:
+			r.rx[index++] = TWDR;
+			// fall through
+		case TW_MR_SLA_ACK:
+			if (index + 1 < r.rxLength)
+			{
+				control |= (1 << TWEA);		// Acknowledge all but the last byte.
+			}
+		break;
+
+		case TW_MR_DATA_NACK:
+			r.rx[index] = TWDR;
+			twiFinish(TWIdone);
+			twiNext(true);
+		return;
+
+		case TW_MT_SLA_NACK:
+		case TW_MR_SLA_NACK:
+			left = deadline - Timers.timerNow();
+			if (r.retry && ((int32_t)left > (int32_t)TMRms(TWIretry)))
+			{
+				// Busy, an EEPROM in its write cycle. Free the bus and try again later.
+				paused = true;
+				Timers.timerStart(TMRtwi, TMRms(TWIretry));
+				TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
+				return;
+			}
+			twiFinish(TWInack);
+			twiNext(true);
+		return;
+
+		case TW_MT_DATA_NACK:
+			twiFinish(TWInack);
+			twiNext(true);
+		return;
+
+		default:	// Arbitration lost or bus error, a glitch on the lines.
+			twiAbort(TWIfailed);
+		return;
+	}
+	TWCR = control;
+}
+
+void TWI_Engine::twiTimer(void)
+{
+	TWI_Request &r = *queue[tail & (TWIqueue - 1)];
+
+	if (!running)
+	{
+		return;
+	}
+	if (paused)
+	{
+		paused = false;
+		reading = !r.regLength && !r.txLength;
+		Timers.timerStart(TMRtwi, deadline - Timers.timerNow());
+		TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
+		return;
+	}
+	twiAbort(TWItimeout);	// A slave stretches SCL or holds SDA, or the TWI hangs.
+}
+
+uint16_t TWI_Engine::twiErrors(void)
+{
+	uint16_t n;
+
+	noInterrupts();
+	n = errors;
+	interrupts();
+	return n;
+}
+
+uint16_t TWI_Engine::twiRecoveries(void)
+{
+	uint16_t n;
+
+	noInterrupts();
+	n = recoveries;
+	interrupts();
+	return n;
+}
+
+void TWI_Engine::twiAbort(uint8_t status)
+{
+	TWCR = 0;		// The pins are port pins again.
+	twiRecover();
+	TWCR = (1 << TWEN);
+	twiFinish(status);
+	twiNext(false);
+}
+
+void TWI_Engine::twiRecover(void)
+{
+	uint8_t i;
+
+	// Open drain by hand: a pin is driven low as an output, and released as an input without pull-up.
+	PORTC &= ~((1 << TWIsda) | (1 << TWIscl));
+	if (!(PINC & (1 << TWIsda)))
+	{
+		recoveries++;
+	}
+	for (i = 0; (i < TWIrecover) && !(PINC & (1 << TWIsda)); i++)
+	{
+		DDRC |= (1 << TWIscl);
+		_delay_us(TWIhalfBit);
+		DDRC &= ~(1 << TWIscl);
+		_delay_us(TWIhalfBit);
+	}
+
+	// STOP, SDA rises while SCL is high. Every slave starts over.
+	DDRC |= (1 << TWIscl);
+	_delay_us(TWIhalfBit);
+	DDRC |= (1 << TWIsda);
+	_delay_us(TWIhalfBit);
+	DDRC &= ~(1 << TWIscl);
+	_delay_us(TWIhalfBit);
+	DDRC &= ~(1 << TWIsda);
+	_delay_us(TWIhalfBit);
+	PORTC |= (1 << TWIsda) | (1 << TWIscl);
+}
+
+
+DS3231_Driver::DS3231_Driver() : fresh(false), again(false), answered(false), deferred(false), deferFirst(0),
+	deferLast(0), deferClear(0), deferRearm(false)
+{
+	// Constructor for the DS3231 driver, the copy is empty until rtcRead.
+	uint8_t i;
+
+	memset(regs, 0, sizeof(regs));
+	memset(&reading, 0, sizeof(reading));
+	reading.address = DSaddr;
+	reading.reg[0] = DSseconds;
+	reading.regLength = 1;
+	reading.rx = in;
+	reading.rxLength = DSburst;
+	reading.timeout = DStimeout;
+	reading.done = rtcReadDone;
+	for (i = 0; i < DSwrites; i++)
+	{
+		memset(&writing[i], 0, sizeof(writing[i]));
+		writing[i].address = DSaddr;
+		writing[i].regLength = 1;
+		writing[i].tx = out[i];
+		writing[i].timeout = DStimeout;
+		writing[i].done = rtcWriteDone;
+		clear[i] = 0;
+		rearm[i] = false;
+		retried[i] = false;
+	}
+}
+
+boolean DS3231_Driver::rtcRead(void)
+{
+	boolean queued = true;
+
+	noInterrupts();
+	if (reading.status == TWIbusy)
+	{
+		again = true;	// Part of it may be older than the call.
+	}
+	else
+	{
+		fresh = true;	// Before the transfer, an alarm during it makes the copy stale again.
+		if (!I2C.twiPending(reading))
+		{
+			queued = I2C.twiSubmit(reading);
+			fresh = queued;
+		}
+	}
+	interrupts();
+	return queued;
+}
+
+boolean DS3231_Driver::rtcReading(void)
+{
+	return I2C.twiPending(reading);
+}
+
+boolean DS3231_Driver::rtcAnswered(void)
+{
+	return answered;
+}
+
+void DS3231_Driver::rtcReadEnded(boolean ok)
+{
+	uint8_t i, w;
+	boolean written;
+
+	if (again && ok)
+	{
+		again = false;
+		fresh = true;
+		I2C.twiSubmit(reading);
+		return;
+	}
+	again = false;
+	answered = ok;
+	if (ok)
+	{
+		// Registers a queued write has already changed in the copy keep the new values.
+		for (i = 0; i < DSburst; i++)
+		{
+			written = false;
+			for (w = 0; w < DSwrites; w++)
+			{
+				if (I2C.twiPending(writing[w]) && (i >= writing[w].reg[0]) &&
+					(i < writing[w].reg[0] + writing[w].txLength))
+				{
+					written = true;
+				}
+			}
+			if (deferred && (i >= deferFirst) && (i <= deferLast))
+			{
+				written = true;
+			}
+			if (!written)
+			{
+				regs[i] = in[i];
+			}
+		}
+	}
+	else
+	{
+		fresh = false;
+	}
+	Clock.clockSynced(ok);
+	RTC_alarm.alarm_Read(ok);
+}
+
+void DS3231_Driver::rtcWriteEnded(TWI_Request &request)
+{
+	uint8_t w = &request - writing;
+	uint8_t first = request.reg[0];
+
+	// A write of the alarms is tried once more, after a timeout the bus has been recovered.
+	// It is taken from the copy again: writes queued since went into the copy too, and
+	// the time would be late by now.
+	if ((request.status != TWIdone) && !retried[w] && (first >= DSalarm1))
+	{
+		retried[w] = true;
+		memcpy(out[w], &regs[first], request.txLength);
+		if (first + request.txLength > DSstatus)
+		{
+			out[w][DSstatus - first] = rtcStatusClearing(clear[w]);
+		}
+		if (I2C.twiSubmit(request))
+		{
+			return;
+		}
+	}
+	if (request.status != TWIdone)
+	{
+		fresh = false;		// What the DS3231 holds is not known, read it again before trusting the flags.
+	}
+	if (rearm[w])
+	{
+		rearm[w] = false;
+		RTC_alarm.alarm_Rearm();
+	}
+
+	// The request is free, for the registers that wait in the copy.
+	if (deferred)
+	{
+		deferred = false;
+		if (!rtcSubmit(w, deferFirst, deferLast, deferClear, deferRearm) && deferRearm)
+		{
+			RTC_alarm.alarm_Rearm();
+		}
+	}
+}
+
+boolean DS3231_Driver::rtcFresh(void)
+{
+	return fresh && !I2C.twiPending(reading);
+}
+
+void DS3231_Driver::rtcStale(void)
+{
+	fresh = false;
+}
+
+void DS3231_Driver::rtcTime(tmElements_t &TM)
+{
+	TM.Second = bcd2dec(regs[DSseconds] & 0x7F);
+	TM.Minute = bcd2dec(regs[DSseconds + 1]);
+	TM.Hour = bcd2dec(regs[DSseconds + 2] & 0x3F);
+	TM.Wday = regs[DSseconds + 3];
+	TM.Day = bcd2dec(regs[DSseconds + 4]);
+	TM.Month = bcd2dec(regs[DSseconds + 5] & 0x1F);
+	TM.Year = y2kYearToTm(bcd2dec(regs[DSseconds + 6]));
+}
+
+uint8_t DS3231_Driver::rtcAlarmTime(uint8_t alarm, tmElements_t &TM)
+{
+	const uint8_t *a = &regs[(alarm == 1) ? DSalarm1 : DSalarm2 - 1];	// ALARM_2 has no seconds
+	uint8_t daydate = a[3];
+
+	rtcTime(TM);
+	TM.Second = (alarm == 1) ? bcd2dec(a[0] & 0x7F) : 0;
+	TM.Minute = bcd2dec(a[1] & 0x7F);
+	TM.Hour = bcd2dec(a[2] & 0x3F);
+	if (daydate & DSmask)
+	{
+		return ALMdaily;
+	}
+	if (daydate & DSdayOfWeek)
+	{
+		TM.Wday = daydate & 0x0F;
+		return ALMweekday;
+	}
+	TM.Day = bcd2dec(daydate & 0x3F);
+	return ALMdate;
+}
+
+boolean DS3231_Driver::rtcEnabled(uint8_t alarm)
+{
+	return regs[DScontrol] & ((alarm == 1) ? DSa1ie : DSa2ie);
+}
+
+uint8_t DS3231_Driver::rtcAlarms(void)
+{
+	return regs[DSstatus] & regs[DScontrol] & (DSa1f | DSa2f);
+}
+
+uint8_t DS3231_Driver::rtcStatusClearing(uint8_t flags)
+{
+	return (regs[DSstatus] & DSen32khz) | ((DSosf | DSa1f | DSa2f) & ~flags);
+}
+
+boolean DS3231_Driver::rtcClear(uint8_t flags)
+{
+	uint8_t r[DSburst];
+
+	r[DSstatus] = rtcStatusClearing(flags);
+	return rtcWrite(r, DSstatus, DSstatus, flags, true);
+}
+
+boolean DS3231_Driver::rtcSet(time_t t)
+{
+	tmElements_t TM;
+	uint8_t r[DSburst];
+
+	breakTime(t, TM);
+	r[DSseconds] = dec2bcd(TM.Second);
+	r[DSseconds + 1] = dec2bcd(TM.Minute);
+	r[DSseconds + 2] = dec2bcd(TM.Hour);		// 24 hour mode
+	r[DSseconds + 3] = TM.Wday;				// 1 is Sunday
+	r[DSseconds + 4] = dec2bcd(TM.Day);
+	r[DSseconds + 5] = dec2bcd(TM.Month);
+	r[DSseconds + 6] = dec2bcd(tmYearToY2k(TM.Year));
+	return rtcWrite(r, DSseconds, DSseconds + 6, 0);
+}
+
+boolean DS3231_Driver::rtcAlarm(uint8_t alarm, time_t t, uint8_t match)
+{
+	tmElements_t TM;
+	uint8_t r[DSburst];
+	uint8_t first = (alarm == 1) ? DSalarm1 : DSalarm2;
+	uint8_t *a = &r[first];
+	uint8_t flag = (alarm == 1) ? DSa1f : DSa2f;
+
+	breakTime(t, TM);
+	if (alarm == 1)
+	{
+		*a++ = dec2bcd(TM.Second);
+	}
+	*a++ = dec2bcd(TM.Minute);
+	*a++ = dec2bcd(TM.Hour);
+	if (match == ALMdate)
+	{
+		*a = dec2bcd(TM.Day);
+	}
+	else if (match == ALMweekday)
+	{
+		*a = DSdayOfWeek | TM.Wday;		// 1 is Sunday, as rtcSet sets the DS3231
+	}
+	else
+	{
+		*a = DSmask | 1;
+	}
+	for (a++; a < &r[DScontrol]; a++)
+	{
+		*a = regs[a - r];				// Alarm 2 between alarm 1 and control stays
+	}
+	r[DScontrol] = regs[DScontrol] | DSintcn | flag;		// DSaXie has the bit of DSaXf
+	r[DSstatus] = rtcStatusClearing(flag);
+	return rtcWrite(r, first, DSstatus, flag);
+}
+
+boolean DS3231_Driver::rtcDisable(uint8_t alarm)
+{
+	uint8_t r[DSburst];
+	uint8_t flag = (alarm == 1) ? DSa1f : DSa2f;
+
+	r[DScontrol] = (regs[DScontrol] | DSintcn) & ~flag;
+	r[DSstatus] = rtcStatusClearing(flag);		// A flag already set would hold INT0 low.
+	return rtcWrite(r, DScontrol, DSstatus, flag);
+}
+
+boolean DS3231_Driver::rtcWrite(const uint8_t *r, uint8_t first, uint8_t last, uint8_t clear, boolean rearm)
+{
+	uint8_t status;
+	uint8_t w;
+	boolean queued = true;
+
+	// Into the copy and the request at once, a read ending in between would undo the copy.
+	noInterrupts();
+	status = regs[DSstatus];
+	memcpy(&regs[first], &r[first], last - first + 1);
+	if (last == DSstatus)
+	{
+		regs[DSstatus] = status & ~clear;	// What the DS3231 will hold, as far as it is known.
+	}
+	for (w = 0; (w < DSwrites) && I2C.twiPending(writing[w]); w++)
+	{
+	}
+	if (w < DSwrites)
+	{
+		queued = rtcSubmit(w, first, last, clear, rearm);
+	}
+	else
+	{
+		// rtcWriteEnded writes them from the copy. The range may grow over registers no caller
+		// wrote, the copy holds what the DS3231 does for those. Only rtcSet writes the time.
+		deferFirst = (deferred && (deferFirst < first)) ? deferFirst : first;
+		deferLast = (deferred && (deferLast > last)) ? deferLast : last;
+		deferClear = (deferred ? deferClear : 0) | clear;
+		deferRearm = (deferred && deferRearm) || rearm;
+		deferred = true;
+	}
+	interrupts();
+	return queued;
+}
+
+boolean DS3231_Driver::rtcSubmit(uint8_t w, uint8_t first, uint8_t last, uint8_t clear, boolean rearm)
+{
+	uint8_t length = last - first + 1;
+
+	memcpy(out[w], &regs[first], length);
+	if (last == DSstatus)
+	{
+		out[w][DSstatus - first] = rtcStatusClearing(clear);
+	}
+	writing[w].reg[0] = first;
+	writing[w].txLength = length;
+	this->clear[w] = clear;
+	this->rearm[w] = rearm;
+	retried[w] = false;
+	if (!I2C.twiSubmit(writing[w]))
+	{
+		this->rearm[w] = false;
+		fresh = false;
+		return false;
+	}
+	return true;
+}
+
+
+Software_Clock::Software_Clock() : sinceSync(0), syncing(false), loaded(false)
+{
+	// Constructor for the software clock, the time is unknown until clockSync.
+	memset(&tm, 0, sizeof(tm));
+}
+
+void Software_Clock::clockSync(void)
+{
+	syncing = true;
+	if (!RTC.rtcRead())
+	{
+		syncing = false;	// Keep counting on our own if the DS3231 does not answer.
+	}
+	sinceSync = 0;
+}
+
+void Software_Clock::clockSynced(boolean ok)
+{
+	if (!syncing)
+	{
+		return;		// A read for someone else, or clockSet came in between.
+	}
+	syncing = false;
+	if (ok)
+	{
+		RTC.rtcTime(next);
+		loaded = true;
+		CLKpending = 0;
+		Timers.timerStart(TMRclock, TMRsecond / 2);	// Somewhere in the current second, start in the middle to halve the error.
+	}
+}
+
+boolean Software_Clock::clockSyncing(void)
+{
+	return syncing;
+}
+
+boolean Software_Clock::clockLoaded(void)
+{
+	return loaded;
+}
+
+void Software_Clock::clockWait(void)
+{
+	I2C.twiWait();
+	clockUpdate();
+}
+
+void Software_Clock::clockSet(time_t t)
+{
+	RTC.rtcSet(t);	// Writing the seconds also restarts the DS3231 countdown chain, so the phase is exact here.
+
+	noInterrupts();
+	breakTime(t, tm);
+	syncing = false;
+	loaded = false;
+	CLKpending = 0;
+	Timers.timerStart(TMRclock, TMRsecond);
+	interrupts();
+	sinceSync = 0;
+
+	Telemetry.telemetryTime();
+	Journal.journalAdd(JRNclock, 0);
+	Sun.sunInvalidate();
+	Week.weekInvalidate();
+}
+
+void Software_Clock::clockUpdate(void)
+{
+	uint8_t pending;
+	boolean synced;
+
+	noInterrupts();
+	synced = loaded;
+	if (loaded)
+	{
+		tm = next;
+		loaded = false;
+	}
+	pending = CLKpending;
+	CLKpending = 0;
+	interrupts();
+
+	if (synced)
+	{
+		TELsyncs++;
+	}
+	while (pending--)
+	{
+		clockAdvance();
+		if (++sinceSync >= CLKresync)
+		{
+			clockSync();
+			break;
+		}
+	}
+}
+
+tmElements_t Software_Clock::clockGet(void)
+{
+	return tm;
+}
+
+time_t Software_Clock::clockNow(void)
+{
+	return makeTime(tm);
+}
+
+void Software_Clock::clockAdvance(void)
+{
+	static const uint8_t monthDays[12] PROGMEM = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	uint8_t days;
+
+	if (++tm.Second < 60)	// Nearly every call ends here.
+	{
+		return;
+	}
+	tm.Second = 0;
+	if (++tm.Minute < 60)
+	{
+		return;
+	}
+	tm.Minute = 0;
+	if (++tm.Hour < 24)
+	{
+		return;
+	}
+	tm.Hour = 0;
+	tm.Wday = (tm.Wday % 7) + 1;
+
+	days = pgm_read_byte(&monthDays[tm.Month - 1]);
+	if ((tm.Month == 2) && !(tmYearToCalendar(tm.Year) % 4))	// The DS3231 only counts 2000-2099.
+	{
+		days = 29;
+	}
+	if (++tm.Day <= days)
+	{
+		return;
+	}
+	tm.Day = 1;
+	if (++tm.Month <= 12)
+	{
+		return;
+	}
+	tm.Month = 1;
+	tm.Year++;
+}
+
+
+Human_Machine_Interface::Human_Machine_Interface() : UIstate(0)
+{
+
+	breakTime(0, tid);
+
+	// Standard constructor procedure:
+	//	give variables values by constructor : var_name(var_val) {}
+
+
+// old constructor code
+// 	UIstate = 0;
+// 	time_t temp = 0;
+// 	tid = HMI.ConvTotm(temp);
+// 	tid.Hour = 8;
+// 	tid.Minute = 30;
+}
+
+void Human_Machine_Interface::printDateTime(time_t t)
+{
+	// Print the current time to serial with time_t as input.
+	Serial << ((day(t)<10) ? "0" : "") << _DEC(day(t)) << ' ';
+	Serial << (month(t)) << " " << _DEC(year(t)) << ' ';
+	Serial << ((hour(t)<10) ? "0" : "") << _DEC(hour(t)) << ':';
+	Serial << ((minute(t)<10) ? "0" : "") << _DEC(minute(t)) << ':';
+	Serial << ((second(t)<10) ? "0" : "") << _DEC(second(t));
+}
+
+void Human_Machine_Interface::printDateTime(tmElements_t TM)
+{
+	// Print the current time to serial with tmElements_t as input.
+	Serial << ((TM.Day<10) ? "0" : "") << TM.Day << ' ';
+	Serial << (TM.Month) << ' ';
+	Serial << ((TM.Hour<10) ? "0" : "") << TM.Hour << ':';
+	Serial << ((TM.Minute<10) ? "0" : "") << TM.Minute << ':';
+	Serial << ((TM.Second<10) ? "0" : "") << TM.Second << endl;
+}
+
+uint8_t Human_Machine_Interface::read_LCD_buttons(void)
+{
+	// The keypad is sampled and debounced in the background by Keypad.
+	return Keypad.keypadHeld();
+}
+
+void Human_Machine_Interface::UIupdate(uint8_t event)
+{
+ 	uint8_t userState = 0;
+	uint8_t i;
+	UI_Screen screen;
+	PRFbegin(probe);
+
+	// A press or repeat, releases are not used by the UI.
+	if ((event & BTNtypeMask) != BTNrelease)
+	{
+		userState = event & BTNkeyMask;	// insert user input here.
+	}
+
+	// Find the screen of UIstate, an unknown state shows the first screen.
+	for (i = 0; i < UIscreenCount; i++)
+	{
+		if (pgm_read_byte(&UIscreens[i].state) == UIstate)
+		{
+			break;
+		}
+	}
+	if (i == UIscreenCount)
+	{
+		i = 0;
+		UIstate = pgm_read_byte(&UIscreens[0].state);
+	}
+	memcpy_P(&screen, &UIscreens[i], sizeof(screen));
+
+	// Draw the screen, a view follows the field while an editor shows tid.
+	if (screen.digit == UIview)
+	{
+		UIloadField(screen.field);
+	}
+	LCDfb.noBlink();
+	LCDfb.clear();
+	LCDfb.setCursor(0,0);
+	LCDfb << (const __FlashStringHelper *)screen.label;
+	LCDfb.setCursor(0,1);
+	LCDfb << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
+	if (screen.digit != UIview)
+	{
+		LCDfb.setCursor(screen.digit + (screen.digit >> 1), 1);	// Skip the colon.
+		LCDfb.blink();
+	}
+
+	// user input
+	switch (userState)
+	{
+		case btnSELECT:
+			if (screen.onSelect != UIstay)
+			{
+				if (screen.digit != UIview)
+				{
+					UIsaveField(screen.field);
+				}
+				UIstate = screen.onSelect;
+			}
+		break;
+		case btnLEFT:
+			if (screen.onLeft != UIstay)
+			{
+				UIstate = screen.onLeft;
+			}
+		break;
+		case btnRIGHT:
+			if (screen.onRight != UIstay)
+			{
+				UIstate = screen.onRight;
+			}
+		break;
+		case btnUP:
+		case btnDOWN:
+			if (screen.digit < 2)
+			{
+				tid.Hour = UIeditDigit(tid.Hour, 23, screen.digit == 0, userState == btnUP);
+			}
+			else if (screen.digit != UIview)
+			{
+				tid.Minute = UIeditDigit(tid.Minute, 59, screen.digit == 2, userState == btnUP);
+			}
+		break;
+		default:	// btnRESET, no key
+		break;
+	}
+
+	// Send what changed on the screen to the LCD.
+	LCDfb.flush();
+	PRFend(PRFui + i, probe);
+}
+
+void Human_Machine_Interface::UIloadField(uint8_t field)
+{
+	switch (field)
+	{
+		case UIfieldAlarm1:
+			breakTime(RTC_alarm.alarm1_get(), tid);
+		break;
+		case UIfieldAlarm2:
+			breakTime(RTC_alarm.alarm2_get(), tid);
+		break;
+		default:	// UIfieldClock
+			tid = Clock.clockGet();
+		break;
+	}
+}
+
+void Human_Machine_Interface::UIsaveField(uint8_t field)
+{
+	switch (field)
+	{
+		case UIfieldAlarm1:
+			RTC_alarm.alarm1_set(tid);
+		break;
+		case UIfieldAlarm2:
+			RTC_alarm.alarm2_set(tid);
+		break;
+		default:	// UIfieldClock
+			Clock.clockSet(makeTime(tid));
+		break;
+	}
+}
+
+uint8_t Human_Machine_Interface::UIeditDigit(uint8_t value, uint8_t max, boolean tens, boolean up)
+{
+	uint8_t units = value % 10;
+
+	if (tens)
+	{
+		if (up)
+		{
+			return (value + 10 <= max) ? value + 10 : units;		// 9 -> 19, 19 -> 9 for hours
+		}
+		if (value >= 10)
+		{
+			return value - 10;
+		}
+		value = units + (max / 10) * 10;							// Highest tens that fits, 3 -> 23, 5 -> 15
+		return (value <= max) ? value : value - 10;
+	}
+
+	if (up)
+	{
+		return ((units == 9) || (value == max)) ? value - units : value + 1;	// 19 -> 10, 23 -> 20
+	}
+	if (units)
+	{
+		return value - 1;
+	}
+	return (value + 9 <= max) ? value + 9 : max;					// 10 -> 19, 20 -> 23
+}
+
+uint8_t Human_Machine_Interface::UIgetState(void)
+{
+	return UIstate;
+}
+
+
+DS3231RTC_Alarms::DS3231RTC_Alarms() : held(0), waiting(false)
+{
+	// Constructor for the alarms class.
+}
+
+void DS3231RTC_Alarms::init_alarms(void)
+{
+	// Setup the SQW interrupt:
+	DDRD &= ~(1 << DDD2); // make INT0 an input.
+	PORTD |= (1 << DDD2); // enable pull-up on INT0.
+	attachInterrupt(INT0, alarmIsr, FALLING);	// Initializing the INT0 interrupt in the Arduino way.
+	
+	// The copy of the registers that alarm_program and alarm_disable write back. Both set
+	// INTCN, which disables the default square wave of the SQW pin.
+	RTC.rtcRead();
+	I2C.twiWait();
+	
+	// Set both alarms from the configuration (call Config.configLoad first), so the door
+	// keeps its schedule even if the DS3231 lost its alarms with its battery.
+	alarm_restore();
+}
+
+void DS3231RTC_Alarms::alarm_restore(void)
+{
+	// The weekly schedule arms ALARM_1 itself on the next pass of loop().
+	if (Config.configGet().mode == SCHweekly)
+	{
+		alarm_disable(2);
+		return;
+	}
+	alarm_program(1, Config.configGet().alarm1);
+	alarm_program(2, Config.configGet().alarm2);
+}
+
+void DS3231RTC_Alarms::alarm_program(uint8_t alarm, time_t t, uint8_t match)
+{
+	RTC.rtcAlarm(alarm, t, match);		// Also clears the flag, and enables the interrupt.
+}
+
+void DS3231RTC_Alarms::alarm_disable(uint8_t alarm)
+{
+	RTC.rtcDisable(alarm);
+}
+
+void DS3231RTC_Alarms::alarm_Check(uint8_t *stat)
+{
+	PRFbegin(probe);
+
+	*stat = 0;
+	if (!held)
+	{
+		// Both flags from one burst, unless clockSync read them after the interrupt already.
+		// Otherwise EVTalarm comes back when the read has ended, loop() goes on meanwhile.
+		if (!RTC.rtcFresh())
+		{
+			waiting = true;		// Before, the read may already be about to end.
+			if (!RTC.rtcRead())
+			{
+				waiting = false;
+				alarm_Rearm();
+			}
+			PRFend(PRFalarm, probe);
+			return;
+		}
+		held = RTC.rtcAlarms();
+		if (!held || !RTC.rtcClear(held))	// Both at once, the interrupt line goes high again.
+		{
+			alarm_Rearm();
+		}
+	}
+	if (held & DSa1f)
+	{
+		*stat = 1;
+		held &= ~DSa1f;
+	}
+	else if (held & DSa2f)
+	{
+		*stat = 2;
+		held = 0;
+	}
+	if (*stat)
+	{
+		TELalarms++;
+		Journal.journalAdd(JRNalarm, *stat);
+	}
+
+	// alarm2 of the same burst is queued for the next pass.
+	if (held)
+	{
+		noInterrupts();
+		Events.eventPost(EVTalarm, 0, 0);
+		interrupts();
+	}
+	PRFend(PRFalarm, probe);
+}
+
+void DS3231RTC_Alarms::alarm_Read(boolean ok)
+{
+	if (!waiting)
+	{
+		return;
+	}
+	waiting = false;
+	if (ok)
+	{
+		Events.eventPost(EVTalarm, 0, 0);	// alarm_Check finds the copy fresh now.
+	}
+	else
+	{
+		alarm_Rearm();		// Tried again if the line is still low.
+	}
+}
+
+void DS3231RTC_Alarms::alarm_Rearm(void)
+{
+	uint8_t sreg = SREG;
+
+	// Re-enable INT0 now the flags are cleared. An alarm that fired since holds the line low
+	// without a new falling edge, it is queued for the next pass.
+	noInterrupts();
+	EIFR = (1 << INTF0);
+	EIMSK |= (1 << INT0);
+	if (!(PIND & (1 << PIND2)) && !Events.eventPending(EVTalarm))
+	{
+		Events.eventPost(EVTalarm, 0, 0);
+		RTC.rtcStale();		// The copy is older than that alarm.
+	}
+	SREG = sreg;
+}
+
+boolean DS3231RTC_Alarms::alarm_Pending(void)
+{
+	return waiting || Events.eventPending(EVTalarm);
+}
+
+time_t DS3231RTC_Alarms::alarm1_get(void)
+{
+	// returns the value from alarm1 of the configuration
+	return Config.configGet().alarm1;
+}
+
+time_t DS3231RTC_Alarms::alarm2_get(void)
+{
+	// returns the value from alarm2 of the configuration
+	return Config.configGet().alarm2;
+}
+
+void DS3231RTC_Alarms::alarm1_set(tmElements_t TM)
+{
+	// Overwrites the current alarm1 both in the DS3231 clock module and in the EEPROM.
+
+
+	// Overwrite the alarm1 time in the DS3231 clock module.
+	alarm_program(1, makeTime(TM));
+
+	// Overwrite the alarm1 time in the EEPROM, a time set by hand ends the solar or weekly schedule.
+	Config.configGet().alarm1 = makeTime(TM);
+	if (Config.configGet().mode != SUNmanual)
+	{
+		Config.configGet().mode = SUNmanual;
+		alarm_program(2, Config.configGet().alarm2);	// Daily again, the schedule moved or disabled it.
+	}
+	Config.configSave();
+
+	// Log the new alarm, printed once loop() is idle.
+	Log.logPost(LOGalarmSet, 1, Config.configGet().alarm1);
+}
+
+void DS3231RTC_Alarms::alarm2_set(tmElements_t TM)
+{
+	// Overwrites the current alarm2 both in the DS3231 clock module and in the EEPROM.
+
+
+	// Overwrite the alarm2 time in the DS3231 clock module.
+	alarm_program(2, makeTime(TM));
+
+	// Overwrite the alarm2 time in the EEPROM, a time set by hand ends the solar or weekly schedule.
+	Config.configGet().alarm2 = makeTime(TM);
+	if (Config.configGet().mode != SUNmanual)
+	{
+		Config.configGet().mode = SUNmanual;
+		alarm_program(1, Config.configGet().alarm1);	// Daily again, the schedule moved or disabled it.
+	}
+	Config.configSave();
+
+	// Log the new alarm, printed once loop() is idle.
+	Log.logPost(LOGalarmSet, 2, Config.configGet().alarm2);
+}
+
+
+template <class Port, uint8_t OpenMask, uint8_t CloseMask, bool ActiveLow, uint8_t Topology>
+void Relay_Driver<Port, OpenMask, CloseMask, ActiveLow, Topology>::relayInit(void)
+{
+	relayWrite(0);
+	Port::ddr() |= mask;
+	if (Topology == RAbridge)
+	{
+		// Fast PWM with OC2B disconnected until relayDuty, the enable pin is low.
+		PORTD &= ~(1 << RAenable);
+		DDRD |= (1 << RAenable);
+		OCR2B = 0;
+		TCCR2A = (1 << WGM21) | (1 << WGM20);
+		TCCR2B = (1 << CS21);
+	}
+}
+
+template <class Port, uint8_t OpenMask, uint8_t CloseMask, bool ActiveLow, uint8_t Topology>
+void Relay_Driver<Port, OpenMask, CloseMask, ActiveLow, Topology>::relayOn(uint8_t dir)
+{
+	relayWrite((dir == liftCW) ? OpenMask : ((dir == liftCCW) ? CloseMask : 0));
+}
+
+template <class Port, uint8_t OpenMask, uint8_t CloseMask, bool ActiveLow, uint8_t Topology>
+void Relay_Driver<Port, OpenMask, CloseMask, ActiveLow, Topology>::relayOff(void)
+{
+	relayDuty(0);
+	relayWrite(0);
+}
+
+template <class Port, uint8_t OpenMask, uint8_t CloseMask, bool ActiveLow, uint8_t Topology>
+void Relay_Driver<Port, OpenMask, CloseMask, ActiveLow, Topology>::relayDuty(uint8_t duty)
+{
+	if (Topology != RAbridge)
+	{
+		return;
+	}
+	// OCR2B of 0 still gives a spike every period, 0 disconnects OC2B instead.
+	OCR2B = duty;
+	if (duty)
+	{
+		TCCR2A |= (1 << COM2B1);
+	}
+	else
+	{
+		TCCR2A &= ~(1 << COM2B1);
+	}
+}
+
+template <class Port, uint8_t OpenMask, uint8_t CloseMask, bool ActiveLow, uint8_t Topology>
+void Relay_Driver<Port, OpenMask, CloseMask, ActiveLow, Topology>::relayWrite(uint8_t on)
+{
+	uint8_t sreg = SREG;
+
+	// One write of the port, so both directions are never on together, not even for an instruction.
+	noInterrupts();
+	Port::port() = (Port::port() & ~mask) | (ActiveLow ? (mask & ~on) : on);
+	SREG = sreg;
+}
+
+
+liftRelayArray::liftRelayArray()
+{
+	// Constructor for the relay class
+	relayStatsClear();
+}
+
+void liftRelayArray::relayArrayInit(void)
+{
+	// Relays off, then outputs.
+	RA_Relays::relayInit();
+
+	// End switches: inputs with pull-ups, any change interrupts, and where the door is now.
+	DDRC &= ~((1 << LSopen) | (1 << LSclosed));
+	PORTC |= (1 << LSopen) | (1 << LSclosed);
+	PCMSK1 |= (1 << PCINT9) | (1 << PCINT10);
+	PCICR |= (1 << PCIE1);
+	RAposition = !(PINC & (1 << LSopen)) ? POSopen : (!(PINC & (1 << LSclosed)) ? POSclosed : POSunknown);
+
+	// Timer1 only runs for deadlines, TMRrelay is the one of the lift.
+	Timers.timerInit();
+}
+
+boolean liftRelayArray::relayArrayCommand(uint8_t cmd, uint16_t hold)
+{
+	uint16_t limit = Config.configGet().liftHold;
+	const LFT_Stats &st = stats[(cmd == liftCW) ? 0 : 1];
+	PRFbegin(probe);
+
+	// Already at the end it would run to, the motor is not switched on.
+	if (((cmd == liftCW) && !(PINC & (1 << LSopen))) || ((cmd == liftCCW) && !(PINC & (1 << LSclosed))))
+	{
+		RAposition = (cmd == liftCW) ? POSopen : POSclosed;
+		PRFend(PRFrelay, probe);
+		return false;
+	}
+
+	Telemetry.telemetryRelay(cmd);
+	Journal.journalAdd(JRNrelay, cmd);
+	if (cmd != liftSTOP)
+	{
+		TELliftRuns++;
+	}
+
+	// Using the lift made easy.
+	switch (cmd)
+	{
+		case liftCW:	// Make the cable retract - Open door
+		case liftCCW:	// Make the cable extend - Close door
+			// All off at once, a reversal stops the running direction first. relayStart switches on after the dead time.
+			noInterrupts();
+			RA_Relays::relayOff();
+			if (RAdirection != liftSTOP)	// Stopped on the way.
+			{
+				RAdirection = liftSTOP;
+				RAposition = POSunknown;
+			}
+			Timers.timerCancel(TMRrelay);
+			Timers.timerCancel(TMRramp);
+			RApending = cmd;
+			RAtimed = hold && (hold < limit);
+			RArun = RAtimed ? hold : limit;
+			// The final approach of RAbridge, for full runs once the mean has been learned.
+			RAslow = 0;
+			if ((RAtopology == RAbridge) && Config.configGet().rampProfile && !RAtimed && (st.runs >= LFTlearn) &&
+				(RAposition == ((cmd == liftCW) ? POSclosed : POSopen)))
+			{
+				uint16_t mean = (st.mean + 8) >> 4;
+				RAslow = (mean > RMPapproach) ? mean - RMPapproach : 1;
+			}
+			RAstate = RSdead;
+			Timers.timerStart(TMRdead, TMRms(Config.configGet().deadTime));
+			interrupts();
+		break;
+    
+		default:	// default, aka. liftSTOP
+			noInterrupts();
+			RA_Relays::relayOff();	// Turn off all relays
+			if (RAdirection != liftSTOP)	// Stopped on the way, not by an ISR.
+			{
+				RAdirection = liftSTOP;
+				RAposition = POSunknown;
+			}
+			RAstate = RSidle;
+			Timers.timerCancel(TMRrelay);
+			Timers.timerCancel(TMRdead);
+			Timers.timerCancel(TMRramp);
+			interrupts();
+		break;
+	}
+	PRFend(PRFrelay, probe);
+	return cmd != liftSTOP;
+}
+
+void liftRelayArray::relayStart(void)
+{
+	uint8_t dir = RApending;
+
+	// The switch may have closed during the dead time, the lift is then already there.
+	if (!(PINC & (1 << ((dir == liftCW) ? LSopen : LSclosed))))
+	{
+		RAstate = RSidle;
+		RAposition = (dir == liftCW) ? POSopen : POSclosed;
+		Events.eventPost(EVTthere, RAposition, 0);
+		return;
+	}
+	RAdirection = dir;
+	RAfrom = RAposition;
+	RAstart = Timers.timerNow();
+	Timers.timerStart(TMRrelay, TMRms(RArun));
+	RAstate = RSrunning;
+	RAposition = (dir == liftCW) ? POSopening : POSclosing;
+	RMPtravel = 0;
+	RMPsince = RAstart;
+	RMPduty = RMPfull;
+	RA_Relays::relayOn(dir);	// Turn on lift, RAbridge with the H-bridge still disabled.
+	if (RAtopology == RAbridge)
+	{
+		RMPduty = 0;
+		RMPstate = RMPaccel;
+		RMPindex = 0;
+		relayRamp();
+	}
+}
+
+void liftRelayArray::relayRamp(void)
+{
+	uint8_t profile = Config.configGet().rampProfile;
+	uint8_t duty;
+	uint32_t travel;
+
+	if ((profile < RMPlinear) || (profile > RMPscurve))
+	{
+		relayDuty(RMPfull);		// RMPoff, full on for the whole run.
+		return;
+	}
+	switch (RMPstate)
+	{
+		case RMPaccel:	// Up the profile, an entry per rampStep.
+			if (RMPindex < RMPsteps)
+			{
+				relayDuty(pgm_read_byte(&RMPprofiles[profile - 1][RMPindex++]));
+				Timers.timerStart(TMRramp, TMRms(Config.configGet().rampStep));
+				break;
+			}
+			relayDuty(RMPfull);
+			RMPstate = RMPcruise;
+			if (RAslow)
+			{
+				travel = relayTravel();
+				Timers.timerStart(TMRramp, (travel < TMRms(RAslow)) ? TMRms(RAslow) - travel : 0);
+			}
+		break;
+
+		case RMPcruise:	// The final approach begins.
+			RMPstate = RMPdecel;
+			RMPindex = RMPsteps - 1;
+			// fall through
+		case RMPdecel:	// Down the profile, until it is at or below RMPcrawl.
+			duty = RMPindex ? pgm_read_byte(&RMPprofiles[profile - 1][--RMPindex]) : 0;
+			if (duty <= RMPcrawl)
+			{
+				relayDuty(RMPcrawl);
+				RMPstate = RMPfinal;
+				break;
+			}
+			relayDuty(duty);
+			Timers.timerStart(TMRramp, TMRms(Config.configGet().rampStep));
+		break;
+
+		default:		// RMPfinal, the end switch stops it.
+		break;
+	}
+}
+
+uint32_t liftRelayArray::relayTravel(void)
+{
+	return RMPtravel + (Timers.timerNow() - RMPsince) * RMPduty / RMPfull;
+}
+
+void liftRelayArray::relayDuty(uint8_t duty)
+{
+	RMPtravel = relayTravel();
+	RMPsince = Timers.timerNow();
+	RMPduty = duty;
+	RA_Relays::relayDuty(duty);
+}
+
+uint8_t liftRelayArray::relayPosition(void)
+{
+	return RAposition;
+}
+
+const LFT_Stats &liftRelayArray::relayStats(uint8_t dir)
+{
+	return stats[(dir == liftCW) ? 0 : 1];
+}
+
+void liftRelayArray::relayStatsClear(void)
+{
+	memset(stats, 0, sizeof(stats));
+}
+
+void liftRelayArray::relayRecord(uint8_t dir, uint16_t ms)
+{
+	LFT_Stats &st = stats[(dir == liftCW) ? 0 : 1];
+	int32_t mean = (st.mean + 8) >> 4;
+	int16_t dev;
+	uint8_t bin;
+
+	st.last = ms;
+	if (!st.runs || (ms < st.min))
+	{
+		st.min = ms;
+	}
+	if (ms > st.max)
+	{
+		st.max = ms;
+	}
+	if (st.runs < 0xFFFF)
+	{
+		st.runs++;
+	}
+
+	// Learning: the plain average of the runs so far.
+	if (st.runs <= LFTlearn)
+	{
+		st.mean = (st.mean * (st.runs - 1) + ((uint32_t)ms << 4)) / st.runs;
+		return;
+	}
+
+	dev = mean ? (int16_t)(((int32_t)ms - mean) * 100 / mean) : 0;
+	bin = (dev < -(LFTbins / 2 - 1) * LFTbinPercent) ? 0 :
+		((dev >= (LFTbins / 2 - 1) * LFTbinPercent) ? (LFTbins - 1) : ((dev + (LFTbins / 2) * LFTbinPercent) / LFTbinPercent));
+	if (++st.hist[bin] == 0xFF)
+	{
+		for (uint8_t i = 0; i < LFTbins; i++)
+		{
+			st.hist[i] >>= 1;
+		}
+	}
+
+	// A jam or a slipping cable is reported, and kept out of the baseline. Normal runs follow it slowly.
+	if ((dev >= LFTdeviation) || (dev <= -LFTdeviation))
+	{
+		if (st.faults < 0xFF)
+		{
+			st.faults++;
+		}
+		Log.logPost(LOGdeviation, dir, Clock.clockNow());
+		Journal.journalAdd(JRNdeviation, dir);
+		return;
+	}
+	st.mean = st.mean - (st.mean >> 3) + ((uint32_t)ms << 1);	// 1/LFTlearn of the new run
+}
+
+void liftRelayArray::relayAutoCommand(uint8_t alarmtrig, uint16_t hold)
+{
+	switch(alarmtrig)					// switch statement to automatically handle what should happen if alarm has happened.
+	{
+		case 1:							// alarm1:
+			if(RAstate == RSidle)
+			{
+				relayArrayCommand(liftCW, hold);	// the end switch, hold or the timeout stops it
+			}
+			break;
+		
+		case 2:							// alarm2:
+			if(RAstate == RSidle)
+			{
+				relayArrayCommand(liftCCW, hold);
+			}
+			break;
+		
+		default:						// if there was no alarm, the ISRs stop the lift.
+			break;
+	}
+}
+
+void liftRelayArray::relayEvent(const EVT_Entry &event)
+{
+	LFT_Stats &st = stats[(event.arg == liftCW) ? 0 : 1];
+
+	switch (event.type)
+	{
+		case EVTswitch:		// At the end, ms is 0 unless it came from the other end.
+			if (event.ms)
+			{
+				relayRecord((event.arg == POSopen) ? liftCW : liftCCW, event.ms);
+			}
+		break;
+
+		case EVTdeadline:	// Jammed, or the switch is broken.
+			if (st.faults < 0xFF)
+			{
+				st.faults++;
+			}
+			Log.logPost(LOGfault, event.arg, Clock.clockNow());
+			Journal.journalAdd(JRNfault, event.arg);
+		break;
+
+		case EVTthere:		// The relays stayed off, there is no run to stop.
+		return;
+
+		default:			// EVTtimed, the door stays between the ends.
+		break;
+	}
+	Telemetry.telemetryRelay(liftSTOP);
+	Journal.journalAdd(JRNrelay, liftSTOP);
+}
+
+
+Power_Manager::Power_Manager() : lastActivity(0), displayOn(true), flushed(false)
+{
+	// Constructor for the power manager, the UI counts as used at boot.
+}
+
+void Power_Manager::powerInit(void)
+{
+	lastActivity = millis();
+
+	// Pin changes on A0 (keypad) and RX wake the MCU, they are only enabled in powerDown.
+	// PCINT1 itself stays enabled for the end switches.
+	PCMSK2 |= (1 << PCINT16);
+}
+
+void Power_Manager::powerActivity(void)
+{
+	lastActivity = millis();
+
+	if (!displayOn)
+	{
+		lcd.display();
+		displayOn = true;
+	}
+}
+
+boolean Power_Manager::powerBusy(void)
+{
+	if ((RAstate != RSidle) || Events.eventPending())	// Lift is moving or waits for the dead time, Timer1 has to run, or loop() has work.
+	{
+		return true;
+	}
+	if (Console.consoleBusy() || Log.logPending() || Journal.journalBusy() || Week.weekBusy())	// The UART stops in power-down.
+	{
+		return true;
+	}
+	if (I2C.twiBusy())	// So does the TWI, what is queued ends first.
+	{
+		return true;
+	}
+	return (millis() - lastActivity) < PWRuiAwake;
+}
+
+void Power_Manager::powerWait(void)
+{
+	unsigned long start = millis();
+	unsigned long period = PWRloopPeriod;
+	uint8_t tries = 0;
+
+	Log.logDrain();		// The pass is done, spend the idle time on the log and the journal.
+	Journal.journalPoll();
+
+	if (Keypad.keypadActivity())
+	{
+		powerActivity();
+	}
+
+	if (!PWRdeepSleep || powerBusy())
+	{
+		flushed = false;
+	}
+	else if (!flushed && Journal.journalFlush())
+	{
+		flushed = true;		// RAM is kept, but power may not come back. Powers down once the page is written.
+	}
+	else
+	{
+		powerDown();
+		flushed = false;
+		period = 0;			// The pass that follows needs the time, wait for clockSync only.
+		tries = PWRsyncTries - 1;
+	}
+
+	// Idle keeps the timers running, every tick or alarm wakes the CPU. A read of clockSync
+	// ends within DStimeout, one the bus lost is tried again.
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	while ((((millis() - start) < period) && !Events.eventPending()) || Clock.clockSyncing())
+	{
+		sleep_mode();
+		if (tries && !Clock.clockSyncing() && !Clock.clockLoaded())
+		{
+			tries--;
+			Clock.clockSync();
+		}
+	}
+}
+
+void Power_Manager::powerDown(void)
+{
+	Serial.flush();			// The UART stops in power-down, finish sending first.
+	lcd.noDisplay();
+	displayOn = false;
+
+	noInterrupts();
+	ADCSRA &= ~(1 << ADEN);		// ADC off. Timer1 stops with the I/O clock, clockSync restarts TMRclock.
+	EICRA &= ~((1 << ISC01) | (1 << ISC00));	// Only a low level on INT0 wakes from power-down.
+	PCIFR = (1 << PCIF2);
+	PCMSK1 |= (1 << PCINT8);
+	PCICR |= (1 << PCIE2);
+
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	if (!Events.eventPending())
+	{
+		sleep_enable();
+		sleep_bod_disable();
+		interrupts();		// The instruction after sei is executed before any interrupt, so no wake-up is lost.
+		sleep_cpu();
+		sleep_disable();
+	}
+	interrupts();
+
+	// Awake again, restore the running configuration.
+	noInterrupts();
+	PCICR &= ~(1 << PCIE2);
+	PCMSK1 &= ~(1 << PCINT8);
+	EICRA |= (1 << ISC01);	// Back to falling edge.
+	ADCSRA |= (1 << ADEN);
+	interrupts();
+
+	Clock.clockSync();		// Timer1 did not count while powered down, powerWait idles until the read has ended.
+	TELwakeups++;
+
+	if (!(PINC & (1 << PINC0)) || Serial.available())	// Woken by a key or by serial input.
+	{
+		powerActivity();
+	}
+}
+
+
+Serial_Console::Serial_Console() : lineLength(0), lineOverflow(false), helpLine(CONhelpLines), rtcLine(false),
+	liftLine(CONliftLines), dropped(0),
+#if PRFenabled
+	probeLine(PRFprobes),
+#endif
+	txHead(0), txTail(0)
+{
+	// Constructor for the console.
+}
+
+size_t Serial_Console::write(uint8_t c)
+{
+	uint8_t next = (txHead + 1) & (CONtx - 1);
+
+	if (next == txTail)
+	{
+		if (dropped < 0xFFFF)
+		{
+			dropped++;
+		}
+		return 0;
+	}
+	tx[txHead] = c;
+	txHead = next;
+	return 1;
+}
+
+uint8_t Serial_Console::consoleFree(void)
+{
+	return (txTail - txHead - 1) & (CONtx - 1);
+}
+
+boolean Serial_Console::consoleBusy(void)
+{
+#if PRFenabled
+	if (probeLine < PRFprobes)
+	{
+		return true;
+	}
+#endif
+	return (txHead != txTail) || lineLength || lineOverflow || (helpLine < CONhelpLines) || rtcLine ||
+		(liftLine < CONliftLines) || dropped;
+}
+
+void Serial_Console::consolePoll(void)
+{
+	uint8_t n;
+	int c;
+
+	// Output, only what the UART buffer takes without waiting.
+	for (n = Serial.availableForWrite(); n && (txTail != txHead); n--)
+	{
+		Serial.write(tx[txTail]);
+		txTail = (txTail + 1) & (CONtx - 1);
+	}
+
+	// Output that did not fit, once the note does.
+	if (dropped && (consoleFree() >= CONreplyMax))
+	{
+		uint16_t lost = dropped;
+
+		dropped = 0;
+		*this << F("Console: ") << lost << F(" characters dropped") << endl;
+	}
+
+	// The rest of the help, once its next line fits.
+	if (helpLine < CONhelpLines)
+	{
+		const char *text = (const char *)pgm_read_ptr(&CONhelp[helpLine]);
+
+		if (consoleFree() < strlen_P(text) + 2)
+		{
+			return;		// Input waits too, so its replies come after the help.
+		}
+		*this << (const __FlashStringHelper *)text << endl;
+		helpLine++;
+	}
+
+	// The rtc line of status, once its read has ended and the line fits.
+	if (rtcLine)
+	{
+		if (RTC.rtcReading() || (consoleFree() < CONrtcLine))
+		{
+			return;
+		}
+		consoleRtc();
+		rtcLine = false;
+	}
+
+#if PRFenabled
+	// The probes table, a line at a time.
+	while (probeLine < PRFprobes)
+	{
+		if (consoleFree() < PRFlineMax)
+		{
+			return;
+		}
+		consoleProbe(probeLine++);
+	}
+#endif
+
+	// The lift command, a line at a time.
+	while (liftLine < CONliftLines)
+	{
+		if (consoleFree() < CONreplyMax)
+		{
+			return;
+		}
+		consoleLift(liftLine++);
+	}
+
+	// Input, not past a help, an rtc line or a table that is still being queued,
+	// and only while the longest reply fits, so the line it ends is not answered in part.
+	for (n = 0; (n < CONrxPerPass) && (helpLine >= CONhelpLines) && !rtcLine && (consoleFree() >= CONreplyMax); n++)
+	{
+		c = Serial.read();
+		if (c < 0)
+		{
+			break;
+		}
+		Power.powerActivity();
+
+		if ((c == '\r') || (c == '\n'))
+		{
+			if (lineOverflow)
+			{
+				*this << F("Error: line too long") << endl;
+			}
+			else if (lineLength)
+			{
+				line[lineLength] = 0;
+				consoleExecute();
+			}
+			lineLength = 0;
+			lineOverflow = false;
+		}
+		else if (lineLength < CONline)
+		{
+			line[lineLength++] = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+		}
+		else
+		{
+			lineOverflow = true;
+		}
+	}
+}
+
+uint8_t Serial_Console::consoleNumbers(const char *str, uint16_t *num, uint8_t count)
+{
+	uint8_t found = 0;
+
+	while (*str && (found < count))
+	{
+		if ((*str < '0') || (*str > '9'))
+		{
+			str++;
+			continue;
+		}
+		num[found] = 0;
+		while ((*str >= '0') && (*str <= '9'))
+		{
+			num[found] = num[found] * 10 + (*str++ - '0');
+		}
+		found++;
+	}
+	return found;
+}
+
+uint8_t Serial_Console::consoleDecimals(const char *str, int32_t *num, uint8_t count)
+{
+	uint8_t found = 0;
+	uint8_t decimals;
+	boolean negative;
+
+	while (*str && (found < count))
+	{
+		negative = (*str == '-');
+		if (negative)
+		{
+			str++;
+		}
+		if ((*str < '0') || (*str > '9'))
+		{
+			if (!negative)
+			{
+				str++;
+			}
+			continue;
+		}
+		num[found] = 0;
+		while ((*str >= '0') && (*str <= '9'))
+		{
+			num[found] = num[found] * 10 + (*str++ - '0');
+		}
+		num[found] *= 100;
+		if (*str == '.')
+		{
+			str++;
+			for (decimals = 10; (*str >= '0') && (*str <= '9'); str++, decimals /= 10)
+			{
+				num[found] += (*str - '0') * decimals;
+			}
+		}
+		if (negative)
+		{
+			num[found] = -num[found];
+		}
+		found++;
+	}
+	return found;
+}
+
+void Serial_Console::consoleHundredths(int16_t val)
+{
+	if (val < 0)
+	{
+		*this << '-';
+		val = -val;
+	}
+	*this << (val / 100) << '.';
+	consoleI00(val % 100, 0);
+}
+
+void Serial_Console::consoleRtc(void)
+{
+	tmElements_t TM;
+	uint8_t alarm, match;
+
+	if (RTC.rtcAnswered())
+	{
+		RTC.rtcTime(TM);
+		*this << F("rtc ");
+		consoleI00(TM.Hour, ':');
+		consoleI00(TM.Minute, ':');
+		consoleI00(TM.Second, 0);
+		for (alarm = 1; alarm <= 2; alarm++)
+		{
+			match = RTC.rtcAlarmTime(alarm, TM);
+			*this << F(", alarm") << alarm << ' ';
+			consoleI00(TM.Hour, ':');
+			consoleI00(TM.Minute, ':');
+			consoleI00(TM.Second, ' ');
+			*this << ((match == ALMdaily) ? F("daily") : ((match == ALMdate) ? F("date") : F("weekday")));
+			if (!RTC.rtcEnabled(alarm))
 			{
-				case btnSELECT:
-				/* Your code here */ // Go to UIstate 1, To change C1
-				UIstate = 1;
+				*this << F(" off");
+			}
+		}
+	}
+	else
+	{
+		*this << F("rtc no answer");
+	}
+	*this << F(", i2c errors ") << I2C.twiErrors() << F(" recovered ") << I2C.twiRecoveries() << endl;
+}
+
+#if PRFenabled
+void Serial_Console::consoleProbe(uint8_t probe)
+{
+	PRF_Stats st;
+
+	Profiler.prfGet(probe, st);
+	if (probe < PRFui)
+	{
+		*this << (const __FlashStringHelper *)PRFnames[probe];
+	}
+	else
+	{
+		*this << F("ui ") << pgm_read_byte(&UIscreens[probe - PRFui].state);
+	}
+	*this << F(" n ") << st.count << F(" min ") << st.min << F(" max ") << st.max << ':';
+	for (uint8_t i = 0; i < PRFbins; i++)
+	{
+		*this << ' ' << st.hist[i];
+	}
+	*this << endl;
+}
+#endif
+
+void Serial_Console::consoleLift(uint8_t index)
+{
+	// Two lines per direction, the histogram runs from below -15 % to 15 % and above.
+	uint8_t dir = (index < 2) ? liftCW : liftCCW;
+	const LFT_Stats &st = relayArray.relayStats(dir);
+
+	if (!(index & 1))
+	{
+		*this << ((dir == liftCW) ? F("open ") : F("close")) << F(" runs ") << st.runs << F(" last ") << st.last;
+		*this << F(" min ") << st.min << F(" mean ") << ((st.mean + 8) >> 4) << F(" max ") << st.max << F(" ms") << endl;
+		return;
+	}
+	*this << F("  faults ") << st.faults << F(", off by -") << ((LFTbins / 2 - 1) * LFTbinPercent) << F("..");
+	*this << ((LFTbins / 2 - 1) * LFTbinPercent) << F("% in ") << LFTbinPercent << F("% bins:");
+	for (uint8_t i = 0; i < LFTbins; i++)
+	{
+		*this << ' ' << st.hist[i];
+	}
+	*this << endl;
+}
 
-				break;
-				case btnRESET:
-				/* Your code here */ //Nothing happens
-				break;
-				case btnUP:
-				/* Your code here */ //nothing happens
-				break;
-				case btnDOWN:
-				/* Your code here */ //nothing happens
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 20, we go to alarm 2
-				UIstate = 20;
+void Serial_Console::consoleI00(uint8_t val, char delim)
+{
+	if (val < 10)
+	{
+		*this << '0';
+	}
+	*this << val;
+	if (delim)
+	{
+		*this << delim;
+	}
+}
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Go to UIstate 10, we go to alarm 1
-				UIstate = 10;
+void Serial_Console::consoleExecute(void)
+{
+	uint8_t cmd, length;
+	uint16_t num[6];
+	uint8_t found;
+	tmElements_t TM;
+
+	// Split the command word from its arguments.
+	for (length = 0; line[length] && (line[length] != ' '); length++);
+	for (cmd = 0; cmd < CONcmdCount; cmd++)
+	{
+		if ((length < CONcmdLength) && !strncmp_P(line, CONcommands[cmd], length) &&
+			!pgm_read_byte(&CONcommands[cmd][length]))
+		{
+			break;
+		}
+	}
+	found = consoleNumbers(line + length, num, 6);
 
-				break;
-				default:
-				/* Your code here */
+	switch (cmd)
+	{
+		case 0:	// help
+			helpLine = 0;	// Queued by consolePoll.
+		break;
+
+		case 1:	// status
+			TM = Clock.clockGet();
+			*this << F("time ") << tmYearToCalendar(TM.Year) << '-';
+			consoleI00(TM.Month, '-');
+			consoleI00(TM.Day, ' ');
+			consoleI00(TM.Hour, ':');
+			consoleI00(TM.Minute, ':');
+			consoleI00(TM.Second, 0);
+			breakTime(RTC_alarm.alarm1_get(), TM);
+			*this << F(", open ");
+			consoleI00(TM.Hour, ':');
+			consoleI00(TM.Minute, 0);
+			breakTime(RTC_alarm.alarm2_get(), TM);
+			*this << F(", close ");
+			consoleI00(TM.Hour, ':');
+			consoleI00(TM.Minute, 0);
+			*this << F(", door ");
+			switch (relayArray.relayPosition())
+			{
+				case POSopen:		*this << F("open"); break;
+				case POSclosed:		*this << F("closed"); break;
+				case POSopening:	*this << F("opening"); break;
+				case POSclosing:	*this << F("closing"); break;
+				default:			*this << F("between"); break;
+			}
+			*this << endl;
+
+			// What the DS3231 itself holds, from one burst read, printed by consolePoll.
+			rtcLine = RTC.rtcRead();
+		break;
+
+		case 2:	// open
+		case 3:	// close
+			// Like an alarm, the lift stops by itself at the end switch.
+			Journal.journalAdd(JRNmanual, (cmd == 2) ? liftCW : liftCCW);
+			if (!relayArray.relayArrayCommand((cmd == 2) ? liftCW : liftCCW))
+			{
+				*this << F("already ") << ((cmd == 2) ? F("open") : F("closed")) << endl;
 				break;
 			}
+			*this << F("ok") << endl;
 		break;
-		case 1:
-		// Show time, blink C1
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift Klokkeslet";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(0,1);
-			lcd.blink();
 
+		case 4:	// stop
+			Journal.journalAdd(JRNmanual, liftSTOP);
+			relayArray.relayArrayCommand(liftSTOP);
+			*this << F("ok") << endl;
+		break;
 
-			switch (userState)
+		case 5:	// time
+			if (found == 5)
 			{
-				case btnSELECT:
-				/* Your code here */ //Do nothing
-
+				num[5] = 0;
+			}
+			if ((found < 5) || (num[1] < 1) || (num[1] > 12) || (num[2] < 1) || (num[2] > 31) ||
+				(num[3] > 23) || (num[4] > 59) || (num[5] > 59) || ((num[0] >= 100) && (num[0] < 2000)) || (num[0] > 2099))
+			{
+				*this << F("Error: time yyyy-mm-dd hh:mm[:ss]") << endl;
 				break;
-				case btnRESET:
-				/* Your code here */ //Do nothing
+			}
+			TM.Year = (num[0] < 100) ? y2kYearToTm(num[0]) : CalendarYrToTm(num[0]);
+			TM.Month = num[1];
+			TM.Day = num[2];
+			TM.Hour = num[3];
+			TM.Minute = num[4];
+			TM.Second = num[5];
+			Clock.clockSet(makeTime(TM));	// makeTime works out the weekday
+			*this << F("ok") << endl;
+		break;
 
+		case 6:	// alarm1
+		case 7:	// alarm2
+			if ((found != 2) || (num[0] > 23) || (num[1] > 59))
+			{
+				*this << F("Error: alarm hh:mm") << endl;
 				break;
-				case btnUP:
-				/* Your code here */ //Add 10 to variable hours
-				//If variable hours is 23< then subtract 20
-				if ((0 <= tid.Hour) & (tid.Hour < 14))
-				{
-					tid.Hour += 10;
-				} 
-				else if((14 <= tid.Hour) & (tid.Hour < 20))
-				{
-					tid.Hour -= 10;
-				}
-				else
-				{
-					tid.Hour -= 20;
-				}
-				
+			}
+			TM = Clock.clockGet();
+			TM.Hour = num[0];
+			TM.Minute = num[1];
+			TM.Second = 0;
+			if (cmd == 6)
+			{
+				RTC_alarm.alarm1_set(TM);
+			}
+			else
+			{
+				RTC_alarm.alarm2_set(TM);
+			}
+			*this << F("ok") << endl;
+		break;
+
+		case 8:	// binary
+			if ((found != 1) || (num[0] > 1))
+			{
+				*this << F("Error: binary 0|1") << endl;
 				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 10 to variable hours
-				// If variable hours is <0 then add 20
-				if ((0 <= tid.Hour) & (tid.Hour < 4))
-				{
-					tid.Hour += 20;
-				}
-				else if((4 <= tid.Hour) & (tid.Hour < 10))
+			}
+			*this << F("ok") << endl;
+			Telemetry.telemetryEnable(num[0]);
+		break;
+
+		case 9:	// journal
+			Journal.journalDump();
+		break;
+
+		case 10:	// sun
+			if (found)
+			{
+				if ((found != 1) || (num[0] > SUNtable))
 				{
-					tid.Hour += 10;
+					*this << F("Error: sun 0|1|2") << endl;
+					break;
 				}
-				else
+				if ((num[0] == SUNmanual) && (Config.configGet().mode != SUNmanual))
 				{
-					tid.Hour -= 10;
+					Config.configGet().mode = SUNmanual;
+					RTC_alarm.alarm_restore();	// Both daily again.
 				}
+				Config.configGet().mode = num[0];
+				Config.configSave();
+				Sun.sunInvalidate();
+			}
+			*this << F("sun ") << _DEC(Config.configGet().mode) << F(", place ");
+			consoleHundredths(Config.configGet().latitude);
+			*this << ' ';
+			consoleHundredths(Config.configGet().longitude);
+			*this << F(", offsets ") << _DEC(Config.configGet().openOffset) << ' ' << _DEC(Config.configGet().closeOffset);
+			*this << ' ' << Config.configGet().utcOffset << endl;
+			{
+				uint16_t day = Sun.sunDay(Clock.clockNow());
+				uint16_t rise, set;
+
+				Sun.sunCompute(day, &rise, &set);
+				*this << F("day ") << day << F(", UTC fixed ");
+				consoleI00(rise / 60, ':');
+				consoleI00(rise % 60, ' ');
+				consoleI00(set / 60, ':');
+				consoleI00(set % 60, 0);
+				Sun.sunLookup(day, &rise, &set);
+				*this << F(", table ");
+				consoleI00(rise / 60, ':');
+				consoleI00(rise % 60, ' ');
+				consoleI00(set / 60, ':');
+				consoleI00(set % 60, 0);
+				*this << endl;
+			}
+		break;
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 0, revert changes, see time
-				UIstate = 0;
-
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Go to UIstate 2, To change C2
-				UIstate = 2;
+		case 11:	// place
+		{
+			int32_t dec[2];
 
-				break;
-				default:
-				/* Your code here */
+			if ((consoleDecimals(line + length, dec, 2) != 2) || (dec[0] < -8900) || (dec[0] > 8900) ||
+				(dec[1] < -18000) || (dec[1] > 18000))
+			{
+				*this << F("Error: place latitude longitude, e.g. place 55.68 12.57") << endl;
 				break;
 			}
+			Config.configGet().latitude = dec[0];
+			Config.configGet().longitude = dec[1];
+			Config.configSave();
+			Sun.sunInvalidate();
+			*this << F("ok") << endl;
+		}
 		break;
 
-		case 2:
-			// Show time, blink C2
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift Klokkeslet";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(1,1);
-			lcd.blink();
+		case 12:	// offsets
+		{
+			int32_t dec[3];
 
-			switch (userState)
+			if ((consoleDecimals(line + length, dec, 3) != 3) || (dec[0] < -12000) || (dec[0] > 12000) ||
+				(dec[1] < -12000) || (dec[1] > 12000) || (dec[2] < -84000) || (dec[2] > 84000))
 			{
-				case btnSELECT:
-				/* Your code here */ //Do nothing
-
-				break;
-				case btnRESET:
-				/* Your code here */ //Do nothing
-
+				*this << F("Error: offsets open close utc, minutes") << endl;
 				break;
-				case btnUP:
-				/* Your code here */ //Add 1 to variable hours
-				//If variable hours is 23< then subtract 3
-				if ((9 == tid.Hour) | (19 == tid.Hour))
-				{
-					tid.Hour -= 9;
-				}
-				else if(23 == tid.Hour)
-				{
-					tid.Hour -= 3;
-				}
-				else
-				{
-					tid.Hour += 1;
-				}
+			}
+			Config.configGet().openOffset = dec[0] / 100;
+			Config.configGet().closeOffset = dec[1] / 100;
+			Config.configGet().utcOffset = dec[2] / 100;
+			Config.configSave();
+			Sun.sunInvalidate();
+			*this << F("ok") << endl;
+		}
+		break;
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 1 to variable hours
-				// If variable hours is <0 then add 9
-				if ((0 == tid.Hour) | (10 == tid.Hour))
+		case 13:	// week
+			if (found)
+			{
+				if ((found != 1) || (num[0] > 1))
 				{
-					tid.Hour += 9;
+					*this << F("Error: week 0|1") << endl;
+					break;
 				}
-				else if(20 == tid.Hour)
+				if (num[0])
 				{
-					tid.Hour += 3;
+					Config.configGet().mode = SCHweekly;
+					Week.weekInvalidate();
 				}
-				else
+				else if (Config.configGet().mode == SCHweekly)
 				{
-					tid.Hour -= 1;
+					Config.configGet().mode = SUNmanual;
+					RTC_alarm.alarm_restore();	// Both daily again.
 				}
-
+				Config.configSave();
+				*this << F("ok") << endl;
 				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 1, to change C1
-				UIstate = 1;
+			}
+			*this << F("week ") << (Config.configGet().mode == SCHweekly) << F(", ") << Week.weekCount();
+			*this << '/' << SCHentries << F(" events") << endl;
+			Week.weekDump();
+		break;
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ // Go to UIstate 3, To change C3
-				UIstate = 3;
+		case 14:	// weekadd
+		{
+			const char *p = line + length;
+			uint8_t days = 0, d;
 
+			// The first argument is a string of weekdays, 1 is Monday and 7 Sunday.
+			while (*p == ' ')
+			{
+				p++;
+			}
+			while ((*p >= '1') && (*p <= '7'))
+			{
+				days |= 1 << (*p++ - '1');
+			}
+			found = consoleNumbers(p, num, 4);
+			if (!days || (found < 3) || (num[0] > 23) || (num[1] > 59) || (num[2] < SCHopen) || (num[2] > SCHclose) ||
+				((found == 4) && (num[3] > 255)))
+			{
+				*this << F("Error: weekadd days hh:mm 1|2 [tenths], e.g. weekadd 12345 06:30 1") << endl;
 				break;
-				default:
-				/* Your code here */
-				break;
 			}
+			for (d = 0; d < 7; d++)
+			{
+				// Monday is day 1 of the week in the console, Sunday day 0 in SCH_Entry.
+				if ((days & (1 << d)) &&
+					!Week.weekAdd(((d + 1) % 7) * 1440 + num[0] * 60 + num[1], num[2], (found == 4) ? num[3] : 0))
+				{
+					*this << F("Error: ") << SCHentries << F(" events at most") << endl;
+					break;
+				}
+			}
+			if (d == 7)
+			{
+				*this << F("ok") << endl;
+			}
+		}
 		break;
-		case 3:
-			// Show time, blink C3
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift Klokkeslet";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(3,1);
-			lcd.blink();
 
-			switch (userState)
+		case 15:	// weekdel
+			if ((found < 1) || (found > 2) || (num[0] >= Week.weekCount()) || ((found == 2) && (num[1] < num[0])))
 			{
-				case btnSELECT:
-				/* Your code here */ // Do nothing
-
+				*this << F("Error: weekdel n [m], n to m of the list") << endl;
 				break;
-				case btnRESET:
-				/* Your code here */ //Do nothing
+			}
+			if ((found == 1) || (num[1] >= Week.weekCount()))
+			{
+				num[1] = (found == 1) ? num[0] : (Week.weekCount() - 1);
+			}
+			for (uint8_t n = num[1] - num[0] + 1; n; n--)
+			{
+				Week.weekDelete(num[0]);
+			}
+			*this << F("ok") << endl;
+		break;
 
+		case 16:	// lift
+			if (found && !num[0])
+			{
+				relayArray.relayStatsClear();
+				*this << F("ok") << endl;
 				break;
-				case btnUP:
-				/* Your code here */ //Add 10 to variable minutes
-				//If variable minutes is 59< then subtract 50
+			}
+			liftLine = 0;	// Queued by consolePoll.
+		break;
 
-				if ((50 <= tid.Minute))
-				{
-					tid.Minute -= 50;
-				}
-				else
+		case 17:	// dead
+			if (found)
+			{
+				if (num[0] > RAdeadMax)
 				{
-					tid.Minute += 10;
+					*this << F("Error: dead time is 0 to ") << RAdeadMax << F(" ms") << endl;
+					break;
 				}
+				Config.configGet().deadTime = num[0];
+				Config.configSave();
+			}
+			*this << F("dead time ") << Config.configGet().deadTime << F(" ms") << endl;
+		break;
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 10 to variable minutes
-				// If variable minutes is <0 then add 50
-				
-				if((0 <= tid.Minute) & (tid.Minute < 10))
+		case 18:	// ramp
+			if (found)
+			{
+				if ((num[0] > RMPscurve) || ((found > 1) && (!num[1] || (num[1] > RMPstepMax))))
 				{
-					tid.Minute += 50;
+					*this << F("Error: ramp 0 to ") << RMPscurve << F(", 1 to ") << RMPstepMax << F(" ms per step") << endl;
+					break;
 				}
-				else
+				Config.configGet().rampProfile = num[0];
+				if (found > 1)
 				{
-					tid.Minute -= 10;
+					Config.configGet().rampStep = num[1];
 				}
+				Config.configSave();
+			}
+			*this << F("ramp ") << Config.configGet().rampProfile << F(", ") << Config.configGet().rampStep << F(" ms per step");
+			if (RAtopology != RAbridge)
+			{
+				*this << F(", only used by RAbridge");
+			}
+			*this << endl;
+		break;
 
+		case 19:	// probes
+#if PRFenabled
+			if (found && !num[0])
+			{
+				Profiler.prfClear();
+				*this << F("ok") << endl;
 				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 2, to change C2
-				UIstate = 2;
-
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Go to UIstate 4, To change C4
-				UIstate = 4;
-
-				break;
-				default:
-				/* Your code here */
-				break;
 			}
+			// The histogram doubles from below PRFbinFirst us, the lines follow from consolePoll.
+			*this << F("probe n min max (us): <") << PRFbinFirst;
+			for (uint8_t i = 1; i < PRFbins - 1; i++)
+			{
+				*this << F(" <") << (PRFbinFirst << i);
+			}
+			*this << F(" more") << endl;
+			probeLine = 0;
+#else
+			*this << F("Error: probes not compiled in, set PRFenabled to 1") << endl;
+#endif
 		break;
-		case 4:
-			// Show time, blink C4
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift Klokkeslet";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(4,1);
-			lcd.blink();
 
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ // Go to UIstate 0, write time to timer module, 
-				UIstate = 0;
-				RTC.set(makeTime(tid));
+		default:
+			*this << F("Error: unknown command, try help") << endl;
+		break;
+	}
+}
 
-				break;
-				case btnRESET:
-				/* Your code here */ //Do nothing
 
-				break;
-				case btnUP:
-				/* Your code here */ //Add 1 to variable minutes
-				//If variable minutes is 59< then subtract 9
-				if ((tid.Minute == 9) | (tid.Minute == 19) | (tid.Minute == 29) | (tid.Minute == 39) | (tid.Minute == 49) | (tid.Minute == 59))
-				{
-					tid.Minute -= 9;
-				}
-				else
-				{
-					tid.Minute += 1;
-				}
+Telemetry_Binary::Telemetry_Binary() : enabled(TELdefault), lastCounters(0)
+{
+	// Constructor for the telemetry.
+}
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 1 to variable minutes
-				// If variable minutes is >0 then add 9
-				if ((tid.Minute == 0) | (tid.Minute == 10) | (tid.Minute == 20) | (tid.Minute == 30) | (tid.Minute == 40) | (tid.Minute == 50))
-				{
-					tid.Minute += 9;
-				}
-				else
-				{
-					tid.Minute -= 1;
-				}
+void Telemetry_Binary::telemetryEnable(boolean on)
+{
+	enabled = on;
+	telemetryTime();
+	telemetryCounters();
+}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 3, to change C3
-				UIstate = 3;
+boolean Telemetry_Binary::telemetryEnabled(void)
+{
+	return enabled;
+}
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Do nothing
+void Telemetry_Binary::telemetryPoll(void)
+{
+	if (enabled && ((Clock.clockNow() - lastCounters) >= TELperiod))
+	{
+		telemetryCounters();
+	}
+}
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
+void Telemetry_Binary::telemetryFrame(uint8_t type, uint8_t *payload, uint8_t length)
+{
+	uint32_t t = Clock.clockNow();
+	uint8_t crc = 0;
+	uint8_t i;
+
+	if (!enabled || (Console.consoleFree() < length + 4))
+	{
+		return;
+	}
+
+	payload[0] = t;
+	payload[1] = t >> 8;
+	payload[2] = t >> 16;
+	payload[3] = t >> 24;
+
+	Console.write(TELsync);
+	Console.write(type);
+	Console.write(length);
+	crc = _crc8_ccitt_update(crc, type);
+	crc = _crc8_ccitt_update(crc, length);
+	for (i = 0; i < length; i++)
+	{
+		Console.write(payload[i]);
+		crc = _crc8_ccitt_update(crc, payload[i]);
+	}
+	Console.write(crc);
+}
+
+void Telemetry_Binary::telemetryTime(void)
+{
+	uint8_t payload[4];
+
+	telemetryFrame(TELtime, payload, sizeof(payload));
+}
+
+void Telemetry_Binary::telemetryAlarm(uint8_t alarm)
+{
+	uint8_t payload[5];
+
+	payload[4] = alarm;
+	telemetryFrame(TELalarm, payload, sizeof(payload));
+}
+
+void Telemetry_Binary::telemetryRelay(uint8_t cmd)
+{
+	uint8_t payload[5];
+
+	payload[4] = cmd;
+	telemetryFrame(TELrelay, payload, sizeof(payload));
+}
+
+void Telemetry_Binary::telemetryCounters(void)
+{
+	uint8_t payload[12];
+	uint16_t counters[4] = { TELwakeups, TELliftRuns, TELalarms, TELsyncs };
+	uint8_t i;
+
+	for (i = 0; i < 4; i++)
+	{
+		payload[4 + 2 * i] = counters[i];
+		payload[5 + 2 * i] = counters[i] >> 8;
+	}
+	telemetryFrame(TELcounters, payload, sizeof(payload));
+	lastCounters = Clock.clockNow();
+}
+
+
+Event_Log::Event_Log() : head(0), tail(0), dropped(0)
+{
+	// Constructor for the log.
+}
+
+void Event_Log::logPost(uint8_t id, uint8_t arg, time_t t)
+{
+	uint8_t next = (head + 1) & (LOGqueue - 1);
+
+	if (next == tail)
+	{
+		dropped++;
+		return;
+	}
+	queue[head].id = id;
+	queue[head].arg = arg;
+	queue[head].t = t;
+	head = next;
+}
+
+boolean Event_Log::logPending(void)
+{
+	return (head != tail) || dropped;
+}
+
+void Event_Log::logDrain(void)
+{
+	while ((head != tail) && (Console.consoleFree() >= LOGlineMax))
+	{
+		logPrint(queue[tail]);
+		tail = (tail + 1) & (LOGqueue - 1);
+	}
+
+	if (dropped && (head == tail) && (Console.consoleFree() >= LOGlineMax))
+	{
+		Console << F("Log: ") << dropped << F(" entries dropped") << endl;
+		dropped = 0;
+	}
+}
+
+void Event_Log::logPrint(const LOG_Entry &entry)
+{
+	tmElements_t TM;
+
+	breakTime(entry.t, TM);
+	switch (entry.id)
+	{
+		case LOGalarm:
+			Console.consoleI00(TM.Day, ' ');
+			Console << TM.Month << ' ' << tmYearToCalendar(TM.Year) << ' ';
+			Console.consoleI00(TM.Hour, ':');
+			Console.consoleI00(TM.Minute, ':');
+			Console.consoleI00(TM.Second, 0);
+			Console << F(" --> Alarm ") << entry.arg << F(" triggered!") << endl;
 		break;
-		case 10:
-			// Show Alarm1
-			breakTime(RTC_alarm.alarm1_get(), tid);
 
-			lcd.noBlink();
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Doeren aabner:";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
+		case LOGfault:
+			Console.consoleI00(TM.Hour, ':');
+			Console.consoleI00(TM.Minute, ':');
+			Console.consoleI00(TM.Second, 0);
+			Console << F(" --> Lift fault, no end switch ") << ((entry.arg == liftCW) ? F("opening") : F("closing"));
+			Console << F(" within ") << Config.configGet().liftHold << F(" ms") << endl;
+		break;
+
+		case LOGdeviation:
+			Console.consoleI00(TM.Hour, ':');
+			Console.consoleI00(TM.Minute, ':');
+			Console.consoleI00(TM.Second, 0);
+			Console << F(" --> Lift ") << ((entry.arg == liftCW) ? F("opening") : F("closing")) << F(" took ");
+			Console << relayArray.relayStats(entry.arg).last << F(" ms, usually ");
+			Console << ((relayArray.relayStats(entry.arg).mean + 8) >> 4) << F(" ms") << endl;
+		break;
+
+		case LOGalarmSet:
+			Console << F("Alarm") << entry.arg << F(" set to ");
+			Console.consoleI00(TM.Hour, ':');
+			Console.consoleI00(TM.Minute, ':');
+			Console.consoleI00(TM.Second, 0);
+			Console << endl;
+		break;
+
+		default:
+			Console << F("Log: unknown entry ") << entry.id << endl;
+		break;
+	}
+}
+
+
+Config_Store::Config_Store() : slot(CFGslots - 1)
+{
+	// Constructor for the configuration, the defaults until configLoad.
+	record.version = CFGversion;
+	record.sequence = 0;
+	record.alarm1 = CFGopenDefault;
+	record.alarm2 = CFGcloseDefault;
+	record.liftHold = RAHold;
+	record.mode = SUNmanual;
+	record.latitude = SUNtableLatitude;
+	record.longitude = SUNtableLongitude;
+	record.openOffset = 0;
+	record.closeOffset = 0;
+	record.utcOffset = SUNutcDefault;
+	record.deadTime = RAdeadTime;
+	record.rampProfile = RMPprofileDefault;
+	record.rampStep = RMPstepDefault;
+	record.crc = 0;
+}
+
+uint16_t Config_Store::configCrc(const void *record, uint8_t length)
+{
+	const uint8_t *p = (const uint8_t *)record;
+	uint16_t crc = 0xFFFF;
+	uint8_t i;
+
+	for (i = 0; i < length; i++)
+	{
+		crc = _crc16_update(crc, p[i]);
+	}
+	return crc;
+}
 
-			switch (userState)
+boolean Config_Store::configLoad(void)
+{
+	CFG_Record candidate;
+	boolean found = false;
+	uint32_t legacy1, legacy2;
+	uint8_t schema, version, size, slots, i;
+	uint16_t crc;
+
+	// The newest record of the newest schema that has a valid one. Each schema divides the EEPROM below SCHaddress
+	// in slots of its size. Schema 3 used all of it before Week_Schedule, what is left above may be overwritten any time.
+	for (schema = 0; !found && (schema < CFGschemaCount); schema++)
+	{
+		version = pgm_read_byte(&CFGschemas[schema][0]);
+		size = pgm_read_byte(&CFGschemas[schema][1]);
+		slots = SCHaddress / size;
+		for (i = 0; i < slots; i++)
+		{
+			eeprom_read_block(&candidate, (const void *)((size_t)i * size), size);
+			memcpy(&crc, (const uint8_t *)&candidate + size - sizeof(crc), sizeof(crc));
+			if ((candidate.version != version) || (crc != configCrc(&candidate, size - sizeof(crc))))
+			{
+				continue;	// Erased, worn, half written or of another schema.
+			}
+			// Sequence numbers wrap, newer is at most half the range ahead.
+			if (!found || ((int16_t)(candidate.sequence - record.sequence) > 0))
 			{
-				case btnSELECT:
-				/* Your code here */ // Go to UIstate 11, to change C1
-				UIstate = 11;
+				memcpy(&record, &candidate, size - sizeof(crc));	// Over the defaults.
+				slot = i;
+				found = true;
+			}
+		}
+	}
+	if (found && (version != CFGversion))
+	{
+		// Migrated, saved in the current schema from the first slot on. The old records are ignored from now on.
+		if (version < 3)
+		{
+			record.mode = SUNmanual;
+		}
+		slot = CFGslots - 1;
+		configSave();
+	}
+	if (found)
+	{
+		return true;
+	}
+
+	// No record of any schema, keep the alarms of version 1.2 if it had set them.
+	eeprom_read_block(&legacy1, (const void *)CFGlegacyAlarm1, sizeof(legacy1));
+	eeprom_read_block(&legacy2, (const void *)CFGlegacyAlarm2, sizeof(legacy2));
+	if ((legacy1 != 0xFFFFFFFF) && (legacy2 != 0xFFFFFFFF))
+	{
+		record.alarm1 = legacy1;
+		record.alarm2 = legacy2;
+	}
+	return false;
+}
+
+void Config_Store::configSave(void)
+{
+	slot = (slot + 1) % CFGslots;
+	record.version = CFGversion;
+	record.sequence++;
+	record.crc = configCrc(&record, offsetof(CFG_Record, crc));
+	eeprom_update_block(&record, (void *)(slot * sizeof(CFG_Record)), sizeof(CFG_Record));
+}
 
-				break;
-				case btnRESET:
-				/* Your code here */ //Do nothing
+CFG_Record &Config_Store::configGet(void)
+{
+	return record;
+}
 
-				break;
-				case btnUP:
-				/* Your code here */ //Do nothing
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //Do nothing
+Journal_AT24C32::Journal_AT24C32() : pageIndex(0), pageLength(0), sequence(0), last(0), dirty(false), dirtySince(0),
+	writeIndex(0), fullIndex(0), fullWaiting(false), lost(0), dumpIndex(0), dumpLeft(0), dumpOffset(0), dumpTime(0), dumpRecords(0), dumpReading(false)
+{
+	// Constructor for the journal. Both requests retry while the AT24C32 is in its write cycle.
+	memset(&reader, 0, sizeof(reader));
+	reader.address = JRNaddr;
+	reader.regLength = 2;
+	reader.timeout = JRNpollMax;
+	reader.retry = true;
+	reader.done = journalReadDone;
+	writer = reader;
+	writer.tx = written;
+	writer.txLength = JRNpage;
+	writer.done = journalWriteDone;
+}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 0, we go to Time
-				UIstate = 0;
+boolean Journal_AT24C32::journalFetch(uint8_t index, uint8_t *buffer, uint8_t length)
+{
+	uint16_t addr = index * JRNpage;
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Go to UIstate 20, we go to Alarm2
-				UIstate = 20;
+	reader.reg[0] = addr >> 8;
+	reader.reg[1] = addr;
+	reader.rx = buffer;
+	reader.rxLength = length;
+	return I2C.twiSubmit(reader);
+}
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
-		break;
-		case 11:
-			// Show Alarm1, blink C1
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift aabning:";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(0,1);
-			lcd.blink();
+void Journal_AT24C32::journalReadEnded(void)
+{
+	if (dumpReading)
+	{
+		Events.eventPost(EVTtwi, 0, 0);		// journalPoll prints the page.
+	}
+}
 
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ //Do nothing
+void Journal_AT24C32::journalWriteEnded(boolean ok)
+{
+	if (!ok && (writeIndex == pageIndex))
+	{
+		dirty = true;		// Written again by the next journalFlush, dirtySince is kept.
+	}
+	if (fullWaiting)
+	{
+		fullWaiting = false;
+		journalWrite(fullIndex, full);
+	}
+}
 
-				break;
-				case btnRESET:
-				/* Your code here */ //Do nothing
+void Journal_AT24C32::journalStart(uint8_t index, time_t t)
+{
+	pageIndex = index;
+	sequence++;
+	if (sequence == 0xFFFF)		// Reads as an erased page.
+	{
+		sequence = 0;
+	}
+	memset(page, 0xFF, sizeof(page));
+	page[0] = t;
+	page[1] = t >> 8;
+	page[2] = t >> 16;
+	page[3] = t >> 24;
+	page[4] = sequence;
+	page[5] = sequence >> 8;
+	pageLength = JRNheader;
+	last = t;
+}
 
-				break;
-				case btnUP:
-				/* Your code here */ //Add 10 to variable hours
-				//If variable hours is 23< then subtract 20
-				if ((0 <= tid.Hour) & (tid.Hour < 14))
-				{
-					tid.Hour += 10;
-				}
-				else if((14 <= tid.Hour) & (tid.Hour < 20))
-				{
-					tid.Hour -= 10;
-				}
-				else
-				{
-					tid.Hour -= 20;
-				}
-				
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 10 to variable hours
-				// If variable hours is <0 then add 20
-				if ((0 <= tid.Hour) & (tid.Hour < 4))
-				{
-					tid.Hour += 20;
-				}
-				else if((4 <= tid.Hour) & (tid.Hour < 10))
-				{
-					tid.Hour += 10;
-				}
-				else
-				{
-					tid.Hour -= 10;
-				}
+void Journal_AT24C32::journalInit(void)
+{
+	uint8_t header[JRNheader];
+	uint16_t seq;
+	boolean found = false;
+	uint8_t newest = 0;
+	uint8_t i;
+
+	// One pass over the headers, the newest page has the highest sequence number (which wraps).
+	// setup() waits for each read, loop() takes the pages of a dump from journalReadEnded instead.
+	for (i = 0; i < JRNpages; i++)
+	{
+		if (journalFetch(i, header, JRNheader))
+		{
+			I2C.twiWait();
+		}
+		if (reader.status != TWIdone)
+		{
+			return;		// No AT24C32, the journal stays off.
+		}
+		seq = header[4] | (header[5] << 8);
+		if ((seq != 0xFFFF) && (!found || ((int16_t)(seq - sequence) > 0)))
+		{
+			sequence = seq;
+			newest = i;
+			found = true;
+		}
+	}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 10, revert changes, see alarm1
-				UIstate = 10;
+	if (found && journalFetch(newest, page, JRNpage))
+	{
+		I2C.twiWait();
+	}
+	if (found && (reader.status == TWIdone))
+	{
+		// Continue the newest page, its records end at the first 0xFF.
+		pageIndex = newest;
+		last = (uint32_t)page[0] | ((uint32_t)page[1] << 8) | ((uint32_t)page[2] << 16) | ((uint32_t)page[3] << 24);
+		pageLength = JRNheader;
+		while ((pageLength < JRNpage) && (page[pageLength] != 0xFF))
+		{
+			journalDecode(page, &pageLength, &last);
+		}
+	}
+	else
+	{
+		journalStart(0, Clock.clockNow());
+	}
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ // Go to UIstate 12, To change C2
-				UIstate = 12;
+	journalAdd(JRNboot, 0);
+}
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
-		break;
-		case 12:
-			// Show Alarm1, blink C2
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift aabning:";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(1,1);
-			lcd.blink();
+void Journal_AT24C32::journalAdd(uint8_t type, uint8_t arg)
+{
+	time_t t = Clock.clockNow();
+	uint8_t record[6];
+	uint8_t length = 1;
+	uint32_t delta;
 
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ //Do nothing
+	if (!pageLength)	// Before journalInit, or without an AT24C32.
+	{
+		return;
+	}
 
-				break;
-				case btnRESET:
-				/* Your code here */ //Do nothing
+	record[0] = (type & JRNtypeMask) | (arg & JRNargMask);
+	if ((type == JRNclock) || (t < last))
+	{
+		// Absolute time after the clock was set, deltas can not go backwards.
+		record[0] = JRNclock;
+		record[1] = t;
+		record[2] = t >> 8;
+		record[3] = t >> 16;
+		record[4] = t >> 24;
+		length = 5;
+	}
+	else
+	{
+		delta = t - last;
+		while (delta >= 0x80)
+		{
+			record[length++] = (delta & 0x7F) | 0x80;
+			delta >>= 7;
+		}
+		record[length++] = delta;
+	}
 
-				break;
-				case btnUP:
-				/* Your code here */ //Add 1 to variable hours
-				//If variable hours is 23< then subtract 3
-				if ((9 == tid.Hour) | (19 == tid.Hour))
-				{
-					tid.Hour -= 9;
-				}
-				else if(23 == tid.Hour)
-				{
-					tid.Hour -= 3;
-				}
-				else
-				{
-					tid.Hour += 1;
-				}
+	if (pageLength + length > JRNpage)
+	{
+		// Page full, write it and start the next one. The new header carries the time.
+		noInterrupts();
+		if (dirty && I2C.twiPending(writer))
+		{
+			if (fullWaiting)
+			{
+				// Two pages filled during one write, which takes at most JRNpollMax ms.
+				interrupts();
+				lost++;
+				return;
+			}
+			memcpy(full, page, JRNpage);	// journalWriteEnded writes it.
+			fullIndex = pageIndex;
+			fullWaiting = true;
+			dirty = false;
+		}
+		interrupts();
+		journalFlush();
+		journalStart((pageIndex + 1) % JRNpages, t);
+		if (type == JRNclock)
+		{
+			return;
+		}
+		record[0] = (type & JRNtypeMask) | (arg & JRNargMask);
+		record[1] = 0;
+		length = 2;
+	}
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 1 to variable hours
-				// If variable hours is <0 then add 9
-				if ((0 == tid.Hour) | (10 == tid.Hour))
-				{
-					tid.Hour += 9;
-				}
-				else if(20 == tid.Hour)
-				{
-					tid.Hour += 3;
-				}
-				else
-				{
-					tid.Hour -= 1;
-				}
+	memcpy(page + pageLength, record, length);
+	pageLength += length;
+	last = t;
+	if (!dirty)
+	{
+		dirty = true;
+		dirtySince = t;
+	}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 11, To change C1
-				UIstate = 11;
+	// A JRNclock record only stamps the time, what happened is in the argument of the next one.
+	if ((record[0] == JRNclock) && (type != JRNclock))
+	{
+		journalAdd(type, arg);
+	}
+}
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ // Go to UIstate 13, To change C3
-				UIstate = 13;
+boolean Journal_AT24C32::journalFlush(void)
+{
+	boolean queued;
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
-		break;
-		case 13:
-			// Show Alarm1, blink C3
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift aabning:";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(3,1);
-			lcd.blink();
+	noInterrupts();
+	if (!dirty || I2C.twiPending(writer))
+	{
+		interrupts();
+		return false;
+	}
+	// The whole page in one write cycle, bytes after the records stay 0xFF.
+	queued = journalWrite(pageIndex, page);
+	dirty = !queued;
+	interrupts();
+	return queued;
+}
 
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ // Go to UIstate 14, To change C4
+boolean Journal_AT24C32::journalWrite(uint8_t index, const uint8_t *buffer)
+{
+	uint16_t addr = index * JRNpage;
 
-				break;
-				case btnRESET:
-				/* Your code here */ //Go to UIstate 12, To change C2
+	memcpy(written, buffer, JRNpage);
+	writeIndex = index;
+	writer.reg[0] = addr >> 8;
+	writer.reg[1] = addr;
+	return I2C.twiSubmit(writer);
+}
 
-				break;
-				case btnUP:
-				/* Your code here */ //Add 10 to variable minutes
-				//If variable minutes is 59< then subtract 50
+void Journal_AT24C32::journalPoll(void)
+{
+	if (dirty && ((Clock.clockNow() - dirtySince) >= JRNmaxAge))
+	{
+		journalFlush();
+	}
 
-				if ((50 <= tid.Minute))
-				{
-					tid.Minute -= 50;
-				}
-				else
-				{
-					tid.Minute += 10;
-				}
+	while (dumpOffset && (Console.consoleFree() >= LOGlineMax) && !I2C.twiPending(reader))
+	{
+		if (!journalDumpNext())
+		{
+			Console << F("journal: ") << dumpRecords << F(" records, ") << lost << F(" lost") << endl;
+			dumpOffset = 0;
+		}
+	}
+}
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 10 to variable minutes
-				// If variable minutes is <0 then add 50
-				
-				if((0 <= tid.Minute) & (tid.Minute < 10))
-				{
-					tid.Minute += 50;
-				}
-				else
-				{
-					tid.Minute -= 10;
-				}
+void Journal_AT24C32::journalDump(void)
+{
+	journalFlush();		// So the dump only reads the AT24C32.
+	dumpIndex = pageIndex;	// The page after the newest is the oldest.
+	dumpLeft = JRNpages;
+	dumpOffset = JRNpage;	// Read a page first.
+	dumpRecords = 0;
+	dumpReading = false;
+}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Do nothing
-				UIstate = 12;
+uint8_t Journal_AT24C32::journalDecode(const uint8_t *buffer, uint8_t *offset, time_t *t)
+{
+	uint8_t first = buffer[(*offset)++];
+	uint32_t delta = 0;
+	uint8_t shift = 0;
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Do nothing
-				UIstate = 14;
+	if ((first & JRNtypeMask) == JRNclock)
+	{
+		if (*offset + 4 <= JRNpage)
+		{
+			*t = (uint32_t)buffer[*offset] | ((uint32_t)buffer[*offset + 1] << 8) |
+				((uint32_t)buffer[*offset + 2] << 16) | ((uint32_t)buffer[*offset + 3] << 24);
+		}
+		*offset += 4;
+		return first;
+	}
 
-				break;
-				default:
-				/* Your code here */
+	while (*offset < JRNpage)
+	{
+		delta |= (uint32_t)(buffer[*offset] & 0x7F) << shift;
+		shift += 7;
+		if (!(buffer[(*offset)++] & 0x80))
+		{
 			break;
-			}
-		break;
-		case 14:
-			// Show Alarm1, blink C4
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift aabning:";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(4,1);
-			lcd.blink();
-
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ // Go to UIstate 10, Write Alarm1 to timer module
-				UIstate = 10;
-				RTC_alarm.alarm1_set(tid);
-				
-				break;
-				case btnRESET:
-				/* Your code here */ //Go to UIstate 13, To change C3
+		}
+	}
+	*t += delta;
+	return first;
+}
 
-				break;
-				case btnUP:
-				/* Your code here */ //Add 1 to variable minutes
-				//If variable minutes is 59< then subtract 9
-				if ((tid.Minute == 9) | (tid.Minute == 19) | (tid.Minute == 29) | (tid.Minute == 39) | (tid.Minute == 49) | (tid.Minute == 59))
-				{
-					tid.Minute -= 9;
-				}
-				else
-				{
-					tid.Minute += 1;
-				}
+boolean Journal_AT24C32::journalDumpNext(void)
+{
+	tmElements_t TM;
+	uint8_t type, arg;
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 1 to variable minutes
-				// If variable minutes is >0 then add 9
-				if ((tid.Minute == 0) | (tid.Minute == 10) | (tid.Minute == 20) | (tid.Minute == 30) | (tid.Minute == 40) | (tid.Minute == 50))
-				{
-					tid.Minute += 9;
-				}
-				else
-				{
-					tid.Minute -= 1;
-				}
+	// Next page with records, skipping erased ones. journalPoll calls again when the read has ended.
+	while ((dumpOffset >= JRNpage) || (dump[dumpOffset] == 0xFF))
+	{
+		if (!dumpReading)
+		{
+			if (!dumpLeft)
+			{
+				return false;
+			}
+			dumpIndex = (dumpIndex + 1) % JRNpages;
+			dumpLeft--;
+			dumpReading = journalFetch(dumpIndex, dump, JRNpage);
+			return dumpReading;
+		}
+		dumpReading = false;
+		if (reader.status != TWIdone)
+		{
+			return false;
+		}
+		if ((dump[4] & dump[5]) == 0xFF)
+		{
+			dumpOffset = JRNpage;
+			continue;
+		}
+		dumpTime = (uint32_t)dump[0] | ((uint32_t)dump[1] << 8) | ((uint32_t)dump[2] << 16) | ((uint32_t)dump[3] << 24);
+		dumpOffset = JRNheader;
+	}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 3, to change C3
-				UIstate = 13;
+	arg = journalDecode(dump, &dumpOffset, &dumpTime);
+	type = arg & JRNtypeMask;
+	arg &= JRNargMask;
+	dumpRecords++;
+
+	breakTime(dumpTime, TM);
+	Console << tmYearToCalendar(TM.Year) << '-';
+	Console.consoleI00(TM.Month, '-');
+	Console.consoleI00(TM.Day, ' ');
+	Console.consoleI00(TM.Hour, ':');
+	Console.consoleI00(TM.Minute, ':');
+	Console.consoleI00(TM.Second, ' ');
+	switch (type)
+	{
+		case JRNclock:
+			Console << F("clock set");
+		break;
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Do nothing
+		case JRNboot:
+			Console << F("boot");
+		break;
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
+		case JRNalarm:
+			Console << F("alarm ") << arg;
 		break;
-		case 20:
-			// Show Alarm2
-			breakTime(RTC_alarm.alarm2_get(), tid);
-			
-			lcd.noBlink();
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Doeren Lukker:";
-			lcd.setCursor(0,1);
-			
 
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
+		case JRNrelay:
+		case JRNmanual:
+			Console << ((type == JRNrelay) ? F("lift ") : F("manual "));
+			Console << ((arg == liftCW) ? F("open") : ((arg == liftCCW) ? F("close") : F("stop")));
+		break;
 
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ // Go to UIstate 21, To change C1
-				UIstate = 21;
+		case JRNfault:
+			Console << F("fault, no end switch ") << ((arg == liftCW) ? F("opening") : F("closing"));
+		break;
 
-				break;
-				case btnRESET:
-				/* Your code here */ //Do nothing
+		case JRNdeviation:
+			Console << F("fault, unusual travel time ") << ((arg == liftCW) ? F("opening") : F("closing"));
+		break;
 
-				break;
-				case btnUP:
-				/* Your code here */ //Do nothing
+		default:
+			Console << F("record ") << (type >> 4);
+		break;
+	}
+	Console << endl;
+	return true;
+}
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //Do nothing
+boolean Journal_AT24C32::journalBusy(void)
+{
+	return dumpOffset != 0;
+}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 10, we go to Alarm1
-				UIstate = 10;
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Go to UIstate 0, we go to Time
-				UIstate = 0;
+Solar_Schedule::Solar_Schedule()
+{
+	// Constructor for the solar schedule.
+	sunInvalidate();
+}
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
-		break;
-		case 21:
-			// Show Alarm2, blink C1
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift lukketid:";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(0,1);
-			lcd.blink();
+void Solar_Schedule::sunInvalidate(void)
+{
+	armed[0] = 0;
+	armed[1] = 0;
+}
 
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ // Do nothing
+int32_t Solar_Schedule::sunSin(uint16_t angle)
+{
+	uint16_t i = angle & 0x3FFF;	// Angle within the quadrant
+	uint8_t k;
+	int32_t v;
 
-				break;
-				case btnRESET:
-				/* Your code here */ // Do nothing
+	if (angle & 0x4000)		// 2nd and 4th quadrant mirror the 1st
+	{
+		i = 0x4000 - i;
+	}
+	k = i >> 8;
+	if (k >= 64)
+	{
+		v = pgm_read_word(&SUNsin[64]);
+	}
+	else
+	{
+		v = pgm_read_word(&SUNsin[k]);
+		v += ((int32_t)(pgm_read_word(&SUNsin[k + 1]) - v) * (i & 0xFF)) >> 8;
+	}
+	return (angle & 0x8000) ? -v : v;
+}
 
-				break;
-				case btnUP:
-				/* Your code here */ //Add 10 to variable hours
-				//If variable hours is 23< then subtract 20
-				if ((0 <= tid.Hour) & (tid.Hour < 14))
-				{
-					tid.Hour += 10;
-				}
-				else if((14 <= tid.Hour) & (tid.Hour < 20))
-				{
-					tid.Hour -= 10;
-				}
-				else
-				{
-					tid.Hour -= 20;
-				}
-				
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 10 to variable hours
-				// If variable hours is <0 then add 20
-				if ((0 <= tid.Hour) & (tid.Hour < 4))
-				{
-					tid.Hour += 20;
-				}
-				else if((4 <= tid.Hour) & (tid.Hour < 10))
-				{
-					tid.Hour += 10;
-				}
-				else
-				{
-					tid.Hour -= 10;
-				}
+int32_t Solar_Schedule::sunCos(uint16_t angle)
+{
+	return sunSin(angle + 0x4000);
+}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 20, revert changes, see Alarm2
-				UIstate = 20;
+uint16_t Solar_Schedule::sunAcos(int32_t x)
+{
+	uint16_t low = 0, high = 0x8000, middle;
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Go to UIstate 22
-				UIstate = 22;
+	// Midnight sun or polar night, clamp.
+	if (x >= 32768)
+	{
+		return 0;
+	}
+	if (x <= -32768)
+	{
+		return 0x8000;
+	}
+	// cos() falls from 0 to 180 degrees.
+	while ((high - low) > 1)
+	{
+		middle = (low + high) >> 1;
+		if (sunCos(middle) > x)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
-		break;
-		case 22:
-			// Show Alarm2, blink C2
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift lukketid:";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(1,1);
-			lcd.blink();
+void Solar_Schedule::sunCompute(uint16_t day, uint16_t *rise, uint16_t *set)
+{
+	uint16_t g = (uint32_t)(day - 1) * 65536UL / 365;	// Fractional year
+	int32_t c1 = sunCos(g), s1 = sunSin(g);
+	int32_t c2 = sunCos(2 * g), s2 = sunSin(2 * g);
+	int32_t c3 = sunCos(3 * g), s3 = sunSin(3 * g);
+	uint16_t declination, latitude, hourAngle;
+	int32_t eqtime, numerator, denominator, cosHourAngle, noon, half;
+
+	// Declination as a binary angle, the coefficients in radians * 65536 / 2pi * 4.
+	declination = (289L * 32768 - 16685L * c1 + 2931L * s1 - 282L * c2 + 38L * s2 - 113L * c3 + 62L * s3) >> 17;
+
+	// Equation of time in seconds, the coefficients in minutes * 60 * 64.
+	eqtime = (66L * 32768 + 1644L * c1 - 28230L * s1 - 12862L * c2 - 35948L * s2) >> 21;
+
+	// cos(hour angle) = (sin(horizon) - sin(lat) sin(decl)) / (cos(lat) cos(decl)), in Q15.
+	latitude = (int32_t)Config.configGet().latitude * 16384 / 9000;
+	numerator = ((int32_t)SUNhorizon << 15) - sunSin(latitude) * sunSin(declination);
+	denominator = (sunCos(latitude) * sunCos(declination)) >> 15;
+	cosHourAngle = denominator ? (numerator / denominator) : -32768;
+	hourAngle = sunAcos(cosHourAngle);
+
+	// Seconds after midnight UTC: noon moves 4 minutes per degree of longitude.
+	noon = 43200L - (int32_t)Config.configGet().longitude * 12 / 5 - eqtime;
+	half = (int32_t)hourAngle * 675 / 512;		// 86400 s / 65536
+	*rise = ((noon - half + 30 + SECS_PER_DAY) / 60) % 1440;
+	*set = ((noon + half + 30 + SECS_PER_DAY) / 60) % 1440;
+}
 
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ // Do nothing
+void Solar_Schedule::sunLookup(uint16_t day, uint16_t *rise, uint16_t *set)
+{
+	uint8_t b1 = pgm_read_byte(&SUNdays[day - 1][1]);
 
-				break;
-				case btnRESET:
-				/* Your code here */ // Do nothing
+	*rise = pgm_read_byte(&SUNdays[day - 1][0]) | ((b1 & 0x0F) << 8);
+	*set = (b1 >> 4) | (pgm_read_byte(&SUNdays[day - 1][2]) << 4);
+}
 
-				break;
-				case btnUP:
-				/* Your code here */ //Add 1 to variable hours
-				//If variable hours is 23< then subtract 3
-				if ((9 == tid.Hour) | (19 == tid.Hour))
-				{
-					tid.Hour -= 9;
-				}
-				else if(23 == tid.Hour)
-				{
-					tid.Hour -= 3;
-				}
-				else
-				{
-					tid.Hour += 1;
-				}
+uint16_t Solar_Schedule::sunDay(time_t t)
+{
+	tmElements_t TM;
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 1 to variable hours
-				// If variable hours is <0 then add 9
-				if ((0 == tid.Hour) | (10 == tid.Hour))
-				{
-					tid.Hour += 9;
-				}
-				else if(20 == tid.Hour)
-				{
-					tid.Hour += 3;
-				}
-				else
-				{
-					tid.Hour -= 1;
-				}
+	breakTime(t, TM);
+	TM.Month = 1;
+	TM.Day = 1;
+	return elapsedDays(t) - elapsedDays(makeTime(TM)) + 1;
+}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ //Go to UIstate 21 to change C1
-				UIstate = 21;
+time_t Solar_Schedule::sunNext(time_t after, boolean open)
+{
+	time_t midnight = previousMidnight(after);
+	time_t t = after;
+	uint16_t rise, set;
+	int16_t minutes;
+	uint8_t i;
+
+	// Today's time, or tomorrow's once today's has passed.
+	for (i = 0; i < 2; i++, midnight += SECS_PER_DAY)
+	{
+		if (Config.configGet().mode == SUNtable)
+		{
+			sunLookup(sunDay(midnight), &rise, &set);
+		}
+		else
+		{
+			sunCompute(sunDay(midnight), &rise, &set);
+		}
+		minutes = open ? (rise + Config.configGet().openOffset) : (set + Config.configGet().closeOffset);
+		minutes = (minutes + Config.configGet().utcOffset + 2 * 1440) % 1440;
+		t = midnight + minutes * 60L;
+		if (t > after)
+		{
+			break;
+		}
+	}
+	return t;
+}
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ //Go to UIstate 23 to change C3
-				UIstate = 23;
+void Solar_Schedule::sunPoll(void)
+{
+	time_t now = Clock.clockNow();
+	time_t after;
+	uint8_t i;
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
-		break;
-		case 23:
-			// Show Alarm2, blink C3
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift lukketid:";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(3,1);
-			lcd.blink();
+	// An alarm not yet handled would be cleared by alarm_program.
+	if (((Config.configGet().mode != SUNfixed) && (Config.configGet().mode != SUNtable)) || RTC_alarm.alarm_Pending())
+	{
+		return;
+	}
 
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ // Do nothing
+	for (i = 0; i < 2; i++)
+	{
+		// Timer1 may tick into the armed second before the DS3231 does, rearming
+		// then would clear the alarm before it fires.
+		if (now < armed[i] + SUNgrace)
+		{
+			continue;
+		}
+		// Once an alarm has fired, its next time is on the next day, even if the sun
+		// comes later today than the time it fired at. The date is matched as well,
+		// so tomorrow's time cannot fire today.
+		after = armed[i] ? (previousMidnight(armed[i]) + SECS_PER_DAY - 1) : now;
+		if (after < now)
+		{
+			after = now;
+		}
+		armed[i] = sunNext(after, i == 0);
+		RTC_alarm.alarm_program(i + 1, armed[i], ALMdate);
+	}
 
-				break;
-				case btnRESET:
-				/* Your code here */ // Do nothing
+	// Shown by the UI and status, saved only with the next change of the configuration.
+	Config.configGet().alarm1 = armed[0];
+	Config.configGet().alarm2 = armed[1];
+}
 
-				break;
-				case btnUP:
-				/* Your code here */ //Add 10 to variable minutes
-				//If variable minutes is 59< then subtract 50
 
-				if ((50 <= tid.Minute))
-				{
-					tid.Minute -= 50;
-				}
-				else
-				{
-					tid.Minute += 10;
-				}
+Week_Schedule::Week_Schedule() : count(0), armed(false), hold(0), armedTime(0), fired(false), dumpIndex(SCHidle)
+{
+	// Constructor for the weekly schedule, empty until weekLoad.
+}
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 10 to variable minutes
-				// If variable minutes is <0 then add 50
-				
-				if((0 <= tid.Minute) & (tid.Minute < 10))
-				{
-					tid.Minute += 50;
-				}
-				else
-				{
-					tid.Minute -= 10;
-				}
+void Week_Schedule::weekLoad(void)
+{
+	SCH_Header header;
+	uint16_t crc = 0xFFFF;
+	uint16_t i;
 
-				break;
-				case btnLEFT:
-				/* Your code here */ // Go to UIstate 22 to change C2
+	eeprom_read_block(&header, (const void *)SCHaddress, sizeof(header));
+	count = 0;
+	if ((header.version != SCHversion) || (header.count > SCHentries))
+	{
+		return;		// Erased, or of another schema.
+	}
+	crc = _crc16_update(crc, header.count);
+	crc = _crc16_update(crc, header.version);
+	for (i = 0; i < header.count * sizeof(SCH_Entry); i++)
+	{
+		crc = _crc16_update(crc, eeprom_read_byte((const uint8_t *)(SCHaddress + sizeof(SCH_Header) + i)));
+	}
+	if (crc == header.crc)
+	{
+		count = header.count;
+	}
+	armed = false;
+}
 
-				UIstate = 22;
+void Week_Schedule::weekSeal(void)
+{
+	SCH_Header header;
+	uint16_t crc = 0xFFFF;
+	uint16_t i;
+
+	header.count = count;
+	header.version = SCHversion;
+	crc = _crc16_update(crc, header.count);
+	crc = _crc16_update(crc, header.version);
+	for (i = 0; i < count * sizeof(SCH_Entry); i++)
+	{
+		crc = _crc16_update(crc, eeprom_read_byte((const uint8_t *)(SCHaddress + sizeof(SCH_Header) + i)));
+	}
+	header.crc = crc;
+	eeprom_update_block(&header, (void *)SCHaddress, sizeof(header));
+}
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ // Go to UIstate 24 to change C4
+SCH_Entry Week_Schedule::weekGet(uint8_t index)
+{
+	SCH_Entry entry;
 
-				UIstate = 24;
+	eeprom_read_block(&entry, (const void *)(SCHaddress + sizeof(SCH_Header) + index * sizeof(SCH_Entry)), sizeof(entry));
+	return entry;
+}
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
-		break;
-		case 24:
-			// Show Alarm2, blink C4
-			lcd.clear();
-			lcd.setCursor(0,0);
-			lcd << "Skift lukketid:";
-			lcd.setCursor(0,1);
-			lcd << ((tid.Hour<10) ? "0" : "") << tid.Hour << ":" << ((tid.Minute<10) ? "0" : "") << tid.Minute << "";
-			lcd.setCursor(4,1);
-			lcd.blink();
+uint8_t Week_Schedule::weekCount(void)
+{
+	return count;
+}
 
-			switch (userState)
-			{
-				case btnSELECT:
-				/* Your code here */ // Go to UIstate 20, Write Alarm2 to timer module
-				UIstate = 20;
-				RTC_alarm.alarm2_set(tid);
+uint16_t Week_Schedule::weekHold(void)
+{
+	return hold;
+}
 
-				break;
-				case btnRESET:
-				/* Your code here */ // Do nothing
+void Week_Schedule::weekInvalidate(void)
+{
+	armed = false;
+}
 
-				break;
-				case btnUP:
-				/* Your code here */ //Add 1 to variable minutes
-				//If variable minutes is 59< then subtract 9
-				if ((tid.Minute == 9) | (tid.Minute == 19) | (tid.Minute == 29) | (tid.Minute == 39) | (tid.Minute == 49) | (tid.Minute == 59))
-				{
-					tid.Minute -= 9;
-				}
-				else
-				{
-					tid.Minute += 1;
-				}
+uint8_t Week_Schedule::weekFind(uint16_t minute)
+{
+	uint8_t low = 0, high = count, middle;
 
-				break;
-				case btnDOWN:
-				/* Your code here */ //subtract 1 to variable minutes
-				// If variable minutes is >0 then add 9
-				if ((tid.Minute == 0) | (tid.Minute == 10) | (tid.Minute == 20) | (tid.Minute == 30) | (tid.Minute == 40) | (tid.Minute == 50))
-				{
-					tid.Minute += 9;
-				}
-				else
-				{
-					tid.Minute -= 1;
-				}
+	// Only the minute of each probed entry is read, 6 probes for a full table.
+	while (low < high)
+	{
+		middle = (low + high) >> 1;
+		if (eeprom_read_word((const uint16_t *)(SCHaddress + sizeof(SCH_Header) + middle * sizeof(SCH_Entry))) < minute)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
 
-				break;
-				case btnLEFT:
-				/* Your code here */ // Go to UIstate 23 to change C3
+boolean Week_Schedule::weekAdd(uint16_t minute, uint8_t action, uint8_t hold)
+{
+	SCH_Entry entry = { minute, action, hold };
+	uint8_t index = weekFind(minute);
+	uint8_t i;
 
-				UIstate = 23;
+	if ((index == count) || (weekGet(index).minute != minute))
+	{
+		if (count == SCHentries)
+		{
+			return false;
+		}
+		// Move the later events up one place, the last one first.
+		for (i = count; i > index; i--)
+		{
+			SCH_Entry moved = weekGet(i - 1);
+			eeprom_update_block(&moved, (void *)(SCHaddress + sizeof(SCH_Header) + i * sizeof(SCH_Entry)), sizeof(moved));
+		}
+		count++;
+	}
+	eeprom_update_block(&entry, (void *)(SCHaddress + sizeof(SCH_Header) + index * sizeof(SCH_Entry)), sizeof(entry));
+	weekSeal();
+	armed = false;
+	return true;
+}
 
-				break;
-				case btnRIGHT:
-				/* Your code here */ // Do nothing
+void Week_Schedule::weekDelete(uint8_t index)
+{
+	uint8_t i;
 
-				break;
-				default:
-				/* Your code here */
-				break;
-			}
-		break;
-		default:	// default state, aka state 0.
-			// user input
-		break;
+	if (index >= count)
+	{
+		return;
 	}
+	for (i = index + 1; i < count; i++)
+	{
+		SCH_Entry moved = weekGet(i);
+		eeprom_update_block(&moved, (void *)(SCHaddress + sizeof(SCH_Header) + (i - 1) * sizeof(SCH_Entry)), sizeof(moved));
+	}
+	count--;
+	weekSeal();
+	armed = false;
 }
 
-
-DS3231RTC_Alarms::DS3231RTC_Alarms()
+uint16_t Week_Schedule::weekMinute(time_t t)
 {
-	// Constructor for the alarms class.
-
- 	alarm1_time.long_time = 0;
- 	alarm2_time.long_time = 0;
+	return (weekday(t) - 1) * 1440 + hour(t) * 60 + minute(t);
 }
 
-void DS3231RTC_Alarms::init_alarms(void)
+void Week_Schedule::weekArm(void)
 {
-	// Setup the SQW interrupt:
-	DDRD &= ~(1 << DDD2); // make INT0 an input.
-	PORTD |= (1 << DDD2); // enable pull-up on INT0.
-	attachInterrupt(INT0, alarmIsr, FALLING);	// Initializing the INT0 interrupt in the Arduino way.
-	
-	//Disable the default square wave of the SQW pin.
-	RTC.squareWave(SQWAVE_NONE);
-	
-	//Prepare alarm1 for the interrupt.
-	RTC.alarm(ALARM_1);                   //ensure RTC interrupt flag is cleared
-	RTC.alarmInterrupt(ALARM_1, true);
+	time_t now = Clock.clockNow();
+	time_t t;
+	SCH_Entry entry;
+	uint8_t index;
 
-	//Prepare alarm1 for the interrupt.
-	RTC.alarm(ALARM_2);                   //ensure RTC interrupt flag is cleared
-	RTC.alarmInterrupt(ALARM_2, true);
+	// Between two re-syncs the software clock may trail the DS3231 by up to half a second.
+	if (fired && (armedTime > now))
+	{
+		now = armedTime;
+	}
+	fired = false;
+	armed = true;
+	RTC_alarm.alarm_disable(2);
+	if (!count)
+	{
+		RTC_alarm.alarm_disable(1);
+		return;
+	}
 
-	// Read the alarm time from the EEPROM for UI use
-	for (int i = 0; i < 7; i++)
+	// The first event after the current minute, or the first of next week.
+	index = weekFind(weekMinute(now) + 1);
+	if (index == count)
 	{
-		DS3231RTC_Alarms::alarm1_time.byte_array[0+i] = eeprom_read_byte((uint8_t *)alarm1_addr+i);
+		index = 0;
 	}
+	entry = weekGet(index);
+	t = previousMidnight(now) - (weekday(now) - 1) * SECS_PER_DAY + entry.minute * 60L;
+	if (t <= now)
+	{
+		t += SECS_PER_WEEK;
+	}
+	RTC_alarm.alarm_program(1, t, ALMweekday);
+	armedTime = t;
 
-	for (int i = 0; i < 7; i++)
+	// Shown by the UI and status, saved only with the next change of the configuration.
+	if (entry.action == SCHopen)
+	{
+		Config.configGet().alarm1 = t;
+	}
+	else
 	{
-		DS3231RTC_Alarms::alarm2_time.byte_array[0+i] = eeprom_read_byte((uint8_t *)alarm2_addr+i);
+		Config.configGet().alarm2 = t;
 	}
 }
 
-void DS3231RTC_Alarms::alarm_Check(uint8_t *stat)
+void Week_Schedule::weekPoll(uint8_t *alarm_stat)
 {
-	if (alarmIsrWasCalled)	// if the interrupt has happened
+	SCH_Entry entry;
+	uint8_t index;
+	uint16_t minute;
+
+	while ((dumpIndex != SCHidle) && (Console.consoleFree() >= LOGlineMax))
+	{
+		if (dumpIndex >= count)
+		{
+			dumpIndex = SCHidle;
+			break;
+		}
+		entry = weekGet(dumpIndex);
+		Console << dumpIndex << ' ' << dayShortStr(entry.minute / 1440 + 1) << ' ';
+		Console.consoleI00((entry.minute / 60) % 24, ':');
+		Console.consoleI00(entry.minute % 60, ' ');
+		Console << ((entry.action == SCHopen) ? F("open") : F("close"));
+		if (entry.hold)
+		{
+			Console << ' ' << (entry.hold * 100U) << F(" ms");
+		}
+		Console << endl;
+		dumpIndex++;
+	}
+
+	if (Config.configGet().mode != SCHweekly)
+	{
+		hold = 0;
+		return;
+	}
+
+	// ALARM_1 carries the event it was armed with, report it as its action. Found again by its
+	// minute rather than remembered, the table may have changed since it was armed. Not by the
+	// minute of the clock, which may still show the one before.
+	hold = 0;
+	if (*alarm_stat == 1)
 	{
-		if (RTC.alarm(ALARM_1))	// check if alarm1 has happened and reset it.
+		minute = armedTime ? weekMinute(armedTime) : weekMinute(Clock.clockNow());
+		index = weekFind(minute);
+		entry = weekGet(index);
+		if ((index < count) && (entry.minute == minute))
 		{
-			*stat = 1;
+			*alarm_stat = entry.action;
+			hold = entry.hold * 100U;
 		}
-		else if (RTC.alarm(ALARM_2))	// or else check if alarm2 has happened and reset it.
+		else
 		{
-			*stat = 2;
+			*alarm_stat = 0;	// Of an event that was deleted.
 		}
-		alarmIsrWasCalled = false;
+		fired = true;
+		armed = false;
 	}
-	else	// else return 0
+
+	// An alarm not yet handled would be cleared by alarm_program.
+	if (!armed && !RTC_alarm.alarm_Pending())
 	{
-		
-		*stat = 0;
+		weekArm();
 	}
 }
 
-time_t DS3231RTC_Alarms::alarm1_get(void)
+void Week_Schedule::weekDump(void)
 {
-	// returns the value from alarm1 read from the EEPROM during setup
-	return alarm1_time.long_time;
+	dumpIndex = 0;
 }
 
-time_t DS3231RTC_Alarms::alarm2_get(void)
+boolean Week_Schedule::weekBusy(void)
 {
-	// returns the value from alarm2 read from the EEPROM during setup
-	return alarm2_time.long_time;
+	return dumpIndex != SCHidle;
 }
 
-void DS3231RTC_Alarms::alarm1_set(tmElements_t TM)
+
+#if PRFenabled
+Task_Profiler::Task_Profiler()
 {
-	// Overwrites the current alarm1 both in the DS3231 clock module and in the EEPROM.
+	// Constructor for the profiler, every probe starts at zero runs.
+}
+
+uint16_t Task_Profiler::prfNow(void)
+{
+	return (uint16_t)micros();
+}
 
+void Task_Profiler::prfAdd(uint8_t probe, uint16_t start)
+{
+	PRF_Stats &st = stats[probe];
+	uint16_t us = (uint16_t)micros() - start;
+	uint16_t span = us / PRFbinFirst;
+	uint8_t bin = 0;
 
-	// Overwrite the alarm1 time in the DS3231 clock module.
-	RTC.setAlarm(ALM1_MATCH_HOURS, TM.Second, TM.Minute, TM.Hour, 1);		//daydate parameter should be between 1 and 7
-	RTC.alarm(ALARM_1);														//ensure RTC interrupt flag is cleared
-	RTC.alarmInterrupt(ALARM_1, true);
+	if (!st.count || (us < st.min))
+	{
+		st.min = us;
+	}
+	if (us > st.max)
+	{
+		st.max = us;
+	}
+	if (st.count < 0xFFFFFFFF)
+	{
+		st.count++;
+	}
 
-	// Overwrite the alarm1 time in the EEPROM.
-	alarm1_time.long_time = makeTime(TM);
-	for (int i = 0; i < 7; i++)
+	// Bin 0 below PRFbinFirst, then one bin per doubling.
+	while (span && (bin < PRFbins - 1))
+	{
+		span >>= 1;
+		bin++;
+	}
+	if (++st.hist[bin] == 0xFF)
 	{
-		eeprom_write_byte((uint8_t *)alarm1_addr+i, alarm1_time.byte_array[0+i]);
+		for (uint8_t i = 0; i < PRFbins; i++)
+		{
+			st.hist[i] >>= 1;
+		}
 	}
+}
 
-	// Writing debug message to serial
-	Serial << "Alarm1 set to " << alarm1_time.long_time << " or "; 
-	Serial << TM.Hour << ":" << TM.Minute << ":" << TM.Second << endl;
+void Task_Profiler::prfGet(uint8_t probe, PRF_Stats &st)
+{
+	noInterrupts();
+	st = stats[probe];
+	interrupts();
 }
 
-void DS3231RTC_Alarms::alarm2_set(tmElements_t TM)
+void Task_Profiler::prfClear(void)
 {
-	// Overwrites the current alarm2 both in the DS3231 clock module and in the EEPROM.
+	noInterrupts();
+	memset(stats, 0, sizeof(stats));
+	interrupts();
+}
+#endif
 
 
-	// Overwrite the alarm2 time in the DS3231 clock module.
-	RTC.setAlarm(ALM2_MATCH_HOURS, TM.Second, TM.Minute, TM.Hour, 1);		//daydate parameter should be between 1 and 7
-	RTC.alarm(ALARM_2);														//ensure RTC interrupt flag is cleared
-	RTC.alarmInterrupt(ALARM_2, true);
+ISR(ADC_vect)	// keypad sample, converted after every Timer0 overflow
+{
+	Keypad.keypadSample(ADC);
+}
 
-	// Overwrite the alarm2 time in the EEPROM.
-	alarm2_time.long_time = makeTime(TM);
-	for (int i = 0; i < 7; i++)
-	{
-		eeprom_write_byte((uint8_t *)alarm2_addr+i, alarm2_time.byte_array[0+i]);
-	}
 
-	// Writing debug message to serial
-	Serial << "Alarm2 set to " << alarm2_time.long_time << " or ";
-	Serial << TM.Hour << ":" << TM.Minute << ":" << TM.Second << endl;
+void alarmIsr()	// INT0 triggered function.
+{
+	Events.eventPost(EVTalarm, 0, 0);
+	RTC.rtcStale();			// The flags of the last burst read are out of date.
+	EIMSK &= ~(1 << INT0);	// The line stays low until alarm_Check clears the DS3231, which also re-enables INT0.
 }
 
 
-liftRelayArray::liftRelayArray()
+// End switches, and the keypad waking the MCU from power-down. The relays are switched off here
+// rather than in loop(), within microseconds of the switch closing; loop() does the bookkeeping.
+ISR(PCINT1_vect)
 {
-	// Constructor for the relay class
+	uint8_t pins = PINC;
+
+	if (((RAdirection == liftCW) && !(pins & (1 << LSopen))) || ((RAdirection == liftCCW) && !(pins & (1 << LSclosed))))
+	{
+		RA_Relays::relayOff();
+		RAstate = RSidle;
+		Timers.timerCancel(TMRrelay);
+		Timers.timerCancel(TMRramp);
+		RAposition = (RAdirection == liftCW) ? POSopen : POSclosed;
+		Events.eventPost(EVTswitch, RAposition,
+			(RAfrom == ((RAposition == POSopen) ? POSclosed : POSopen)) ? relayArray.relayTravel() * 8 / 125 : 0);
+		RAdirection = liftSTOP;
+	}
 }
 
-void liftRelayArray::relayArrayInit(void)
+// Wakes the MCU from power-down, serial input is read once it is awake.
+EMPTY_INTERRUPT(PCINT2_vect);
+
+
+ISR(TWI_vect)	// the next step of the I2C transfer, one per START, byte or STOP
 {
-	// Initialize Buttons
-	DDRD |= (1 << RAControl1) | (1 << RAControl2) | (1 << RAControl3) | (1 << RAControl4);		// Marks pins as output.
-	//PORTD &= ~(1 << RAControl1) & ~(1 << RAControl2) & ~(1 << RAControl3) & ~(1 << RAControl4);	// Puts pins into off state.
-	PORTD |= (1 << RAControl1) | (1 << RAControl2) | (1 << RAControl3) | (1 << RAControl4);
-	/*
-	Use ports:
-	PORTD |= (1 << DDC1);	// Make PD1 = 1 (on)
-	PORTD &= ~(1 << DDC1);	// Puts PD1 = 0 (off).
-	*/
+	PRFbegin(probe);
+	I2C.twiService();
+	PRFend(PRFtwi, probe);
+}
 
-	// setup timer1 to make an interrupt every 1 ms
-	noInterrupts();           // disable all interrupts
-	TCCR1A = 0;
-	TCCR1B = 0;
-	TCNT1  = 0;
+void rtcReadDone(TWI_Request &request)
+{
+	RTC.rtcReadEnded(request.status == TWIdone);
+}
 
-	OCR1A = 16000;            // compare match register 16MHz/1000
-	TCCR1B |= (1 << WGM12);   // CTC mode
-	TCCR1B |= (1 << CS10);    // No prescaler
-	TIMSK1 |= (1 << OCIE1A);  // enable timer compare interrupt
-	interrupts();             // enable all interrupts
+void rtcWriteDone(TWI_Request &request)
+{
+	RTC.rtcWriteEnded(request);
 }
 
-void liftRelayArray::relayArrayCommand(uint8_t cmd)
+void journalReadDone(TWI_Request &request)
 {
-	// Using the lift made easy.
-	switch (cmd)
-	{
-		case liftCW:	// Make the cable retract - Open door
-			/*
-    		PORTD &= ~(1 << RAControl1);  // Turn off all relays
-    		PORTD &= ~(1 << RAControl2);
-    		PORTD &= ~(1 << RAControl3);
-    		PORTD &= ~(1 << RAControl4);
-    		delay(10);
-    		PORTD |= (1 << RAControl1);   // Turn on lift
-    		PORTD |= (1 << RAControl4);
-			*/
-
-			PORTD |= (1 << RAControl1);  // Turn off all relays
-    		PORTD |= (1 << RAControl2);
-    		PORTD |= (1 << RAControl3);
-    		PORTD |= (1 << RAControl4);
-    		_delay_ms(10);
-    		PORTD &= ~(1 << RAControl1);   // Turn on lift
-    		PORTD &= ~(1 << RAControl4);
-		break;
-    
-		case liftCCW:	// Make the cable extend - Close door
-			/*
-    		PORTD &= ~(1 << RAControl1);  // Turn off all relays
-    		PORTD &= ~(1 << RAControl2);
-    		PORTD &= ~(1 << RAControl3);
-    		PORTD &= ~(1 << RAControl4);
-    		delay(10);
-    		PORTD |= (1 << RAControl2);   // Turn on lift
-    		PORTD |= (1 << RAControl3);
-			*/
-
-			PORTD |= (1 << RAControl1);  // Turn off all relays
-    		PORTD |= (1 << RAControl2);
-    		PORTD |= (1 << RAControl3);
-    		PORTD |= (1 << RAControl4);
-    		_delay_ms(10);
-    		PORTD &= ~(1 << RAControl2);   // Turn on lift
-    		PORTD &= ~(1 << RAControl3);
-		break;
-    
-		default:	// default, aka. liftSTOP
-			PORTD |= (1 << RAControl1);  // Turn off all relays
-    		PORTD |= (1 << RAControl2);
-    		PORTD |= (1 << RAControl3);
-    		PORTD |= (1 << RAControl4);
-		break;
-	}
+	Journal.journalReadEnded();
 }
 
-void liftRelayArray::relayAutoCommand(uint8_t alarmtrig)
+void journalWriteDone(TWI_Request &request)
 {
-	switch(alarmtrig)					// switch statement to automatically handle what should happen if alarm has happened.
-	{
-		case 1:							// alarm1:
-			if(!RACounter1Status)
-			{
-				relayArrayCommand(liftCW);
-				RACounter1Status = 1;	// start timer and stop after x seconds (see defines)
-			}
-			break;
-		
-		case 2:							// alarm2:
-			if(!RACounter1Status)
-			{
-				relayArrayCommand(liftCCW);
-				RACounter1Status = 1;	// start timer and stop after x seconds (see defines)
-			}
-			break;
-		
-		default:						// if there was no alarm:
-			if (RACounter1 >= RAHold)
-			{
-				relayArrayCommand(liftSTOP);
-				RACounter1Status = 0;
-				RACounter1 = 0;			// Reset RACounter1.
-			}
-			break;
-	}
+	Journal.journalWriteEnded(request.status == TWIdone);
 }
 
 
 ISR(TIMER1_COMPA_vect)          // timer compare interrupt service routine
 {
-// 	// Debugging
-//  	if (T1Timer >= 1000)
-//  	{
-//  		test++;
-//  		T1Timer = 0;
-//  
-//  		Serial << "Test is: " << test << " and RACounter is: " << RACounter1 << endl;
-//  	}
-//  	else
-//  	{
-//  		T1Timer++;
-//  	}
+	PRFbegin(probe);
+	uint8_t expired = Timers.timerExpired();	// Empty for the steps towards a far deadline.
 
-	// HMI interface timers:
-	if (!btnStat)
+	// RelayArray, stop the lift at its deadline:
+	if ((expired & (1 << TMRrelay)) && (RAstate == RSrunning))
 	{
-		btnStat = HMI.read_LCD_buttons();
+		RA_Relays::relayOff();
+		RAstate = RSidle;
+		RAposition = POSunknown;
+		Events.eventPost(RAtimed ? EVTtimed : EVTdeadline, RAdirection, (Timers.timerNow() - RAstart) * 8 / 125);
+		RAdirection = liftSTOP;
+		Timers.timerCancel(TMRramp);
 	}
 
-	if (UIdelayStat == 1)
+	// RelayArray, the next step of the PWM ramp:
+	if ((expired & (1 << TMRramp)) && (RAstate == RSrunning))
 	{
-		UIdelay++;
+		relayArray.relayRamp();
 	}
-	
-	// RelayArray:
-	if (RACounter1Status == 1)
+
+	// RelayArray, the dead time has passed:
+	if ((expired & (1 << TMRdead)) && (RAstate == RSdead))
+	{
+		relayArray.relayStart();
+	}
+
+	// Software clock:
+	if (expired & (1 << TMRclock))
 	{
-		RACounter1++;
+		CLKpending++;
+		Timers.timerRepeat(TMRclock, TMRsecond);
 	}
+
+	// I2C, the next try of a paused transfer or the timeout of the one on the bus:
+	if (expired & (1 << TMRtwi))
+	{
+		I2C.twiTimer();
+	}
+
+	Timers.timerProgram();
+	PRFend(PRFtimer1, probe);
 }
 
 